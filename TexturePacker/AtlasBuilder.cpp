@@ -0,0 +1,669 @@
+#include "AtlasBuilder.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include "MyPngWriter.h"
+#include "BoundingGenerator.h"
+#include "AtlasMetadataWriter.h"
+#include "BuildCache.h"
+#include "PackCapture.h"
+#include "Platform.h"
+#include "Profiler.h"
+
+bool ClipRowToSprite(const SpriteInfo& sprite, int y, int& from, int& to);
+
+PackJob::PackJob()
+:width(0)
+,height(0)
+,drawDebugLines(false)
+,bandHeight(0)
+,encodeThreads(0)
+,filterStrategy(PNGWRITER_FILTER_ADAPTIVE)
+,compressionLevel(PNGWRITER_DEFAULT_COMPRESSION)
+,outputPath("output.png")
+,logPath("log.txt")
+,cacheMaxBytes(1024.0 * 1024 * 1024)
+,verbose(false)
+{
+}
+
+double PackJob::GetCanvasBytes() const
+{
+	int rows = (bandHeight > 0 && bandHeight < height) ? bandHeight : height;
+	return 4.0 * width * rows;
+}
+
+PackStats::PackStats()
+:spriteCount(0)
+,fittedCount(0)
+,decodeTime(0)
+,packTime(0)
+,writeTime(0)
+,totalTime(0)
+,cacheHit(false)
+,cancelled(false)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+SpriteShapeCache::SpriteShapeCache()
+:mHits(0)
+,mMisses(0)
+{
+}
+
+SpriteInfo SpriteShapeCache::GetShape(const std::string& path)
+{
+	mMutex.Lock();
+
+	std::map<std::string, Entry>::iterator it = mEntries.find(path);
+	if (it != mEntries.end())
+	{
+		// Another job may still be decoding it.
+		while (!it->second.ready)
+		{
+			mEntryReady.Wait(mMutex);
+			it = mEntries.find(path);
+			if (it == mEntries.end())
+			{
+				mMutex.Unlock();
+				return GetShape(path);
+			}
+		}
+
+		SpriteInfo shape = it->second.shape;
+		++mHits;
+		mMutex.Unlock();
+		return shape;
+	}
+
+	mEntries[path].ready = false;
+	++mMisses;
+	mMutex.Unlock();
+
+	BoundingGenerator boundGen;
+	SpriteInfo shape = boundGen.GenerateMoreCompactBounding(path);
+
+	mMutex.Lock();
+	Entry& entry = mEntries[path];
+	entry.shape = shape;
+	entry.ready = true;
+	mEntryReady.Broadcast();
+	mMutex.Unlock();
+
+	return shape;
+}
+
+void SpriteShapeCache::Invalidate(const std::string& path)
+{
+	ScopedLock lock(mMutex);
+
+	std::map<std::string, Entry>::iterator it = mEntries.find(path);
+	if (it != mEntries.end() && it->second.ready)
+	{
+		mEntries.erase(it);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void PrintPackJobOptions()
+{
+	std::cout << "    --out File         Name of the packed texture, output.png by default.\n"
+			  << "    --band-height N    Compose and encode the output N rows at a time instead of\n"
+			  << "                       keeping the whole image in memory.\n"
+			  << "    --encode-threads N Filter and deflate the output on N threads, one per core by\n"
+			  << "                       default. Not used with --band-height.\n"
+			  << "    --filter Strategy  How the output rows are filtered before deflating: adaptive (the\n"
+			  << "                       default, tries every filter on each row), fixed (the Up filter\n"
+			  << "                       on every row, faster) or none (much larger files).\n"
+			  << "    --compression L    zlib level of the output, 0 to 9, 6 by default, or quick for the\n"
+			  << "                       fastest encode with somewhat larger files, for iteration builds.\n"
+			  << "    --data File        Also write the position and polygon of every sprite to File,\n"
+			  << "                       as JSON (.json), cocos2d plist (.plist) or binary (.bin).\n"
+			  << "                       With .sprites, record the shapes given to the packer instead,\n"
+			  << "                       for the packing corpus tool.\n"
+			  << "    --capture File     Record the sprite sizes and polygons handed to the packer, without\n"
+			  << "                       names or pixels, to run the packing again with --replay.\n"
+			  << "                       The build cache is not used while capturing.\n"
+			  << "    --cache Dir        Reuse the outputs of an earlier build from the same list file,\n"
+			  << "                       sprites and options, kept in Dir. Dir can be shared.\n"
+			  << "    --cache-size MB    Size the cache is trimmed to, least recently used first.\n"
+			  << "                       1024 MB by default.\n";
+}
+
+bool ParsePackJob(const std::vector<std::string>& args, PackJob& job, std::string& error)
+{
+	std::vector<std::string> positional;
+
+	for (int i = 0; i < args.size(); ++i)
+	{
+		const std::string& arg = args[i];
+		bool hasValue = i + 1 < args.size();
+
+		if (arg == "--band-height" && hasValue)
+		{
+			job.bandHeight = atoi(args[++i].c_str());
+		}
+		else if (arg == "--encode-threads" && hasValue)
+		{
+			job.encodeThreads = atoi(args[++i].c_str());
+		}
+		else if (arg == "--filter" && hasValue)
+		{
+			const std::string& strategy = args[++i];
+			if (strategy == "none")
+				job.filterStrategy = PNGWRITER_FILTER_NONE;
+			else if (strategy == "fixed")
+				job.filterStrategy = PNGWRITER_FILTER_FIXED;
+			else if (strategy == "adaptive")
+				job.filterStrategy = PNGWRITER_FILTER_ADAPTIVE;
+			else
+			{
+				error = "unknown filter strategy " + strategy;
+				return false;
+			}
+		}
+		else if (arg == "--compression" && hasValue)
+		{
+			const std::string& level = args[++i];
+			if (level == "quick")
+				job.compressionLevel = PNGWRITER_COMPRESSION_QUICK;
+			else if (level.size() == 1 && level[0] >= '0' && level[0] <= '9')
+				job.compressionLevel = level[0] - '0';
+			else
+			{
+				error = "unknown compression level " + level;
+				return false;
+			}
+		}
+		else if (arg == "--data" && hasValue)
+		{
+			job.dataPath = args[++i];
+		}
+		else if (arg == "--out" && hasValue)
+		{
+			job.outputPath = args[++i];
+		}
+		else if (arg == "--capture" && hasValue)
+		{
+			job.capturePath = args[++i];
+		}
+		else if (arg == "--cache" && hasValue)
+		{
+			job.cacheDir = args[++i];
+		}
+		else if (arg == "--cache-size" && hasValue)
+		{
+			job.cacheMaxBytes = atof(args[++i].c_str()) * 1024 * 1024;
+		}
+		else if (arg.compare(0, 2, "--") == 0)
+		{
+			error = "unknown option " + arg;
+			return false;
+		}
+		else
+		{
+			positional.push_back(arg);
+		}
+	}
+
+	if (positional.size() != 3 && positional.size() != 4)
+	{
+		error = "expected ListFile OutFileWidth OutFileHeight {DrawDebugLines}";
+		return false;
+	}
+
+	job.listFile = positional[0];
+	job.width = atoi(positional[1].c_str());
+	job.height = atoi(positional[2].c_str());
+	job.drawDebugLines = positional.size() == 4;
+
+	if (job.width < 128) job.width = 128;
+	if (job.width > MAX_TEXTURE_SIZE) job.width = MAX_TEXTURE_SIZE;
+	if (job.height < 128) job.height = 128;
+	if (job.height > MAX_TEXTURE_SIZE) job.height = MAX_TEXTURE_SIZE;
+
+	return true;
+}
+
+bool ReadListFile(const std::string& listFilePath, std::vector<std::string>& fileList)
+{
+	std::ifstream inFile(listFilePath.c_str());
+	if (!inFile.is_open())
+	{
+		return false;
+	}
+
+	while (!inFile.eof())
+	{
+		std::string line;
+		inFile >> line;
+
+		if (line.length() == 0) continue;
+		if (inFile.eof()) break;
+
+		if (line.length() > 4)
+		{
+			std::string suffix = line.substr(line.length() - 4);
+			if (suffix[0] == '.'
+				&& tolower(suffix[1]) == 'p'
+				&& tolower(suffix[2]) == 'n' 
+				&& tolower(suffix[3]) == 'g')
+			{
+				fileList.push_back(line);
+			}
+		}
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void DrawSprite(MyPngWriter& outputFile, MyPngWriter& inPngFile, const SpriteInfo& info, int fromY, int toY, bool drawDebugLines)
+{
+	PROFILE_SCOPE("DrawSprite");
+
+	int w = inPngFile.getwidth();
+	int h = inPngFile.getheight();
+
+	fromY = std::max(fromY, info.y);
+	toY = std::min(toY, info.y + h);
+
+	for (int y = fromY - info.y; y < toY - info.y; ++y)
+	{
+		const rgba8* row = (const rgba8*)inPngFile.row(y);
+		int from = 0, to = w - 1;
+		if (row != NULL && ClipRowToSprite(info, y, from, to))
+		{
+			outputFile.blit(info.x + from, info.y + y, row + from, to - from + 1);
+		}
+	}
+
+	if (drawDebugLines)
+	{
+		// Draw the debugging lines, the output file drops the pixels outside its current band.
+		if (info.vertex.size() > 4)
+		{
+			int n = info.vertex.size();
+			for (int j = 0; j < n; ++j)
+			{
+				CPoint pt0 = info.vertex[j];
+				CPoint pt1 = info.vertex[(j+1)%n];
+				outputFile.line(info.x + pt0.x, info.y + pt0.y, info.x + pt1.x, info.y + pt1.y, 255, 0, 0, 255);
+			}
+		}
+	}
+}
+
+void EraseSprite(MyPngWriter& outputFile, const SpriteInfo& info)
+{
+	const rgba8 transparent = {0, 0, 0, 0};
+
+	for (int y = 0; y < info.h; ++y)
+	{
+		int from = 0, to = info.w - 1;
+		if (ClipRowToSprite(info, y, from, to))
+		{
+			outputFile.fill(info.x + from, info.y + y, to - from + 1, transparent);
+		}
+	}
+}
+
+inline const std::string& SpriteFileName(const std::string& path) { return path; }
+inline const std::string& SpriteFileName(const SpriteInfo& info) { return *(std::string*)info.userData; }
+inline const std::string& SpriteFileName(const SpriteInfo* info) { return *(std::string*)info->userData; }
+
+// Has the files of the sprites after sprite i read ahead, so they are off the disk by the time their turn comes.
+// The first call asks for the whole window, the next ones only for the file coming into it.
+template <class T>
+void PrefetchSprites(const std::vector<T>& sprites, int i)
+{
+	int first = i == 0 ? 0 : i + SPRITE_PREFETCH_DISTANCE;
+	for (int j = first; j <= i + SPRITE_PREFETCH_DISTANCE && j < sprites.size(); ++j)
+	{
+		PrefetchFile(SpriteFileName(sprites[j]));
+	}
+}
+
+void LogNotPacked(std::ostream& logFile, const SpriteInfo& info)
+{
+	logFile << "File " << *(std::string*)(info.userData) << "with size(" << info.srcW << ", " << info.srcH << ") not packed!\n";
+}
+
+// Returns false if control was cancelled before the packed texture was complete.
+bool WriteOutPackedPng(const PackJob& job, const std::vector<SpriteInfo>& spriteInfos, std::ostream& logFile, const BuildControl& control)
+{
+	PROFILE_SCOPE("WriteOutPackedPng");
+
+	int height = job.height;
+	bool drawDebugLines = job.drawDebugLines;
+	MyPngWriter outputFile(job.width, job.height, job.outputPath.c_str(), CANVAS_TILE_SIZE);
+	outputFile.setreleaseonclose(true);
+	outputFile.setcontrol(&control);
+	outputFile.setencodethreads(job.encodeThreads);
+	outputFile.setfilterstrategy(job.filterStrategy);
+	outputFile.setcompressionlevel(job.compressionLevel);
+
+	// Every sprite is read into the same image, which keeps the memory of the largest one so far.
+	MyPngWriter inPngFile(1, 1, 0, "");
+
+	for (int i = 0; i < spriteInfos.size(); ++i)
+	{
+		if (control.IsCancelled())
+		{
+			return false;
+		}
+		control.Report(STAGE_COMPOSE, i, spriteInfos.size());
+		PrefetchSprites(spriteInfos, i);
+
+		const SpriteInfo& info = spriteInfos[i];
+
+		std::string filename = *(std::string*)(info.userData);
+
+		if (info.fitted)
+		{
+			inPngFile.readfromfile(filename.c_str());
+
+			DrawSprite(outputFile, inPngFile, info, 0, height, drawDebugLines);
+		}
+		else
+		{
+			LogNotPacked(logFile, info);
+		}
+	}
+	control.Report(STAGE_COMPOSE, spriteInfos.size(), spriteInfos.size());
+
+	outputFile.close();
+	return !control.IsCancelled();
+}
+
+struct CompareTop {
+	bool operator()(const SpriteInfo* a, const SpriteInfo* b) const
+	{
+		return a->y < b->y;
+	}
+};
+
+// A sprite that overlaps the band being composed, together with its decoded image.
+struct BandSprite
+{
+	const SpriteInfo* info;
+	MyPngWriter* image;
+};
+
+// Same output as WriteOutPackedPng(), but the packed texture is composed and encoded bandHeight rows at a time.
+// A sprite is decoded when the first band it touches comes up and released once its last row is written,
+// so only one band and the sprites crossing it are held in memory.
+bool WriteOutPackedPngInBands(const PackJob& job, const std::vector<SpriteInfo>& spriteInfos, std::ostream& logFile, const BuildControl& control)
+{
+	PROFILE_SCOPE("WriteOutPackedPngInBands");
+
+	int height = job.height;
+	int bandHeight = job.bandHeight;
+	bool drawDebugLines = job.drawDebugLines;
+	MyPngWriter outputFile(job.width, job.height, 0, job.outputPath.c_str(), bandHeight);
+	outputFile.setcontrol(&control);
+	outputFile.setfilterstrategy(job.filterStrategy);
+	outputFile.setcompressionlevel(job.compressionLevel);
+
+	std::vector<const SpriteInfo*> order;
+	for (int i = 0; i < spriteInfos.size(); ++i)
+	{
+		const SpriteInfo& info = spriteInfos[i];
+		if (info.fitted)
+		{
+			order.push_back(&info);
+		}
+		else
+		{
+			LogNotPacked(logFile, info);
+		}
+	}
+	std::sort(order.begin(), order.end(), CompareTop());
+
+	std::vector<BandSprite> active;
+	int next = 0;
+
+	for (int top = 0; top < height && !control.IsCancelled(); top += bandHeight)
+	{
+		int bottom = top + bandHeight;
+
+		// Fetch the sprites starting above the bottom of this band.
+		while (next < order.size() && order[next]->y < bottom)
+		{
+			PrefetchSprites(order, next);
+
+			BandSprite sprite;
+			sprite.info = order[next];
+			sprite.image = new MyPngWriter(1, 1, 0, "");
+			sprite.image->readfromfile(((std::string*)sprite.info->userData)->c_str());
+			active.push_back(sprite);
+			++next;
+		}
+
+		for (int i = 0; i < active.size(); ++i)
+		{
+			DrawSprite(outputFile, *active[i].image, *active[i].info, top, bottom, drawDebugLines);
+		}
+
+		outputFile.flushband();
+
+		// Release the sprites that end in this band.
+		int kept = 0;
+		for (int i = 0; i < active.size(); ++i)
+		{
+			const SpriteInfo& info = *active[i].info;
+			if (info.y + std::max(info.h, active[i].image->getheight()) <= bottom)
+			{
+				delete active[i].image;
+			}
+			else
+			{
+				active[kept++] = active[i];
+			}
+		}
+		active.resize(kept);
+	}
+
+	for (int i = 0; i < active.size(); ++i)
+	{
+		delete active[i].image;
+	}
+
+	// close() leaves the file unfinished once cancelled.
+	outputFile.close();
+	return !control.IsCancelled();
+}
+
+bool WriteOutMetadata(const std::string& path, const std::string& textureName, int width, int height, const std::vector<SpriteInfo>& spriteInfos)
+{
+	AtlasMetadataWriter* writer = AtlasMetadataWriter::CreateForPath(path);
+	if (writer == NULL)
+	{
+		std::cerr << "Unknown data file format " << path << ", use .json, .plist, .bin or .sprites\n";
+		return false;
+	}
+
+	std::ofstream out;
+	bool ok = OpenReplacing(path, out) && writer->Write(out, textureName, width, height, spriteInfos);
+	delete writer;
+
+	if (!ok)
+	{
+		std::cerr << "Failed to write " << path << "\n";
+	}
+	return ok;
+}
+
+bool WritePackCaptureFile(const std::string& path, int width, int height, const std::vector<SpriteInfo>& spriteInfos)
+{
+	std::ofstream out(path.c_str(), std::ios::out | std::ios::binary);
+	if (!out.is_open() || !WritePackCapture(out, width, height, ORDER_BY_HEIGHT, spriteInfos))
+	{
+		std::cerr << "Failed to write " << path << "\n";
+		return false;
+	}
+	return true;
+}
+
+bool LoadSprites(const std::vector<std::string>& fileList, SpriteShapeCache* shapes, std::vector<SpriteInfo>& spriteInfos,
+	const BuildControl& control)
+{
+	PROFILE_SCOPE("LoadSprites");
+
+	for (int i = 0; i < fileList.size(); ++i)
+	{
+		if (control.IsCancelled())
+		{
+			return false;
+		}
+
+		PrefetchSprites(fileList, i);
+
+		SpriteInfo info;
+		if (shapes != NULL)
+		{
+			info = shapes->GetShape(fileList[i]);
+		}
+		else
+		{
+			BoundingGenerator boundGen;
+			info = boundGen.GenerateMoreCompactBounding(fileList[i]);
+		}
+
+		info.fitted = false;
+		info.userData = (void*)&fileList[i];
+
+		info.x = info.y = -1;
+
+		spriteInfos.push_back(info);
+		control.Report(STAGE_DECODE, i + 1, fileList.size());
+	}
+
+	return true;
+}
+
+bool BuildAtlas(const PackJob& job, SpriteShapeCache* shapes, PackStats* stats, const BuildControl& control)
+{
+	PROFILE_SCOPE("BuildAtlas");
+
+	PackStats localStats;
+	if (stats == NULL)
+	{
+		stats = &localStats;
+	}
+
+	double startTime = GetTimeInSeconds();
+
+	std::vector<std::string> fileList;
+	if (!ReadListFile(job.listFile, fileList))
+	{
+		std::cerr << "Cannot open list file " << job.listFile << "\n";
+		return false;
+	}
+
+	// A cache hit would not pack, so there would be nothing to capture.
+	std::string cacheKey;
+	if (!job.cacheDir.empty() && job.capturePath.empty() && BuildCache::ComputeKey(job, fileList, cacheKey))
+	{
+		BuildCache cache(job.cacheDir, job.cacheMaxBytes);
+		if (cache.Fetch(cacheKey, job))
+		{
+			stats->cacheHit = true;
+			stats->spriteCount = stats->fittedCount = fileList.size();
+
+			// Every line of the log is a sprite that was not packed.
+			std::ifstream logFile(job.logPath.c_str());
+			std::string line;
+			while (std::getline(logFile, line))
+			{
+				--stats->fittedCount;
+			}
+
+			stats->totalTime = GetTimeInSeconds() - startTime;
+			if (job.verbose)
+			{
+				printf("Same inputs as a build in the cache, %s is up to date.\n", job.outputPath.c_str());
+			}
+			return true;
+		}
+	}
+
+	// Jobs of a batch still waiting for a thread when it is cancelled stop here.
+	std::vector<SpriteInfo> spriteInfos;
+	if (control.IsCancelled() || !LoadSprites(fileList, shapes, spriteInfos, control))
+	{
+		stats->cancelled = true;
+		return false;
+	}
+
+	double packStartTime = GetTimeInSeconds();
+	stats->decodeTime = packStartTime - startTime;
+
+	if (job.verbose)
+	{
+		printf("Generate compact bounding done, start packing...\n");
+	}
+
+	if (!job.capturePath.empty() && !WritePackCaptureFile(job.capturePath, job.width, job.height, spriteInfos))
+	{
+		return false;
+	}
+
+	TexturePacker packer(job.width, job.height);
+	if (!packer.Pack(spriteInfos, control))
+	{
+		stats->cancelled = true;
+		return false;
+	}
+
+	double writeStartTime = GetTimeInSeconds();
+	stats->packTime = writeStartTime - packStartTime;
+
+	if (job.verbose)
+	{
+		printf("Pack done, writing out the packed file, it could take a while ...\n");
+	}
+
+	std::ofstream logFile(job.logPath.c_str());
+	bool written = job.bandHeight > 0
+		? WriteOutPackedPngInBands(job, spriteInfos, logFile, control)
+		: WriteOutPackedPng(job, spriteInfos, logFile, control);
+	if (!written)
+	{
+		RemoveFile(job.outputPath);
+		stats->cancelled = true;
+		return false;
+	}
+
+	bool ok = true;
+	if (!job.dataPath.empty())
+	{
+		ok = WriteOutMetadata(job.dataPath, job.outputPath, job.width, job.height, spriteInfos);
+	}
+	logFile.close();
+
+	if (ok && !cacheKey.empty())
+	{
+		BuildCache cache(job.cacheDir, job.cacheMaxBytes);
+		cache.Store(cacheKey, job);
+	}
+
+	double endTime = GetTimeInSeconds();
+	stats->writeTime = endTime - writeStartTime;
+	stats->totalTime = endTime - startTime;
+	stats->spriteCount = spriteInfos.size();
+	stats->fittedCount = 0;
+	for (int i = 0; i < spriteInfos.size(); ++i)
+	{
+		if (spriteInfos[i].fitted)
+		{
+			++stats->fittedCount;
+		}
+	}
+
+	return ok;
+}
@@ -0,0 +1,128 @@
+#ifndef _ATLASBUILDER_H_
+#define _ATLASBUILDER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iosfwd>
+#include "TexturePacker.h"
+#include "Threading.h"
+#include "Progress.h"
+
+class MyPngWriter;
+
+// Part of the build cache keys, change it whenever the same inputs give a different output.
+#define TEXTURE_PACKER_VERSION "1.2"
+
+#define MAX_TEXTURE_SIZE 16384
+
+// Side of the tiles the packed texture is composed in, only the tiles sprites cover take memory.
+#define CANVAS_TILE_SIZE 256
+
+// How many sprite files ahead of the one being decoded are read into memory in the background.
+#define SPRITE_PREFETCH_DISTANCE 8
+
+// Everything needed to build one packed texture, as given on the command line or in a job file.
+struct PackJob
+{
+    std::string listFile;
+    int width, height;
+    bool drawDebugLines;
+    int bandHeight;                     // Rows composed at a time, 0 keeps the whole output in memory.
+    int encodeThreads;                  // Threads the output is encoded on when it is kept whole, 0 for one per core.
+    int filterStrategy;                 // How the output rows are filtered, a PNGWRITER_FILTER_ value.
+    int compressionLevel;               // zlib level 0 to 9, or PNGWRITER_COMPRESSION_QUICK.
+    std::string outputPath;
+    std::string dataPath;               // Metadata file, empty for none.
+    std::string logPath;                // Where the sprites that could not be packed are reported.
+    std::string capturePath;            // Where to record what is handed to the packer, empty for none.
+    std::string cacheDir;               // Build cache directory, empty for none.
+    double cacheMaxBytes;               // Size the build cache is trimmed to, 0 for no limit.
+    bool verbose;                       // Print the stages as they go.
+
+    PackJob();
+
+    // Most bytes the output image can hold in memory while it is being composed.
+    double GetCanvasBytes() const;
+};
+
+// How long each stage of BuildAtlas() took, in seconds.
+struct PackStats
+{
+    int spriteCount;
+    int fittedCount;
+    double decodeTime;                  // Decoding the sprites and generating their bounding polygons.
+    double packTime;
+    double writeTime;                   // Composing and encoding the output, and the metadata.
+    double totalTime;
+    bool cacheHit;                      // The outputs came from the build cache, nothing was decoded or packed.
+    bool cancelled;                     // The build stopped early because it was cancelled.
+
+    PackStats();
+};
+
+// Bounding polygons of the sprites already decoded, shared by all the jobs of a batch so that the shape
+// of a sprite used by several packed textures is generated only once. Only the shapes are kept, each job
+// still decodes the pixels of the sprites it draws. Safe to use from several threads, and the shape of a
+// sprite requested by two threads at the same time is still generated once.
+class SpriteShapeCache
+{
+public:
+
+    SpriteShapeCache();
+
+    // The bounding polygon and source size of the sprite, x/y/fitted/userData are left for the caller.
+    SpriteInfo GetShape(const std::string& path);
+
+    // Forgets a sprite, the next GetShape() decodes it again.
+    void Invalidate(const std::string& path);
+
+    int GetHitCount() const { return mHits; }
+    int GetMissCount() const { return mMisses; }
+
+private:
+
+    struct Entry
+    {
+        bool ready;
+        SpriteInfo shape;
+    };
+
+    Mutex mMutex;
+    Condition mEntryReady;
+    std::map<std::string, Entry> mEntries;
+    int mHits, mMisses;
+};
+
+// Reads the command line form of a job: ListFile Width Height {DrawDebugLines} {Options}.
+// Returns false and leaves a message in error if the arguments are not valid.
+bool ParsePackJob(const std::vector<std::string>& args, PackJob& job, std::string& error);
+
+// Collects the .png paths of a list file. Returns false if the file cannot be opened.
+bool ReadListFile(const std::string& listFilePath, std::vector<std::string>& fileList);
+
+// Generates the bounding polygon of every sprite in fileList, ready to be packed, reporting each one to control.
+// The userData of each sprite points to its path in fileList. shapes may be NULL.
+// Returns false if control was cancelled, spriteInfos then only holds the sprites loaded so far.
+bool LoadSprites(const std::vector<std::string>& fileList, SpriteShapeCache* shapes, std::vector<SpriteInfo>& spriteInfos,
+    const BuildControl& control = BuildControl());
+
+// Decodes, packs and writes out one packed texture, reporting the progress of every stage to control.
+// shapes may be NULL. A cancelled build returns false, with stats->cancelled set, and removes
+// the partly written packed texture.
+bool BuildAtlas(const PackJob& job, SpriteShapeCache* shapes, PackStats* stats, const BuildControl& control = BuildControl());
+
+// Copies rows [fromY, toY) (in packed texture coordinates) of a sprite into the output file.
+void DrawSprite(MyPngWriter& outputFile, MyPngWriter& inPngFile, const SpriteInfo& info, int fromY, int toY, bool drawDebugLines);
+
+// Sets the pixels covered by a packed sprite back to transparent black.
+void EraseSprite(MyPngWriter& outputFile, const SpriteInfo& info);
+
+// Logs a sprite that did not fit, with the size of its source image kept in info.
+void LogNotPacked(std::ostream& logFile, const SpriteInfo& info);
+
+bool WriteOutMetadata(const std::string& path, const std::string& textureName, int width, int height, const std::vector<SpriteInfo>& spriteInfos);
+
+void PrintPackJobOptions();
+
+#endif
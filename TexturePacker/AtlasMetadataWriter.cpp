@@ -0,0 +1,370 @@
+#include "AtlasMetadataWriter.h"
+#include <ostream>
+#include <istream>
+#include <cctype>
+#include "ByteOrder.h"
+
+inline const std::string& SpriteName(const SpriteInfo& sprite)
+{
+    return *(std::string*)(sprite.userData);
+}
+
+inline std::string Extension(const std::string& path)
+{
+    std::string::size_type dot = path.rfind('.');
+    if (dot == std::string::npos)
+        return "";
+
+    std::string ext = path.substr(dot + 1);
+    for (int i = 0; i < ext.size(); ++i)
+        ext[i] = tolower(ext[i]);
+    return ext;
+}
+
+AtlasMetadataWriter* AtlasMetadataWriter::CreateForPath(const std::string& path)
+{
+    std::string ext = Extension(path);
+
+    if (ext == "json")
+        return new JsonAtlasWriter();
+    if (ext == "plist")
+        return new PlistAtlasWriter();
+    if (ext == "bin")
+        return new BinaryAtlasWriter();
+    if (ext == "sprites")
+        return new SpriteDescriptorWriter();
+    return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JSON
+
+void WriteJsonString(std::ostream& out, const std::string& str)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    out << '"';
+    for (int i = 0; i < str.size(); ++i)
+    {
+        unsigned char c = str[i];
+        switch (c)
+        {
+        case '"':  out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (c < 0x20)
+                out << "\\u00" << hex[c >> 4] << hex[c & 15];
+            else
+                out << c;
+        }
+    }
+    out << '"';
+}
+
+bool JsonAtlasWriter::Write(std::ostream& out, const std::string& textureName, int width, int height,
+    const std::vector<SpriteInfo>& sprites)
+{
+    bool first = true;
+
+    out << "{\n\t\"frames\": {";
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInfo& sprite = sprites[i];
+        if (!sprite.fitted)
+            continue;
+
+        out << (first ? "\n\t\t" : ",\n\t\t");
+        first = false;
+
+        WriteJsonString(out, SpriteName(sprite));
+        out << ": {\n"
+            << "\t\t\t\"frame\": {\"x\": " << sprite.x << ", \"y\": " << sprite.y
+            << ", \"w\": " << sprite.srcW << ", \"h\": " << sprite.srcH << "},\n"
+            << "\t\t\t\"rotated\": false,\n"
+            << "\t\t\t\"trimmed\": false,\n"
+            << "\t\t\t\"spriteSourceSize\": {\"x\": 0, \"y\": 0, \"w\": " << sprite.srcW << ", \"h\": " << sprite.srcH << "},\n"
+            << "\t\t\t\"sourceSize\": {\"w\": " << sprite.srcW << ", \"h\": " << sprite.srcH << "},\n"
+            << "\t\t\t\"vertices\": [";
+        for (int j = 0; j < sprite.vertex.size(); ++j)
+        {
+            out << (j ? ", [" : "[") << sprite.vertex[j].x << ", " << sprite.vertex[j].y << "]";
+        }
+        out << "]\n\t\t}";
+    }
+
+    out << "\n\t},\n\t\"meta\": {\n\t\t\"image\": ";
+    WriteJsonString(out, textureName);
+    out << ",\n\t\t\"format\": \"RGBA8888\",\n"
+        << "\t\t\"size\": {\"w\": " << width << ", \"h\": " << height << "}\n\t}\n}\n";
+
+    return out.good();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Property list
+
+void WriteXmlString(std::ostream& out, const std::string& str)
+{
+    for (int i = 0; i < str.size(); ++i)
+    {
+        switch (str[i])
+        {
+        case '&': out << "&amp;"; break;
+        case '<': out << "&lt;"; break;
+        case '>': out << "&gt;"; break;
+        default:  out << str[i];
+        }
+    }
+}
+
+bool PlistAtlasWriter::Write(std::ostream& out, const std::string& textureName, int width, int height,
+    const std::vector<SpriteInfo>& sprites)
+{
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<!DOCTYPE plist PUBLIC \"-//Apple Computer//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+        << "<plist version=\"1.0\">\n"
+        << "\t<dict>\n"
+        << "\t\t<key>frames</key>\n"
+        << "\t\t<dict>\n";
+
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInfo& sprite = sprites[i];
+        if (!sprite.fitted)
+            continue;
+
+        int n = sprite.vertex.size();
+
+        out << "\t\t\t<key>";
+        WriteXmlString(out, SpriteName(sprite));
+        out << "</key>\n"
+            << "\t\t\t<dict>\n"
+            << "\t\t\t\t<key>aliases</key>\n"
+            << "\t\t\t\t<array/>\n"
+            << "\t\t\t\t<key>spriteOffset</key>\n"
+            << "\t\t\t\t<string>{0,0}</string>\n"
+            << "\t\t\t\t<key>spriteSize</key>\n"
+            << "\t\t\t\t<string>{" << sprite.srcW << "," << sprite.srcH << "}</string>\n"
+            << "\t\t\t\t<key>spriteSourceSize</key>\n"
+            << "\t\t\t\t<string>{" << sprite.srcW << "," << sprite.srcH << "}</string>\n"
+            << "\t\t\t\t<key>textureRect</key>\n"
+            << "\t\t\t\t<string>{{" << sprite.x << "," << sprite.y << "},{" << sprite.srcW << "," << sprite.srcH << "}}</string>\n"
+            << "\t\t\t\t<key>textureRotated</key>\n"
+            << "\t\t\t\t<false/>\n";
+
+        // The bounding polygon is convex, so a fan from the first vertex covers it.
+        out << "\t\t\t\t<key>triangles</key>\n\t\t\t\t<string>";
+        for (int j = 1; j + 1 < n; ++j)
+        {
+            out << (j > 1 ? " " : "") << 0 << " " << j << " " << j + 1;
+        }
+        out << "</string>\n\t\t\t\t<key>vertices</key>\n\t\t\t\t<string>";
+        for (int j = 0; j < n; ++j)
+        {
+            out << (j ? " " : "") << sprite.vertex[j].x << " " << sprite.vertex[j].y;
+        }
+        out << "</string>\n\t\t\t\t<key>verticesUV</key>\n\t\t\t\t<string>";
+        for (int j = 0; j < n; ++j)
+        {
+            out << (j ? " " : "") << sprite.vertex[j].x + sprite.x << " " << sprite.vertex[j].y + sprite.y;
+        }
+        out << "</string>\n\t\t\t</dict>\n";
+    }
+
+    out << "\t\t</dict>\n"
+        << "\t\t<key>metadata</key>\n"
+        << "\t\t<dict>\n"
+        << "\t\t\t<key>format</key>\n"
+        << "\t\t\t<integer>3</integer>\n"
+        << "\t\t\t<key>pixelFormat</key>\n"
+        << "\t\t\t<string>RGBA8888</string>\n"
+        << "\t\t\t<key>premultiplyAlpha</key>\n"
+        << "\t\t\t<false/>\n"
+        << "\t\t\t<key>realTextureFileName</key>\n"
+        << "\t\t\t<string>";
+    WriteXmlString(out, textureName);
+    out << "</string>\n"
+        << "\t\t\t<key>size</key>\n"
+        << "\t\t\t<string>{" << width << "," << height << "}</string>\n"
+        << "\t\t\t<key>textureFileName</key>\n"
+        << "\t\t\t<string>";
+    WriteXmlString(out, textureName);
+    out << "</string>\n"
+        << "\t\t</dict>\n"
+        << "\t</dict>\n"
+        << "</plist>\n";
+
+    return out.good();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Binary
+
+inline unsigned int Align4(unsigned int size)
+{
+    return (size + 3) & ~3u;
+}
+
+// The records come first and point forward into the vertex and string sections, so the sprites are
+// walked three times: the offsets are summed up while writing the records, then the vertices and the
+// names are written in the same order. Nothing but the running offsets is kept in memory.
+bool BinaryAtlasWriter::Write(std::ostream& out, const std::string& textureName, int width, int height,
+    const std::vector<SpriteInfo>& sprites)
+{
+    unsigned int spriteCount = 0, vertexCount = 0;
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        if (sprites[i].fitted)
+        {
+            ++spriteCount;
+            vertexCount += sprites[i].vertex.size();
+        }
+    }
+
+    unsigned int spriteOffset = sizeof(AtlasFileHeader);
+    unsigned int vertexOffset = spriteOffset + spriteCount * sizeof(AtlasSpriteRecord);
+    unsigned int stringOffset = vertexOffset + vertexCount * 2 * 4;
+
+    WriteU32(out, ATLAS_FILE_MAGIC);
+    WriteU32(out, ATLAS_FILE_VERSION);
+    WriteU32(out, width);
+    WriteU32(out, height);
+    WriteU32(out, spriteCount);
+    WriteU32(out, spriteOffset);
+    WriteU32(out, stringOffset);
+    WriteU32(out, 0);
+
+    unsigned int nameOffset = stringOffset + Align4(textureName.size() + 1);
+
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInfo& sprite = sprites[i];
+        if (!sprite.fitted)
+            continue;
+
+        WriteU32(out, sprite.x);
+        WriteU32(out, sprite.y);
+        WriteU32(out, sprite.srcW);
+        WriteU32(out, sprite.srcH);
+        WriteU32(out, 0);
+        WriteU32(out, 0);
+        WriteU32(out, sprite.srcW);
+        WriteU32(out, sprite.srcH);
+        WriteU32(out, 0);
+        WriteU32(out, sprite.vertex.size());
+        WriteU32(out, vertexOffset);
+        WriteU32(out, nameOffset);
+
+        vertexOffset += sprite.vertex.size() * 2 * 4;
+        nameOffset += Align4(SpriteName(sprite).size() + 1);
+    }
+
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInfo& sprite = sprites[i];
+        if (!sprite.fitted)
+            continue;
+
+        for (int j = 0; j < sprite.vertex.size(); ++j)
+        {
+            WriteU32(out, sprite.vertex[j].x);
+            WriteU32(out, sprite.vertex[j].y);
+        }
+    }
+
+    static const char padding[4] = {0, 0, 0, 0};
+
+    out.write(textureName.c_str(), textureName.size());
+    out.write(padding, Align4(textureName.size() + 1) - textureName.size());
+
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInfo& sprite = sprites[i];
+        if (!sprite.fitted)
+            continue;
+
+        const std::string& name = SpriteName(sprite);
+        out.write(name.c_str(), name.size());
+        out.write(padding, Align4(name.size() + 1) - name.size());
+    }
+
+    return out.good();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Sprite descriptors
+
+const int SPRITE_DESCRIPTOR_VERSION = 1;
+
+// The texture name is left out, the packer is not given one.
+bool SpriteDescriptorWriter::Write(std::ostream& out, const std::string& /*textureName*/, int width, int height,
+    const std::vector<SpriteInfo>& sprites)
+{
+    out << "sprites " << SPRITE_DESCRIPTOR_VERSION << "\n"
+        << "texture " << width << " " << height << "\n";
+
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInfo& sprite = sprites[i];
+
+        out << SpriteName(sprite) << " " << sprite.srcW << " " << sprite.srcH << " "
+            << sprite.shapeMask << " " << sprite.vertex.size();
+
+        for (int j = 0; j < sprite.vertex.size(); ++j)
+            out << " " << sprite.vertex[j].x << " " << sprite.vertex[j].y;
+
+        out << "\n";
+    }
+
+    return out.good();
+}
+
+bool ReadSpriteDescriptors(std::istream& in, int& width, int& height,
+    std::vector<SpriteInfo>& sprites, std::vector<std::string>& names)
+{
+    std::string tag;
+    int version;
+    if (!(in >> tag >> version) || tag != "sprites" || version != SPRITE_DESCRIPTOR_VERSION)
+        return false;
+    if (!(in >> tag >> width >> height) || tag != "texture")
+        return false;
+
+    std::vector<SpriteInfo> read;
+    std::vector<std::string> readNames;
+    std::string name;
+
+    while (in >> name)
+    {
+        SpriteInfo sprite;
+        int vertexCount;
+        if (!(in >> sprite.srcW >> sprite.srcH >> sprite.shapeMask >> vertexCount) || vertexCount < 0)
+            return false;
+
+        for (int j = 0; j < vertexCount; ++j)
+        {
+            CPoint pt;
+            if (!(in >> pt.x >> pt.y))
+                return false;
+            sprite.vertex.push_back(pt);
+        }
+
+        sprite.x = sprite.y = -1;
+        sprite.w = sprite.h = 0;
+        sprite.fitted = false;
+        sprite.userData = NULL;
+
+        read.push_back(sprite);
+        readNames.push_back(name);
+    }
+
+    // The names do not move any more, the sprites can point to them.
+    names.swap(readNames);
+    sprites.swap(read);
+    for (int i = 0; i < sprites.size(); ++i)
+        sprites[i].userData = (void*)&names[i];
+
+    return true;
+}
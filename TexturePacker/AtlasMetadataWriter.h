@@ -0,0 +1,106 @@
+#ifndef _ATLASMETADATAWRITER_H_
+#define _ATLASMETADATAWRITER_H_
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "TexturePacker.h"
+
+// Writes out where every sprite ended up in the packed texture.
+// Sprites are written one by one straight to the stream, nothing is built in memory first,
+// so the cost stays flat with the number of sprites. Only fitted sprites are written,
+// and the name of a sprite is the std::string its userData points to.
+class AtlasMetadataWriter
+{
+public:
+
+    virtual ~AtlasMetadataWriter() {}
+
+    virtual bool Write(std::ostream& out, const std::string& textureName, int width, int height,
+        const std::vector<SpriteInfo>& sprites) = 0;
+
+    // Picks the writer from the extension of the path: .json, .plist, .bin or .sprites.
+    // Returns NULL if the extension is not one of them.
+    static AtlasMetadataWriter* CreateForPath(const std::string& path);
+};
+
+// Writes a JSON hash with one entry per sprite under "frames" and the texture under "meta".
+class JsonAtlasWriter : public AtlasMetadataWriter
+{
+public:
+    virtual bool Write(std::ostream& out, const std::string& textureName, int width, int height,
+        const std::vector<SpriteInfo>& sprites);
+};
+
+// Writes a cocos2d property list, format 3, with the polygon of each sprite
+// as vertices/verticesUV/triangles so it can be loaded as a polygon sprite.
+class PlistAtlasWriter : public AtlasMetadataWriter
+{
+public:
+    virtual bool Write(std::ostream& out, const std::string& textureName, int width, int height,
+        const std::vector<SpriteInfo>& sprites);
+};
+
+//  Compact little-endian binary format, meant to be mmapped and used in place by a runtime.
+//  All offsets are in bytes from the start of the file and every section is 4-byte aligned.
+//
+//  AtlasFileHeader
+//  AtlasSpriteRecord[spriteCount]
+//  int32 vertices[]             x, y pairs in source image pixels, referenced by the records
+//  char  strings[]              NUL terminated names, referenced by the header and the records
+const static unsigned int ATLAS_FILE_MAGIC = 0x4B505441; // "ATPK"
+const static unsigned int ATLAS_FILE_VERSION = 1;
+
+const static unsigned int ATLAS_SPRITE_ROTATED = (1<<0);
+const static unsigned int ATLAS_SPRITE_TRIMMED = (1<<1);
+
+struct AtlasFileHeader
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int textureWidth, textureHeight;
+    unsigned int spriteCount;
+    unsigned int spriteOffset;          // Offset of the first AtlasSpriteRecord.
+    unsigned int textureNameOffset;
+    unsigned int reserved;
+};
+
+struct AtlasSpriteRecord
+{
+    int x, y;                           // Position of the sprite in the packed texture.
+    unsigned int w, h;                  // Size of the sprite in the packed texture.
+    int offsetX, offsetY;               // Position of the packed pixels inside the source image.
+    unsigned int srcW, srcH;            // Size of the source image.
+    unsigned int flags;                 // ATLAS_SPRITE_ROTATED, ATLAS_SPRITE_TRIMMED.
+    unsigned int vertexCount;
+    unsigned int vertexOffset;
+    unsigned int nameOffset;
+};
+
+class BinaryAtlasWriter : public AtlasMetadataWriter
+{
+public:
+    virtual bool Write(std::ostream& out, const std::string& textureName, int width, int height,
+        const std::vector<SpriteInfo>& sprites);
+};
+
+//  Records what the packer was given, not where the sprites went, so that packing can be studied
+//  again without the images (see bench/PackingCorpus.cpp). Every sprite is written, fitted or not.
+//  Text, one sprite per line after the texture size:
+//
+//      sprites 1
+//      texture Width Height
+//      Name SourceWidth SourceHeight ShapeMask VertexCount X Y X Y ...
+class SpriteDescriptorWriter : public AtlasMetadataWriter
+{
+public:
+    virtual bool Write(std::ostream& out, const std::string& textureName, int width, int height,
+        const std::vector<SpriteInfo>& sprites);
+};
+
+// Reads what SpriteDescriptorWriter wrote into sprites and names, replacing what they held.
+// The userData of each sprite points to its name in names.
+bool ReadSpriteDescriptors(std::istream& in, int& width, int& height,
+    std::vector<SpriteInfo>& sprites, std::vector<std::string>& names);
+
+#endif
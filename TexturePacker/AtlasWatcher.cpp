@@ -0,0 +1,390 @@
+#include "AtlasWatcher.h"
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <map>
+#include <stdio.h>
+#include "MyPngWriter.h"
+#include "BoundingGenerator.h"
+#include "Platform.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+inline std::string Dirname(const std::string& path)
+{
+    std::string::size_type slash = path.find_last_of("/\\");
+    if (slash == std::string::npos)
+        return ".";
+    if (slash == 0)
+        return "/";
+    return path.substr(0, slash);
+}
+
+inline std::string Basename(const std::string& path)
+{
+    std::string::size_type slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+inline std::string JoinPath(const std::string& dir, const std::string& name)
+{
+    if (dir == ".")
+        return name;
+    if (dir == "/")
+        return dir + name;
+    return dir + "/" + name;
+}
+
+// The same file named the way the events name it.
+inline std::string EventPath(const std::string& path)
+{
+    return JoinPath(Dirname(path), Basename(path));
+}
+
+// One packed texture kept in memory between updates.
+class WatchedAtlas
+{
+public:
+
+    explicit WatchedAtlas(const PackJob& job)
+    :mJob(job)
+    ,mPacker(NULL)
+    ,mCanvas(NULL)
+    {
+    }
+
+    ~WatchedAtlas()
+    {
+        delete mPacker;
+        delete mCanvas;
+    }
+
+    // Reads the list file, packs every sprite and composes the whole image.
+    bool Rebuild()
+    {
+        mFileList.clear();
+        mSprites.clear();
+
+        if (!ReadListFile(mJob.listFile, mFileList))
+        {
+            std::cerr << "Cannot open list file " << mJob.listFile << "\n";
+            return false;
+        }
+
+        LoadSprites(mFileList, NULL, mSprites);
+        PackAll();
+        return true;
+    }
+
+    // Applies the changes to the sprites whose path is in changed.
+    // Returns the number of sprites of this packed texture that changed.
+    int Update(const std::set<std::string>& changed)
+    {
+        std::vector<int> indices;
+        for (int i = 0; i < mSprites.size(); ++i)
+        {
+            if (changed.count(EventPath(*(std::string*)mSprites[i].userData)))
+                indices.push_back(i);
+        }
+
+        if (indices.empty())
+            return 0;
+
+        // Decode the changed sprites and clear their old place first, so a sprite moving
+        // into the place another one left is not erased afterwards. One that cannot be read,
+        // deleted or renamed or still being written, keeps its shape and pixels.
+        std::vector<int> updated;
+        std::vector<MyPngWriter*> images;
+        std::vector<bool> wasFitted;
+        for (int k = 0; k < indices.size(); ++k)
+        {
+            SpriteInfo& sprite = mSprites[indices[k]];
+            const std::string& path = *(std::string*)sprite.userData;
+
+            MyPngWriter* image = new MyPngWriter(1, 1, 0, "");
+            if (!image->readfromfile(path.c_str()))
+            {
+                std::cerr << "Cannot read sprite " << path << ", keeping the previous one\n";
+                delete image;
+                continue;
+            }
+            updated.push_back(indices[k]);
+            images.push_back(image);
+
+            if (sprite.fitted)
+                EraseSprite(*mCanvas, sprite);
+            wasFitted.push_back(sprite.fitted);
+
+            BoundingGenerator boundGen;
+            SpriteInfo shape = boundGen.GenerateMoreCompactBounding(image);
+            sprite.vertex = shape.vertex;
+            sprite.shapeMask = shape.shapeMask;
+            sprite.srcW = shape.srcW;
+            sprite.srcH = shape.srcH;
+        }
+
+        // The debugging lines may stick out of the polygons, so they are redrawn from scratch.
+        bool repackAll = false, recompose = mJob.drawDebugLines;
+        for (int k = 0; k < updated.size() && !repackAll; ++k)
+        {
+            SpriteInfo& sprite = mSprites[updated[k]];
+
+            if (mPacker->Replace(sprite))
+            {
+                if (!recompose)
+                    DrawSprite(*mCanvas, *images[k], sprite, 0, mJob.height, false);
+            }
+            else if (wasFitted[k])
+            {
+                repackAll = true;
+            }
+        }
+
+        for (int k = 0; k < images.size(); ++k)
+            delete images[k];
+
+        if (repackAll)
+            PackAll();
+        else if (recompose)
+            Compose();
+
+        return updated.size();
+    }
+
+    void Write()
+    {
+        mCanvas->close();
+
+        std::ofstream logFile(mJob.logPath.c_str());
+        for (int i = 0; i < mSprites.size(); ++i)
+        {
+            if (!mSprites[i].fitted)
+                LogNotPacked(logFile, mSprites[i]);
+        }
+
+        if (!mJob.dataPath.empty())
+            WriteOutMetadata(mJob.dataPath, mJob.outputPath, mJob.width, mJob.height, mSprites);
+    }
+
+    const PackJob& GetJob() const { return mJob; }
+
+    const std::vector<std::string>& GetFileList() const { return mFileList; }
+
+private:
+
+    void PackAll()
+    {
+        for (int i = 0; i < mSprites.size(); ++i)
+        {
+            mSprites[i].fitted = false;
+            mSprites[i].x = mSprites[i].y = -1;
+        }
+
+        delete mPacker;
+        mPacker = new TexturePacker(mJob.width, mJob.height);
+        mPacker->Pack(mSprites);
+
+        Compose();
+    }
+
+    void Compose()
+    {
+        delete mCanvas;
+        mCanvas = new MyPngWriter(mJob.width, mJob.height, mJob.outputPath.c_str(), CANVAS_TILE_SIZE);
+        mCanvas->setencodethreads(mJob.encodeThreads);
+        mCanvas->setfilterstrategy(mJob.filterStrategy);
+        mCanvas->setcompressionlevel(mJob.compressionLevel);
+
+        // Every sprite is read into the same image, which keeps the memory of the largest one so far.
+        MyPngWriter inPngFile(1, 1, 0, "");
+        for (int i = 0; i < mSprites.size(); ++i)
+        {
+            const SpriteInfo& info = mSprites[i];
+            if (!info.fitted)
+                continue;
+
+            // The place of a sprite that cannot be read any more is left empty.
+            const std::string& path = *(std::string*)info.userData;
+            if (inPngFile.readfromfile(path.c_str()))
+                DrawSprite(*mCanvas, inPngFile, info, 0, mJob.height, mJob.drawDebugLines);
+            else
+                std::cerr << "Cannot read sprite " << path << ", leaving its place empty\n";
+        }
+    }
+
+    PackJob mJob;
+    std::vector<std::string> mFileList;
+    std::vector<SpriteInfo> mSprites;
+    TexturePacker* mPacker;
+    MyPngWriter* mCanvas;
+};
+
+#ifdef __linux__
+
+const int WATCH_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+
+void WatchDirectories(int fd, const std::vector<WatchedAtlas*>& atlases, std::map<int, std::string>& watched)
+{
+    std::set<std::string> dirs;
+    for (int i = 0; i < atlases.size(); ++i)
+    {
+        dirs.insert(Dirname(atlases[i]->GetJob().listFile));
+
+        const std::vector<std::string>& fileList = atlases[i]->GetFileList();
+        for (int j = 0; j < fileList.size(); ++j)
+            dirs.insert(Dirname(fileList[j]));
+    }
+
+    // Adding a directory twice gives back the same descriptor.
+    for (std::set<std::string>::iterator it = dirs.begin(); it != dirs.end(); ++it)
+    {
+        int wd = inotify_add_watch(fd, it->c_str(), WATCH_EVENTS);
+        if (wd < 0)
+        {
+            std::cerr << "Cannot watch directory " << *it << "\n";
+            continue;
+        }
+        watched[wd] = *it;
+    }
+}
+
+// Adds the paths the events name to changed. overflow is set if the queue overflowed, some events
+// were lost then.
+bool ReadEvents(int fd, const std::map<int, std::string>& watched, std::set<std::string>& changed, bool& overflow)
+{
+    char buffer[64 * 1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    ssize_t size = read(fd, buffer, sizeof(buffer));
+    if (size < 0)
+        return errno == EINTR || errno == EAGAIN;
+
+    for (char* p = buffer; p < buffer + size; )
+    {
+        const inotify_event* event = (const inotify_event*)p;
+        p += sizeof(inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW)
+            overflow = true;
+
+        std::map<int, std::string>::const_iterator it = watched.find(event->wd);
+        if (event->len > 0 && it != watched.end())
+            changed.insert(JoinPath(it->second, event->name));
+    }
+
+    return true;
+}
+
+int WatchAtlases(const std::vector<PackJob>& jobs, int debounceMs)
+{
+    // The sprites are rewritten while they are read, a mapped one cut short would raise SIGBUS.
+    MyPngWriter::setmapfiles(false);
+
+    int fd = inotify_init();
+    if (fd < 0)
+    {
+        perror("inotify_init");
+        return -1;
+    }
+
+    std::vector<WatchedAtlas*> atlases;
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        double startTime = GetTimeInSeconds();
+
+        WatchedAtlas* atlas = new WatchedAtlas(jobs[i]);
+        if (atlas->Rebuild())
+            atlas->Write();
+        atlases.push_back(atlas);
+
+        printf("Built %s in %.1f ms\n", jobs[i].outputPath.c_str(), (GetTimeInSeconds() - startTime) * 1000);
+    }
+
+    std::map<int, std::string> watched;
+    WatchDirectories(fd, atlases, watched);
+
+    printf("Watching %d directories for changes ...\n", (int)watched.size());
+    fflush(stdout);
+
+    for (;;)
+    {
+        // Block until something happens, then keep collecting until it has been quiet for debounceMs.
+        std::set<std::string> changed;
+        bool overflow = false;
+        int timeout = -1;
+        for (;;)
+        {
+            pollfd p;
+            p.fd = fd;
+            p.events = POLLIN;
+            p.revents = 0;
+
+            int ready = poll(&p, 1, timeout);
+            if (ready < 0 && errno == EINTR)
+                continue;
+            if (ready < 0 || (ready > 0 && !ReadEvents(fd, watched, changed, overflow)))
+            {
+                perror("inotify");
+                return -1;
+            }
+            if (ready == 0)
+                break;
+
+            timeout = debounceMs;
+        }
+
+        // Which files changed is not known any more, so everything is built again.
+        if (overflow)
+        {
+            printf("Too many changes at once, rebuilding everything\n");
+            fflush(stdout);
+        }
+
+        bool rewatch = false;
+        for (int i = 0; i < atlases.size(); ++i)
+        {
+            WatchedAtlas* atlas = atlases[i];
+            const PackJob& job = atlas->GetJob();
+            double startTime = GetTimeInSeconds();
+            int count;
+
+            if (overflow || changed.count(EventPath(job.listFile)))
+            {
+                if (atlas->Rebuild())
+                    atlas->Write();
+                count = atlas->GetFileList().size();
+                rewatch = true;
+            }
+            else if ((count = atlas->Update(changed)) > 0)
+            {
+                atlas->Write();
+            }
+            else
+            {
+                continue;
+            }
+
+            printf("Updated %s, %d sprites changed, in %.1f ms\n",
+                job.outputPath.c_str(), count, (GetTimeInSeconds() - startTime) * 1000);
+            fflush(stdout);
+        }
+
+        // A list file may now name sprites in other directories.
+        if (rewatch)
+            WatchDirectories(fd, atlases, watched);
+    }
+}
+
+#else
+
+int WatchAtlases(const std::vector<PackJob>& jobs, int debounceMs)
+{
+    std::cerr << "--watch needs inotify, it is not supported on this platform.\n";
+    return -1;
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef _ATLASWATCHER_H_
+#define _ATLASWATCHER_H_
+
+#include <vector>
+#include "AtlasBuilder.h"
+
+//  Builds the packed textures of the jobs, then keeps them up to date as their sprites change on disk,
+//  until the process is killed. Only supported where inotify is (Linux), returns -1 elsewhere.
+//
+//  The directories of the list files and of the sprites are watched. Events are collected until none
+//  came in for debounceMs, and all the changes to one packed texture are applied together:
+//  - only the sprites that changed are decoded again and get a new bounding polygon,
+//  - a sprite stays where it was if its new shape still fits there, otherwise it moves to the first
+//    free place that fits, and the whole texture is packed again only if it fits nowhere,
+//  - the composed image is kept in memory, so only the pixels of the changed sprites are redrawn,
+//  - packed textures without a changed sprite are not written again.
+//  A change to a list file rebuilds its packed texture from scratch.
+int WatchAtlases(const std::vector<PackJob>& jobs, int debounceMs);
+
+#endif
@@ -0,0 +1,203 @@
+#include "BatchJobs.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include "Threading.h"
+#include "Platform.h"
+
+// Lets the jobs in only while the memory they need fits under the cap.
+class MemoryBudget
+{
+public:
+
+    explicit MemoryBudget(double cap)
+    :mCap(cap)
+    ,mInUse(0)
+    ,mUsers(0)
+    {
+    }
+
+    void Acquire(double bytes)
+    {
+        ScopedLock lock(mMutex);
+
+        // A job larger than the whole cap waits until it is alone.
+        while (mCap > 0 && mUsers > 0 && mInUse + bytes > mCap)
+            mReleased.Wait(mMutex);
+
+        mInUse += bytes;
+        ++mUsers;
+    }
+
+    void Release(double bytes)
+    {
+        ScopedLock lock(mMutex);
+
+        mInUse -= bytes;
+        --mUsers;
+        mReleased.Broadcast();
+    }
+
+private:
+
+    double mCap;
+    double mInUse;
+    int mUsers;
+    Mutex mMutex;
+    Condition mReleased;
+};
+
+class BatchJobTask : public Task
+{
+public:
+
+    BatchJobTask(const PackJob& job, SpriteShapeCache* shapes, MemoryBudget* budget, const BuildControl* control,
+        volatile long* finishedCount, int jobCount)
+    :mJob(job)
+    ,mShapes(shapes)
+    ,mBudget(budget)
+    ,mControl(control)
+    ,mFinishedCount(finishedCount)
+    ,mJobCount(jobCount)
+    ,mSucceeded(false)
+    {
+    }
+
+    virtual void Run()
+    {
+        double bytes = mJob.GetCanvasBytes();
+
+        // The jobs run side by side, only whole jobs are reported.
+        mBudget->Acquire(bytes);
+        mSucceeded = BuildAtlas(mJob, mShapes, &mStats, BuildControl(NULL, mControl->cancel));
+        mBudget->Release(bytes);
+
+        mControl->Report(STAGE_JOBS, AtomicAdd(mFinishedCount, 1), mJobCount);
+    }
+
+    PackJob mJob;
+    PackStats mStats;
+    SpriteShapeCache* mShapes;
+    MemoryBudget* mBudget;
+    const BuildControl* mControl;
+    volatile long* mFinishedCount;
+    int mJobCount;
+    bool mSucceeded;
+};
+
+inline std::string ReplaceExtension(const std::string& path, const std::string& extension)
+{
+    std::string::size_type dot = path.rfind('.');
+    std::string::size_type slash = path.find_last_of("/\\");
+
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return path + extension;
+    return path.substr(0, dot) + extension;
+}
+
+bool ReadJobFile(const std::string& jobFilePath, std::vector<PackJob>& jobs)
+{
+    std::ifstream inFile(jobFilePath.c_str());
+    if (!inFile.is_open())
+    {
+        std::cerr << "Cannot open job file " << jobFilePath << "\n";
+        return false;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    bool ok = true;
+
+    while (std::getline(inFile, line))
+    {
+        ++lineNo;
+
+        std::istringstream tokens(line);
+        std::vector<std::string> args;
+        std::string token;
+        while (tokens >> token)
+            args.push_back(token);
+
+        if (args.empty() || args[0][0] == '#')
+            continue;
+
+        PackJob job;
+        job.outputPath = "";
+
+        std::string error;
+        if (!ParsePackJob(args, job, error))
+        {
+            std::cerr << jobFilePath << ":" << lineNo << ": " << error << "\n";
+            ok = false;
+            continue;
+        }
+
+        if (job.outputPath.empty())
+            job.outputPath = ReplaceExtension(job.listFile, ".png");
+        job.logPath = ReplaceExtension(job.outputPath, ".log");
+
+        jobs.push_back(job);
+    }
+
+    return ok;
+}
+
+int RunBatch(const std::string& jobFilePath, int threadCount, double memoryCap, const BuildControl& control)
+{
+    std::vector<PackJob> jobs;
+    if (!ReadJobFile(jobFilePath, jobs))
+        return -1;
+
+    double startTime = GetTimeInSeconds();
+
+    SpriteShapeCache shapes;
+    MemoryBudget budget(memoryCap);
+    std::vector<BatchJobTask*> tasks;
+    volatile long finishedCount = 0;
+
+    {
+        ThreadPool pool(threadCount);
+
+        printf("Running %d jobs on %d threads ...\n", (int)jobs.size(), pool.GetThreadCount());
+
+        for (int i = 0; i < jobs.size(); ++i)
+        {
+            // The jobs already keep the cores busy, unless there is a single thread for them.
+            if (jobs[i].encodeThreads == 0 && pool.GetThreadCount() > 1)
+                jobs[i].encodeThreads = 1;
+
+            tasks.push_back(new BatchJobTask(jobs[i], &shapes, &budget, &control, &finishedCount, jobs.size()));
+            pool.Submit(tasks.back());
+        }
+
+        pool.Wait();
+    }
+
+    int failed = 0;
+
+    printf("\n%-4s %8s %8s %11s %11s %11s %11s  %s\n",
+        "Job", "Sprites", "Packed", "Decode(ms)", "Pack(ms)", "Write(ms)", "Total(ms)", "Output");
+
+    for (int i = 0; i < tasks.size(); ++i)
+    {
+        const BatchJobTask& task = *tasks[i];
+        const PackStats& stats = task.mStats;
+
+        printf("%-4d %8d %8d %11.1f %11.1f %11.1f %11.1f  %s%s\n", i + 1,
+            stats.spriteCount, stats.fittedCount,
+            stats.decodeTime * 1000, stats.packTime * 1000, stats.writeTime * 1000, stats.totalTime * 1000,
+            task.mJob.outputPath.c_str(),
+            stats.cancelled ? " (cancelled)" : !task.mSucceeded ? " (FAILED)" : stats.cacheHit ? " (cached)" : "");
+
+        if (!task.mSucceeded)
+            ++failed;
+
+        delete tasks[i];
+    }
+
+    printf("\n%d jobs in %.1f ms, %d sprite shapes generated, %d reused from other jobs.\n",
+        (int)jobs.size(), (GetTimeInSeconds() - startTime) * 1000, shapes.GetMissCount(), shapes.GetHitCount());
+
+    return failed;
+}
@@ -0,0 +1,32 @@
+#ifndef _BATCHJOBS_H_
+#define _BATCHJOBS_H_
+
+#include <string>
+#include <vector>
+#include "AtlasBuilder.h"
+
+//  Builds all the packed textures of a job file in one process.
+//  The job file has one job per line, with the same arguments as the command line:
+//
+//      ListFile OutFileWidth OutFileHeight {DrawDebugLines} {Options}
+//
+//  Empty lines and lines starting with '#' are skipped. A job without --out writes its packed
+//  texture next to its list file, with the .png extension, and reports the sprites that could not
+//  be packed in a .log file beside it.
+//
+//  The jobs run on threadCount threads (one per core if <= 0). A job only starts once the
+//  memory its output image needs fits under memoryCap bytes along with the jobs already running
+//  (0 for no limit), a job larger than the cap runs alone. The bounding polygon of a sprite used by
+//  several jobs is computed once, its pixels are decoded again by every job that draws it.
+//
+//  Each finished job is reported to control as STAGE_JOBS, and once control is cancelled the running
+//  jobs stop and the waiting ones are skipped, all of them counting as failed.
+//
+//  Returns the number of jobs that failed, or -1 if the job file could not be read.
+int RunBatch(const std::string& jobFilePath, int threadCount, double memoryCap, const BuildControl& control = BuildControl());
+
+//  Reads the jobs of a job file, see RunBatch. Returns false if the file could not be read or a
+//  line is not a valid job, the valid jobs are still added.
+bool ReadJobFile(const std::string& jobFilePath, std::vector<PackJob>& jobs);
+
+#endif
@@ -2,28 +2,42 @@
 #include "MyPngWriter.h"
 #include <cassert>
 #include "GeoUtil.h"
+#include "Profiler.h"
 
 const int BoundingGenerator::MIN_AREA_TO_CUT = 3500;
 
 BoundingGenerator::BoundingGenerator()
+:mPngFile(NULL)
 {
 }
 
 BoundingGenerator::~BoundingGenerator()
 {
-	mPngFile->close();
 }
 
 SpriteInfo BoundingGenerator::GenerateMoreCompactBounding(const std::string& spriteTextureFilePath)
 {
+	MyPngWriter pngFile(1, 1, 0, spriteTextureFilePath.c_str());
+	pngFile.readfromfile(spriteTextureFilePath.c_str());
+
+	return GenerateMoreCompactBounding(&pngFile);
+}
+
+SpriteInfo BoundingGenerator::GenerateMoreCompactBounding(MyPngWriter* image)
+{
+	PROFILE_SCOPE("GenerateMoreCompactBounding");
+
 	int w, h;
 
-	mPngFile = new MyPngWriter(1, 1, 0, spriteTextureFilePath.c_str());
-    mPngFile->readfromfile(spriteTextureFilePath.c_str());
+	mPngFile = image;
+	mSpriteInfo.vertex.clear();
 
     w = mPngFile->getwidth();
 	h = mPngFile->getheight();
 
+	mSpriteInfo.srcW = w;
+	mSpriteInfo.srcH = h;
+
 	mTop = 0;
 	mLeft = 0;
 	mRight = w - 1; 
@@ -38,6 +52,7 @@ SpriteInfo BoundingGenerator::GenerateMoreCompactBounding(const std::string& spr
 		TryCutCorner(corner);
 	}
 
+	mPngFile = NULL;
     return mSpriteInfo;
 }
 
@@ -224,10 +239,10 @@ void BoundingGenerator::TryCutCorner(int cornerNo)
 }
 
 
-bool BoundingGenerator::HasValidPixelAt(int x, int y)
+inline bool BoundingGenerator::HasValidPixelAt(const unsigned char* row, int x)
 {
-    return mPngFile->getAlpha(x, y) > 0 || mPngFile->getRed(x, y) > 0
-        || mPngFile->getGreen(x, y) > 0 || mPngFile->getBlue(x, y) > 0;
+    const unsigned char* pixel = row + 4 * x;
+    return (pixel[0] | pixel[1] | pixel[2] | pixel[3]) != 0;
 }
 
 // To test if a cutting line is valid or not, we don't need to test every pixels against the line.
@@ -265,18 +280,26 @@ void BoundingGenerator::FindBoundingPixels()
     int w = mPngFile->getwidth(), h = mPngFile->getheight();
 	int i, j;
 
- 	mTopMostInCol.resize(w);
- 	mBottomMostInCol.resize(w);
+ 	// A column with no valid pixel has h as its top most and -1 as its bottom most.
+	mTopMostInCol.assign(w, h);
+	mBottomMostInCol.assign(w, -1);
 
-    for (i = 0; i < w; ++i)
+	// One pass down the rows, rather than up and down every column.
+    for (j = 0; j < h; ++j)
     {
-		j = 0;
-		while (j < h && !HasValidPixelAt(i, j)) ++j;
-		mTopMostInCol[i] = j;
-		
-		j = h - 1;
-		while (j >= 0 && !HasValidPixelAt(i, j)) --j;
-		mBottomMostInCol[i] = j;
+		const unsigned char* row = mPngFile->row(j);
+		if (row == NULL)
+			continue;
+
+		for (i = 0; i < w; ++i)
+		{
+			if (HasValidPixelAt(row, i))
+			{
+				if (mTopMostInCol[i] == h)
+					mTopMostInCol[i] = j;
+				mBottomMostInCol[i] = j;
+			}
+		}
     }
 }
 
@@ -14,13 +14,16 @@ public:
 	
 	SpriteInfo GenerateMoreCompactBounding(const std::string& spriteTextureFilePath);
 
-private:
+	// Same as above for an image that is already decoded.
+	SpriteInfo GenerateMoreCompactBounding(MyPngWriter* image);
+
+protected:
 
 	void TryCutCorner(int cornerNo);
 
     void FindBoundingPixels();
 
-    bool HasValidPixelAt(int x, int y);
+    bool HasValidPixelAt(const unsigned char* row, int x);
 
     // bool Left(int x0, int y0, int x1, int y1, int xp, int yp);
 
@@ -32,7 +35,7 @@ private:
 	//   |______|      .\____|
     bool IsCutLineValid(int fx, int fy, int tx, int ty, bool faceUp);
 
-private:
+protected:
 
     const static int MIN_AREA_TO_CUT;
 
@@ -0,0 +1,279 @@
+#include "BuildCache.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+#include <stdio.h>
+#include "Platform.h"
+#include "Threading.h"
+
+typedef unsigned long long uint64;
+
+inline uint64 RotateLeft(uint64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64 Mix(uint64 k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+inline uint64 ReadBlock(const unsigned char* p)
+{
+    uint64 value = 0;
+    for (int i = 7; i >= 0; --i)
+        value = (value << 8) | p[i];
+    return value;
+}
+
+// 128 bits MurmurHash3 (x64 variant) of data, as 32 hex digits.
+std::string HashBytes(const std::string& data)
+{
+    const unsigned char* bytes = (const unsigned char*)data.data();
+    const size_t length = data.size();
+    const uint64 c1 = 0x87c37b91114253d5ULL;
+    const uint64 c2 = 0x4cf5ad432745937fULL;
+
+    uint64 h1 = 0, h2 = 0;
+
+    size_t blocks = length / 16;
+    for (size_t i = 0; i < blocks; ++i)
+    {
+        uint64 k1 = ReadBlock(bytes + i * 16);
+        uint64 k2 = ReadBlock(bytes + i * 16 + 8);
+
+        k1 *= c1; k1 = RotateLeft(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = RotateLeft(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2; k2 = RotateLeft(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = RotateLeft(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const unsigned char* tail = bytes + blocks * 16;
+    uint64 k1 = 0, k2 = 0;
+    for (size_t i = length & 15; i > 8; --i)
+        k2 = (k2 << 8) | tail[i - 1];
+    for (size_t i = std::min(length & 15, (size_t)8); i > 0; --i)
+        k1 = (k1 << 8) | tail[i - 1];
+
+    if ((length & 15) > 8)
+    {
+        k2 *= c2; k2 = RotateLeft(k2, 33); k2 *= c1; h2 ^= k2;
+    }
+    if ((length & 15) > 0)
+    {
+        k1 *= c1; k1 = RotateLeft(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= length; h2 ^= length;
+    h1 += h2; h2 += h1;
+    h1 = Mix(h1); h2 = Mix(h2);
+    h1 += h2; h2 += h1;
+
+    char hex[33];
+    sprintf(hex, "%016llx%016llx", h1, h2);
+    return hex;
+}
+
+bool HashFile(const std::string& path, std::string& hash)
+{
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    std::ostringstream content;
+    if (in.peek() != EOF)
+        content << in.rdbuf();
+
+    hash = HashBytes(content.str());
+    return true;
+}
+
+inline std::string GetExtension(const std::string& path)
+{
+    std::string::size_type dot = path.rfind('.');
+    std::string::size_type slash = path.find_last_of("/\\");
+
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return "";
+    return path.substr(dot);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+BuildCache::BuildCache(const std::string& directory, double maxBytes)
+:mDirectory(directory)
+,mMaxBytes(maxBytes)
+{
+}
+
+bool BuildCache::ComputeKey(const PackJob& job, const std::vector<std::string>& fileList, std::string& key)
+{
+    std::ostringstream inputs;
+
+    // The output name goes into the metadata, and its format into the key.
+    inputs << "WeTexturePacker " << TEXTURE_PACKER_VERSION << "\n"
+           << "size " << job.width << " " << job.height << " debug " << job.drawDebugLines << "\n"
+           << "filter " << job.filterStrategy << " compression " << job.compressionLevel << "\n"
+           << "texture " << job.outputPath << "\n"
+           << "data " << (job.dataPath.empty() ? "none" : GetExtension(job.dataPath)) << "\n";
+
+    std::string hash;
+    if (!HashFile(job.listFile, hash))
+        return false;
+    inputs << "list " << hash << "\n";
+
+    for (int i = 0; i < fileList.size(); ++i)
+    {
+        if (!HashFile(fileList[i], hash))
+            return false;
+        inputs << fileList[i] << " " << hash << "\n";
+    }
+
+    key = HashBytes(inputs.str());
+    return true;
+}
+
+std::string BuildCache::GetEntryPath(const std::string& key, const char* suffix) const
+{
+    return mDirectory + "/" + key + suffix;
+}
+
+bool BuildCache::Fetch(const std::string& key, const PackJob& job)
+{
+    std::string png = GetEntryPath(key, ".png");
+    std::string data = GetEntryPath(key, ".data");
+    std::string log = GetEntryPath(key, ".log");
+
+    double size, modifiedTime;
+    if (!GetFileStatus(png, size, modifiedTime))
+        return false;
+
+    if (!LinkOrCopyFile(png, job.outputPath))
+        return false;
+
+    if (!job.dataPath.empty() && !LinkOrCopyFile(data, job.dataPath))
+        return false;
+
+    // The log is written in place by the builds that miss, so it gets a copy of its own.
+    if (!CopyFileContents(log, job.logPath))
+        return false;
+
+    // The time of the last use orders the entries for eviction.
+    TouchFile(png);
+    return true;
+}
+
+bool BuildCache::StoreFile(const std::string& from, const std::string& to, bool link)
+{
+    static volatile long storeCount = 0;
+
+    // Written under a name of its own first, so that no one sees a partial file.
+    std::ostringstream temporary;
+    temporary << to << ".tmp" << GetProcessNumber() << "." << AtomicAdd(&storeCount, 1);
+
+    if (!(link ? LinkOrCopyFile(from, temporary.str()) : CopyFileContents(from, temporary.str())))
+        return false;
+
+    if (!RenameFile(temporary.str(), to))
+    {
+        RemoveFile(temporary.str());
+        return false;
+    }
+    return true;
+}
+
+bool BuildCache::Store(const std::string& key, const PackJob& job)
+{
+    if (!MakeDirectory(mDirectory))
+    {
+        std::cerr << "Cannot create cache directory " << mDirectory << "\n";
+        return false;
+    }
+
+    // The .png goes last, it is what makes the entry visible.
+    bool ok = StoreFile(job.logPath, GetEntryPath(key, ".log"), false)
+        && (job.dataPath.empty() || StoreFile(job.dataPath, GetEntryPath(key, ".data"), true))
+        && StoreFile(job.outputPath, GetEntryPath(key, ".png"), true);
+
+    if (!ok)
+    {
+        std::cerr << "Cannot store " << job.outputPath << " in cache directory " << mDirectory << "\n";
+        return false;
+    }
+
+    Evict();
+    return true;
+}
+
+struct CacheEntry
+{
+    std::string key;
+    double size;
+    double lastUsed;
+
+    bool operator<(const CacheEntry& other) const
+    {
+        return lastUsed < other.lastUsed;
+    }
+};
+
+void BuildCache::Evict()
+{
+    if (mMaxBytes <= 0)
+        return;
+
+    std::vector<std::string> names;
+    if (!ListDirectory(mDirectory, names))
+        return;
+
+    std::map<std::string, CacheEntry> entries;
+    double total = 0;
+
+    for (int i = 0; i < names.size(); ++i)
+    {
+        double size, modifiedTime;
+        if (!GetFileStatus(mDirectory + "/" + names[i], size, modifiedTime))
+            continue;
+
+        // Files left over by a build that stopped half way get the time they were written.
+        std::string key = names[i].substr(0, names[i].find('.'));
+        CacheEntry& entry = entries[key];
+        if (entry.key.empty())
+        {
+            entry.key = key;
+            entry.size = 0;
+            entry.lastUsed = modifiedTime;
+        }
+
+        entry.size += size;
+        if (GetExtension(names[i]) == ".png")
+            entry.lastUsed = modifiedTime;
+        total += size;
+    }
+
+    if (total <= mMaxBytes)
+        return;
+
+    std::vector<CacheEntry> oldestFirst;
+    for (std::map<std::string, CacheEntry>::iterator it = entries.begin(); it != entries.end(); ++it)
+        oldestFirst.push_back(it->second);
+    std::sort(oldestFirst.begin(), oldestFirst.end());
+
+    for (int i = 0; i < oldestFirst.size() && total > mMaxBytes; ++i)
+    {
+        for (int j = 0; j < names.size(); ++j)
+        {
+            if (names[j].compare(0, oldestFirst[i].key.size() + 1, oldestFirst[i].key + ".") == 0)
+                RemoveFile(mDirectory + "/" + names[j]);
+        }
+        total -= oldestFirst[i].size;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef _BUILDCACHE_H_
+#define _BUILDCACHE_H_
+
+#include <string>
+#include <vector>
+#include "AtlasBuilder.h"
+
+//  Outputs of earlier builds, found again by a hash of everything they were made from: the list file,
+//  the content of every sprite, the packing parameters and the version of the tool. The directory can be
+//  shared by several processes and machines, an entry only shows up once it is complete.
+//
+//  An entry is made of <key>.png, <key>.log, and <key>.data when the build wrote metadata. The packed
+//  texture and the metadata are hard linked to the entries where possible, copied otherwise, which is safe
+//  as long as they are replaced rather than written over. Once the entries take more than maxBytes, the
+//  least recently used ones are removed.
+class BuildCache
+{
+public:
+
+    BuildCache(const std::string& directory, double maxBytes);
+
+    // Key of building job from the sprites in fileList, false if one of the inputs cannot be read.
+    static bool ComputeKey(const PackJob& job, const std::vector<std::string>& fileList, std::string& key);
+
+    // Puts the outputs of the entry in place of the ones of job, false if there is no such entry.
+    bool Fetch(const std::string& key, const PackJob& job);
+
+    // Adds the outputs job has just written under key.
+    bool Store(const std::string& key, const PackJob& job);
+
+private:
+
+    std::string GetEntryPath(const std::string& key, const char* suffix) const;
+
+    bool StoreFile(const std::string& from, const std::string& to, bool link);
+
+    void Evict();
+
+    std::string mDirectory;
+    double mMaxBytes;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef _BYTE_ORDER_H_
+#define _BYTE_ORDER_H_
+
+#include <istream>
+#include <ostream>
+
+// 32 bits values in little-endian order, whatever the host is, for the binary files written and read back.
+
+inline void WriteU32(std::ostream& out, unsigned int value)
+{
+    char bytes[4] = {
+        (char)(value & 0xff), (char)((value >> 8) & 0xff),
+        (char)((value >> 16) & 0xff), (char)((value >> 24) & 0xff)
+    };
+    out.write(bytes, 4);
+}
+
+inline bool ReadU32(std::istream& in, unsigned int& value)
+{
+    unsigned char bytes[4];
+    if (!in.read((char*)bytes, 4))
+        return false;
+
+    value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+    return true;
+}
+
+inline bool ReadI32(std::istream& in, int& value)
+{
+    unsigned int u;
+    if (!ReadU32(in, u))
+        return false;
+
+    value = (int)u;
+    return true;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include "MemoryArena.h"
+#include "Platform.h"
+
+// What malloc() guarantees, enough for SSE loads and doubles.
+const size_t ARENA_ALIGNMENT = 16;
+
+MemoryArena::MemoryArena(size_t blockSize)
+:mNext(NULL)
+,mLeft(0)
+,mBlockSize(blockSize)
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+    FreeBlocks();
+}
+
+void* MemoryArena::Allocate(size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    if (size > mLeft && !AddBlock(size > mBlockSize ? size : mBlockSize))
+        return NULL;
+
+    void* p = mNext;
+    mNext += size;
+    mLeft -= size;
+    return p;
+}
+
+void MemoryArena::Reset()
+{
+    if (mBlocks.size() > 1)
+    {
+        size_t total = 0;
+        for (int i = 0; i < mBlocks.size(); ++i)
+            total += mBlocks[i].size;
+
+        FreeBlocks();
+        AddBlock(total);
+        return;
+    }
+
+    if (!mBlocks.empty())
+    {
+        mNext = mBlocks[0].memory;
+        mLeft = mBlocks[0].size;
+    }
+}
+
+bool MemoryArena::AddBlock(size_t size)
+{
+    Block block;
+    block.memory = (char*)AllocateAligned(size, ARENA_ALIGNMENT);
+    block.size = size;
+    if (block.memory == NULL)
+        return false;
+
+    mBlocks.push_back(block);
+    mNext = block.memory;
+    mLeft = size;
+    return true;
+}
+
+void MemoryArena::FreeBlocks()
+{
+    for (int i = 0; i < mBlocks.size(); ++i)
+        FreeAligned(mBlocks[i].memory);
+
+    mBlocks.clear();
+    mNext = NULL;
+    mLeft = 0;
+}
@@ -0,0 +1,44 @@
+#ifndef _MEMORY_ARENA_H_
+#define _MEMORY_ARENA_H_
+
+#include <stddef.h>
+#include <vector>
+
+// Hands out memory from a few large blocks and takes all of it back at once with Reset(), for the many
+// short lived allocations of decoding one file. Not thread safe, each thread needs an arena of its own.
+class MemoryArena
+{
+public:
+
+    // Blocks are blockSize bytes, or as large as an allocation that does not fit in one.
+    explicit MemoryArena(size_t blockSize);
+    ~MemoryArena();
+
+    // size bytes aligned for any type, NULL if out of memory.
+    void* Allocate(size_t size);
+
+    // Makes everything allocated so far available again. When more than one block was needed, they are
+    // replaced by one block as large as all of them, so the next file of the same size fits in it.
+    void Reset();
+
+private:
+
+    struct Block
+    {
+        char* memory;
+        size_t size;
+    };
+
+    bool AddBlock(size_t size);
+    void FreeBlocks();
+
+    std::vector<Block> mBlocks;
+    char* mNext;
+    size_t mLeft;       // Bytes free at mNext, to the end of the last block.
+    size_t mBlockSize;
+
+    MemoryArena(const MemoryArena&);
+    MemoryArena& operator=(const MemoryArena&);
+};
+
+#endif
@@ -41,16 +41,44 @@
  * */
 
 #include "MyPngWriter.h"
+#include "Profiler.h"
+#include "Platform.h"
+#include "Threading.h"
+#include "MemoryArena.h"
+#include <vector>
 
+bool MyPngWriter::crc_check_ = true;
+bool MyPngWriter::map_files_ = true;
 
 //Constructor for int colour levels, char * filename
 //////////////////////////////////////////////////////////////////////////
 MyPngWriter::MyPngWriter(int x, int y, int backgroundcolour, const char * filename)
+{
+   init(x, y, backgroundcolour, filename, 0, 0);
+};
+
+//Constructor keeping only bandheight rows in memory
+//////////////////////////////////////////////////////////////////////////
+MyPngWriter::MyPngWriter(int x, int y, int backgroundcolour, const char * filename, int bandheight)
+{
+   init(x, y, backgroundcolour, filename, bandheight, 0);
+};
+
+//Constructor allocating the image in tiles as they are drawn on
+//////////////////////////////////////////////////////////////////////////
+MyPngWriter::MyPngWriter(int x, int y, const char * filename, int tilesize)
+{
+   init(x, y, 0, filename, 0, tilesize);
+};
+
+void MyPngWriter::init(int x, int y, int backgroundcolour, const char * filename, int bandheight, int tilesize)
 {
    width_ = x;
    height_ = y;
    backgroundcolour_ = backgroundcolour;
    compressionlevel_ = -2;
+   encodethreads_ = 1;
+   filterstrategy_ = PNGWRITER_FILTER_ADAPTIVE;
    filegamma_ = 0.6;
    transformation_ = 0;
 
@@ -85,46 +113,128 @@ MyPngWriter::MyPngWriter(int x, int y, int backgroundcolour, const char * filena
 	backgroundcolour_ = 0;
      }
 
-   int kkkk;
+   if((bandheight < 0)||(bandheight >= height_)||(tilesize > 0))
+     {
+	bandheight = 0;
+     }
 
    bit_depth_ = 8; //Default bit depth for new images
    colortype_=2;
    screengamma_ = 2.2;
 
-   graph_ = (png_bytepp)malloc(height_ * sizeof(png_bytep));
-   if(graph_ == NULL)
+   bandheight_ = bandheight;
+   bandtop_ = 0;
+   rows_ = (bandheight_ > 0) ? bandheight_ : height_;
+   stream_fp_ = NULL;
+   stream_png_ = NULL;
+   stream_info_ = NULL;
+   control_ = NULL;
+
+   tilesize_ = (tilesize > 0) ? tilesize : 0;
+   tilesx_ = 0;
+   tilesy_ = 0;
+   tiles_ = NULL;
+   releaseonclose_ = false;
+   if(tilesize_ > 0)
      {
-	std::cerr << " MyPngWriter::MyPngWriter - ERROR **:  Not able to allocate memory for image." << std::endl;
-     }
-
-   for (kkkk = 0; kkkk < height_; kkkk++)
-     {
-        graph_[kkkk] = (png_bytep)malloc(4*width_ * sizeof(png_byte));
-	if(graph_[kkkk] == NULL)
+	// No rows at all, the tiles hold the whole image.
+	rows_ = 0;
+	tilesx_ = (width_ + tilesize_ - 1) / tilesize_;
+	tilesy_ = (height_ + tilesize_ - 1) / tilesize_;
+	tiles_ = (unsigned char **)calloc((size_t)tilesx_ * tilesy_, sizeof(unsigned char *));
+	if(tiles_ == NULL)
 	  {
 	     std::cerr << " MyPngWriter::MyPngWriter - ERROR **:  Not able to allocate memory for image." << std::endl;
+	     tilesize_ = 0;
 	  }
      }
 
-   if(graph_ == NULL)
+   pixels_ = NULL;
+   alloc_pixels(rows_, 4*(size_t)width_);
+   fill_rows();
+}
+
+// Allocates rows rows of rowbytes bytes in pixels_, which must be free. Holds no row if it fails.
+bool MyPngWriter::alloc_pixels(int rows, size_t rowbytes)
+{
+   stride_ = (rowbytes + PNGWRITER_ROW_ALIGNMENT - 1) & ~(size_t)(PNGWRITER_ROW_ALIGNMENT - 1);
+   rows_ = rows;
+   pixelsbytes_ = 0;
+   if(rows_ <= 0)
+     {
+	return true;
+     }
+
+   pixels_ = (unsigned char *)AllocateAligned((size_t)rows_*stride_, PNGWRITER_ROW_ALIGNMENT);
+   if(pixels_ == NULL)
      {
 	std::cerr << " MyPngWriter::MyPngWriter - ERROR **:  Not able to allocate memory for image." << std::endl;
+	rows_ = 0;
+	return false;
+     }
+   pixelsbytes_ = (size_t)rows_*stride_;
+   return true;
+}
+
+// Sets every row held in memory to the background colour.
+void MyPngWriter::fill_rows(void)
+{
+   if(pixels_ != NULL)
+     {
+	memset(pixels_, backgroundcolour_%256, (size_t)rows_*stride_);
+     }
+}
+
+// Row y of the image, or NULL if it is not in memory (outside the current band).
+inline unsigned char * MyPngWriter::row_at(int y)
+{
+   int r = y - bandtop_;
+   if((r < 0)||(r >= rows_))
+     {
+	return NULL;
      }
+   return pixels_ + (size_t)r*stride_;
+}
 
-   int tempindex;
-   for(int hhh = 0; hhh<width_;hhh++)
+// Pixel (x, y) of the image, or NULL if it is not in memory. In a tiled image, the tile is allocated if
+// allocate is set, otherwise NULL stands for a pixel of a tile never drawn on, still transparent black.
+inline unsigned char * MyPngWriter::pixel_at(int x, int y, bool allocate)
+{
+   if(tiles_ == NULL)
      {
-	for(int vhhh = 0; vhhh<height_;vhhh++)
+	unsigned char * row = row_at(y);
+	return (row == NULL) ? NULL : row + 4*(size_t)x;
+     }
+
+   unsigned char * & tile = tiles_[(size_t)(y/tilesize_)*tilesx_ + x/tilesize_];
+   if(tile == NULL)
+     {
+	if(!allocate)
+	  {
+	     return NULL;
+	  }
+	tile = (unsigned char *)calloc((size_t)tilesize_*tilesize_, 4);
+	if(tile == NULL)
 	  {
-	     tempindex = 4*hhh;
-	     graph_[vhhh][tempindex] = (char)(backgroundcolour_%256);
-	     graph_[vhhh][tempindex+1] = (char)(backgroundcolour_%256);
-	     graph_[vhhh][tempindex+2] = (char)(backgroundcolour_%256);
-	     graph_[vhhh][tempindex+3] = (char)(backgroundcolour_%256);
+	     std::cerr << " MyPngWriter::plot - ERROR **:  Not able to allocate memory for image tile." << std::endl;
+	     return NULL;
 	  }
      }
+   return tile + 4*((size_t)(y%tilesize_)*tilesize_ + x%tilesize_);
+}
 
-};
+void MyPngWriter::free_tiles(void)
+{
+   if(tiles_ == NULL)
+     {
+	return;
+     }
+   for (size_t t = 0; t < (size_t)tilesx_*tilesy_; t++)
+     {
+	free(tiles_[t]);
+	tiles_[t] = NULL;
+     }
+}
 
 //Destructor
 ///////////////////////////////////////
@@ -136,8 +246,15 @@ MyPngWriter::~MyPngWriter()
    delete [] texttitle_;
    delete [] textsoftware_;
 
-   for (int jjj = 0; jjj < height_; jjj++) free(graph_[jjj]);
-   free(graph_);
+   if(stream_png_ != NULL)
+     {
+	png_destroy_write_struct(&stream_png_, &stream_info_);
+	fclose(stream_fp_);
+     }
+
+   FreeAligned(pixels_);
+   free_tiles();
+   free(tiles_);
 };
 
 // Overloading operator =
@@ -153,6 +270,8 @@ MyPngWriter & MyPngWriter::operator = (const MyPngWriter & rhs)
    height_ = rhs.height_;
    backgroundcolour_ = rhs.backgroundcolour_;
    compressionlevel_ = rhs.compressionlevel_;
+   encodethreads_ = rhs.encodethreads_;
+   filterstrategy_ = rhs.filterstrategy_;
    filegamma_ = rhs.filegamma_;
    transformation_ = rhs.transformation_;
 
@@ -168,43 +287,40 @@ MyPngWriter & MyPngWriter::operator = (const MyPngWriter & rhs)
    strcpy(texttitle_, rhs.texttitle_);
    strcpy(filename_, rhs.filename_);
 
-   int kkkk;
-
    bit_depth_ = rhs.bit_depth_;
    colortype_= rhs.colortype_;
    screengamma_ = rhs.screengamma_;
 
-   graph_ = (png_bytepp)malloc(height_ * sizeof(png_bytep));
-   if(graph_ == NULL)
+   rows_ = rhs.rows_;
+   bandheight_ = rhs.bandheight_;
+   bandtop_ = rhs.bandtop_;
+   stream_fp_ = NULL;
+   stream_png_ = NULL;
+   stream_info_ = NULL;
+   control_ = rhs.control_;
+
+   tilesize_ = rhs.tilesize_;
+   tilesx_ = rhs.tilesx_;
+   tilesy_ = rhs.tilesy_;
+   tiles_ = NULL;
+   releaseonclose_ = rhs.releaseonclose_;
+   if(rhs.tiles_ != NULL)
      {
-	std::cerr << " MyPngWriter::MyPngWriter - ERROR **:  Not able to allocate memory for image." << std::endl;
-     }
-
-   for (kkkk = 0; kkkk < height_; kkkk++)
-     {
-        graph_[kkkk] = (png_bytep)malloc(6*width_ * sizeof(png_byte));
-	if(graph_[kkkk] == NULL)
+	size_t tilebytes = (size_t)tilesize_*tilesize_*4;
+	tiles_ = (unsigned char **)calloc((size_t)tilesx_*tilesy_, sizeof(unsigned char *));
+	for (size_t t = 0; (tiles_ != NULL)&&(t < (size_t)tilesx_*tilesy_); t++)
 	  {
-	     std::cerr << " MyPngWriter::MyPngWriter - ERROR **:  Not able to allocate memory for image." << std::endl;
+	     if((rhs.tiles_[t] != NULL)&&((tiles_[t] = (unsigned char *)malloc(tilebytes)) != NULL))
+	       {
+		  memcpy(tiles_[t], rhs.tiles_[t], tilebytes);
+	       }
 	  }
      }
 
-   if(graph_ == NULL)
-     {
-	std::cerr << " MyPngWriter::MyPngWriter - ERROR **:  Not able to allocate memory for image." << std::endl;
-     }
-
-   int tempindex;
-   for(int hhh = 0; hhh<width_;hhh++)
+   pixels_ = NULL;
+   if(alloc_pixels(rhs.rows_, rhs.stride_)&&(pixels_ != NULL))
      {
-	for(int vhhh = 0; vhhh<height_;vhhh++)
-	  {
-	     tempindex=4*hhh;
-	     graph_[vhhh][tempindex] = rhs.graph_[vhhh][tempindex];
-	     graph_[vhhh][tempindex+1] = rhs.graph_[vhhh][tempindex+1];
-	     graph_[vhhh][tempindex+2] = rhs.graph_[vhhh][tempindex+2];
-	     graph_[vhhh][tempindex+3] = rhs.graph_[vhhh][tempindex+3];
-	  }
+	memcpy(pixels_, rhs.pixels_, (size_t)rows_*stride_);
      }
 
    return *this;
@@ -213,8 +329,6 @@ MyPngWriter & MyPngWriter::operator = (const MyPngWriter & rhs)
 ///////////////////////////////////////////////////////////////
 void MyPngWriter::plot(int x, int y, int red, int green, int blue, int alpha)
 {
-   int tempindex;
-
    if(red > 255)
      {
 	red = 255;
@@ -243,13 +357,15 @@ void MyPngWriter::plot(int x, int y, int red, int green, int blue, int alpha)
 
    if((bit_depth_ == 8))
      {
-	    if( (y<height_) && (y>0) && (x>0) && (x<width_) )
+	    png_bytep pixel;
+	    // Transparent black is already there in a tile never drawn on.
+	    bool allocate = (red|green|blue|alpha) != 0;
+	    if( (y<height_) && (y>=0) && (x>=0) && (x<width_) && ((pixel = pixel_at(x, y, allocate)) != NULL) )
 	      {
-	         tempindex = 4*x;
-	         graph_[y][tempindex] = (unsigned char)(red);
-	         graph_[y][tempindex+1] = (unsigned char)(green);
-	         graph_[y][tempindex+2] = (unsigned char)(blue);
-             graph_[y][tempindex+3] = (unsigned char)(alpha);
+	         pixel[0] = (unsigned char)(red);
+	         pixel[1] = (unsigned char)(green);
+	         pixel[2] = (unsigned char)(blue);
+	         pixel[3] = (unsigned char)(alpha);
 	      };
      }
 };
@@ -258,9 +374,10 @@ unsigned char  MyPngWriter::getAlpha(int x, int y)
 {
     if((bit_depth_ == 8))
     {
-        if( (y<height_) && (y>0) && (x>0) && (x<width_) )
+        png_bytep pixel;
+        if( (y<height_) && (y>=0) && (x>=0) && (x<width_) && ((pixel = pixel_at(x, y, false)) != NULL) )
         {
-            return graph_[y][4*x+3];
+            return pixel[3];
         }
     }
 
@@ -271,9 +388,10 @@ unsigned char MyPngWriter::getRed(int x, int  y)
 {
     if((bit_depth_ == 8))
     {
-        if( (y<height_) && (y>0) && (x>0) && (x<width_) )
+        png_bytep pixel;
+        if( (y<height_) && (y>=0) && (x>=0) && (x<width_) && ((pixel = pixel_at(x, y, false)) != NULL) )
         {
-            return graph_[y][4*x+0];
+            return pixel[0];
         }
     }
 
@@ -283,9 +401,10 @@ unsigned char MyPngWriter::getGreen(int x, int  y)
 {
     if((bit_depth_ == 8))
     {
-        if( (y<height_) && (y>0) && (x>0) && (x<width_) )
+        png_bytep pixel;
+        if( (y<height_) && (y>=0) && (x>=0) && (x<width_) && ((pixel = pixel_at(x, y, false)) != NULL) )
         {
-            return graph_[y][4*x+1];
+            return pixel[1];
         }
     }
 
@@ -296,69 +415,188 @@ unsigned char MyPngWriter::getBlue(int x, int  y)
 {
     if((bit_depth_ == 8))
     {
-        if( (y<height_) && (y>0) && (x>0) && (x<width_) )
+        png_bytep pixel;
+        if( (y<height_) && (y>=0) && (x>=0) && (x<width_) && ((pixel = pixel_at(x, y, false)) != NULL) )
         {
-            return graph_[y][4*x+2];
+            return pixel[2];
         }
     }
 
     return 0;
 }
 
-///////////////////////////////////////////////////////
-void MyPngWriter::clear()
+// Row y of an 8 bits RGBA image, or NULL if it is not held in rows (outside the image or the current
+// band, or a tiled image).
+const unsigned char * MyPngWriter::row(int y)
 {
-   int pen = 0;
-   int pencil = 0;
-   int tempindex;
+   if((bit_depth_ != 8)||(tiles_ != NULL)||(y < 0)||(y >= height_))
+     {
+	return NULL;
+     }
+   return row_at(y);
+}
+
+rgba8 * MyPngWriter::span(int x, int y, int len)
+{
+   if((bit_depth_ != 8)||(len <= 0)||(x < 0)||(x+len > width_)||(y < 0)||(y >= height_))
+     {
+	return NULL;
+     }
+   if((tiles_ != NULL)&&(x/tilesize_ != (x+len-1)/tilesize_))
+     {
+	return NULL;
+     }
+   return (rgba8 *)pixel_at(x, y, true);
+}
+
+// Number of pixels from x that lie in the same place in memory: the rest of the row, or of the tile.
+inline int MyPngWriter::run_at(int x, int len)
+{
+   if(tiles_ == NULL)
+     {
+	return len;
+     }
+   int left = tilesize_ - x%tilesize_;
+   return (len < left) ? len : left;
+}
+
+void MyPngWriter::blit(int x, int y, const rgba8 * pixels, int len)
+{
+   if((bit_depth_ != 8)||(y < 0)||(y >= height_))
+     {
+	return;
+     }
+   if(x < 0)
+     {
+	pixels -= x;
+	len += x;
+	x = 0;
+     }
+   if(x+len > width_)
+     {
+	len = width_ - x;
+     }
 
-   if(bit_depth_==8)
+   while(len > 0)
      {
-	for(pen = 0; pen<width_;pen++)
+	int count = run_at(x, len);
+	unsigned char * dest = pixel_at(x, y, false);
+	if((dest == NULL)&&(tiles_ != NULL))
 	  {
-	     for(pencil = 0; pencil<height_;pencil++)
+	     // As plot() does, a tile is only allocated for pixels that are not transparent black.
+	     for(int i = 0; i < count; i++)
 	       {
-		  tempindex=4*pen;
-		  graph_[pencil][tempindex] = 0;
-		  graph_[pencil][tempindex+1] = 0;
-		  graph_[pencil][tempindex+2] = 0;
-          graph_[pencil][tempindex+3] = 0;
+		  if(pixels[i].r|pixels[i].g|pixels[i].b|pixels[i].a)
+		    {
+		       dest = pixel_at(x, y, true);
+		       break;
+		    }
 	       }
 	  }
+	if(dest != NULL)
+	  {
+	     memcpy(dest, pixels, 4*(size_t)count);
+	  }
+	x += count;
+	pixels += count;
+	len -= count;
      }
+}
 
-};
+void MyPngWriter::fill(int x, int y, int len, rgba8 colour)
+{
+   if((bit_depth_ != 8)||(y < 0)||(y >= height_))
+     {
+	return;
+     }
+   if(x < 0)
+     {
+	len += x;
+	x = 0;
+     }
+   if(x+len > width_)
+     {
+	len = width_ - x;
+     }
 
+   bool allocate = (colour.r|colour.g|colour.b|colour.a) != 0;
+   while(len > 0)
+     {
+	int count = run_at(x, len);
+	rgba8 * dest = (rgba8 *)pixel_at(x, y, allocate);
+	if(dest != NULL)
+	  {
+	     for(int i = 0; i < count; i++)
+	       {
+		  dest[i] = colour;
+	       }
+	  }
+	x += count;
+	len -= count;
+     }
+}
 
 ///////////////////////////////////////////////////////
-void MyPngWriter::close()
+void MyPngWriter::clear()
 {
-   png_FILE_p      fp;
-   png_structp     png_ptr;
-   png_infop       info_ptr;
+   free_tiles();
 
-   fp = fopen(filename_, "wb");
-   if( fp == NULL)
+   if((bit_depth_==8)&&(pixels_ != NULL))
      {
-	std::cerr << " MyPngWriter::close - ERROR **: Error creating file (fopen() returned NULL pointer)." << std::endl;
-	perror(" MyPngWriter::close - ERROR **");
-	return;
+	memset(pixels_, 0, (size_t)rows_*stride_);
      }
 
-   png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-   info_ptr = png_create_info_struct(png_ptr);
-   png_init_io(png_ptr, fp);
-   if(compressionlevel_ != -2)
+};
+
+
+// The libpng filter flags for a PNGWRITER_FILTER_ strategy.
+static int filter_flags(int strategy)
+{
+   switch(strategy)
      {
-	png_set_compression_level(png_ptr, compressionlevel_);
+      case PNGWRITER_FILTER_NONE:
+	return PNG_FILTER_NONE;
+      case PNGWRITER_FILTER_FIXED:
+	return PNG_FILTER_NONE << PNGWRITER_FIXED_FILTER;
+      default:
+	return PNG_ALL_FILTERS;
+     }
+}
+
+// Sets the zlib level and, for PNGWRITER_COMPRESSION_QUICK, the strategy of a setcompressionlevel() value.
+static void set_compression(png_structp png_ptr, int level)
+{
+   if(level == PNGWRITER_COMPRESSION_QUICK)
+     {
+	png_set_compression_level(png_ptr, 1);
+	png_set_compression_strategy(png_ptr, Z_QUICK);
      }
    else
      {
-	png_set_compression_level(png_ptr, PNGWRITER_DEFAULT_COMPRESSION);
+	png_set_compression_level(png_ptr, (level != -2) ? level : PNGWRITER_DEFAULT_COMPRESSION);
      }
+}
 
-   png_set_IHDR(png_ptr, info_ptr, width_, height_,
-		bit_depth_, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE,
+///////////////////////////////////////////////////////
+// Creates the file and writes everything that goes before the image data.
+int MyPngWriter::open_for_write(png_FILE_p *fp, png_structp *png_ptr, png_infop *info_ptr, int colortype)
+{
+   *fp = OpenReplacing(filename_);
+   if( *fp == NULL)
+     {
+	std::cerr << " MyPngWriter::close - ERROR **: Error creating file (fopen() returned NULL pointer)." << std::endl;
+	perror(" MyPngWriter::close - ERROR **");
+	return 0;
+     }
+
+   *png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+   *info_ptr = png_create_info_struct(*png_ptr);
+   png_init_io(*png_ptr, *fp);
+   set_compression(*png_ptr, compressionlevel_);
+   png_set_filter(*png_ptr, PNG_FILTER_TYPE_BASE, filter_flags(filterstrategy_));
+
+   png_set_IHDR(*png_ptr, *info_ptr, width_, height_,
+		bit_depth_, colortype, PNG_INTERLACE_NONE,
 		PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
 
    if(filegamma_ < 1.0e-1)
@@ -366,14 +604,14 @@ void MyPngWriter::close()
 	filegamma_ = 0.5;  // Modified in 0.5.4 so as to be the same as the usual gamma.
      }
 
-   png_set_gAMA(png_ptr, info_ptr, filegamma_);
+   png_set_gAMA(*png_ptr, *info_ptr, filegamma_);
 
    time_t          gmt;
    png_time        mod_time;
    png_text        text_ptr[5];
    time(&gmt);
    png_convert_from_time_t(&mod_time, gmt);
-   png_set_tIME(png_ptr, info_ptr, &mod_time);
+   png_set_tIME(*png_ptr, *info_ptr, &mod_time);
    text_ptr[0].key = "Title";
    text_ptr[0].text = texttitle_;
    text_ptr[0].compression = PNG_TEXT_COMPRESSION_NONE;
@@ -384,49 +622,660 @@ void MyPngWriter::close()
    text_ptr[2].text = textdescription_;
    text_ptr[2].compression = PNG_TEXT_COMPRESSION_NONE;
    text_ptr[3].key = "Creation Time";
-   text_ptr[3].text = png_convert_to_rfc1123(png_ptr, &mod_time);
+   text_ptr[3].text = png_convert_to_rfc1123(*png_ptr, &mod_time);
    text_ptr[3].compression = PNG_TEXT_COMPRESSION_NONE;
    text_ptr[4].key = "Software";
    text_ptr[4].text = textsoftware_;
    text_ptr[4].compression = PNG_TEXT_COMPRESSION_NONE;
-   png_set_text(png_ptr, info_ptr, text_ptr, 5);
+   png_set_text(*png_ptr, *info_ptr, text_ptr, 5);
+
+   png_write_info(*png_ptr, *info_ptr);
+   return 1;
+}
+
+///////////////////////////////////////////////////////
+void MyPngWriter::close()
+{
+   PROFILE_SCOPE("MyPngWriter::close");
+
+   png_FILE_p      fp;
+   png_structp     png_ptr;
+   png_infop       info_ptr;
 
-   png_write_info(png_ptr, info_ptr);
-   png_write_image(png_ptr, graph_);
+   if(bandheight_ > 0)
+     {
+	// Rows not plotted yet are still written, with the background colour.
+	while(bandtop_ < height_)
+	  {
+	     if((control_ != NULL)&&(control_->IsCancelled()))
+	       {
+		  abandon_stream();
+		  return;
+	       }
+	     flushband();
+	  }
+	if(stream_png_ != NULL)
+	  {
+	     png_write_end(stream_png_, stream_info_);
+	     png_destroy_write_struct(&stream_png_, &stream_info_);
+	     PROFILE_COUNT(COUNTER_BYTES_WRITTEN, ftell(stream_fp_));
+	     fclose(stream_fp_);
+	     stream_png_ = NULL;
+	     stream_info_ = NULL;
+	     stream_fp_ = NULL;
+	  }
+	return;
+     }
+
+   if(!open_for_write(&fp, &png_ptr, &info_ptr, PNG_COLOR_TYPE_RGBA))
+     {
+	return;
+     }
+   int threads = (encodethreads_ > 0) ? encodethreads_ : ThreadPool::GetCoreCount();
+   if(threads > 1)
+     {
+	if(!write_parallel(png_ptr, threads))
+	  {
+	     png_destroy_write_struct(&png_ptr, &info_ptr);
+	     fclose(fp);
+	     return;
+	  }
+     }
+   else if(tiles_ != NULL)
+     {
+	if(!write_tiles(png_ptr))
+	  {
+	     png_destroy_write_struct(&png_ptr, &info_ptr);
+	     fclose(fp);
+	     return;
+	  }
+     }
+   else
+     {
+	// Not interlaced, the rows go to libpng straight from the buffer.
+	for(int y = 0; y < rows_; y++)
+	  {
+	     png_write_row(png_ptr, row_at(y));
+	  }
+     }
    png_write_end(png_ptr, info_ptr);
    png_destroy_write_struct(&png_ptr, &info_ptr);
+   PROFILE_COUNT(COUNTER_BYTES_WRITTEN, ftell(fp));
    fclose(fp);
 }
 
+// Writes a tiled image out a row at a time, each row of tiles is freed once written if releaseonclose_.
+// Returns false if it was cancelled before the last row.
+bool MyPngWriter::write_tiles(png_structp png_ptr)
+{
+   png_bytep row = (png_bytep)malloc(4*(size_t)width_);
+   if(row == NULL)
+     {
+	std::cerr << " MyPngWriter::close - ERROR **:  Not able to allocate memory for image." << std::endl;
+	return false;
+     }
+
+   for(int y = 0; y < height_; y++)
+     {
+	unsigned char * * tilerow = tiles_ + (size_t)(y/tilesize_)*tilesx_;
+	png_write_row(png_ptr, (png_bytep)encode_row(y, row));
+
+	if((y%tilesize_ == tilesize_-1)||(y == height_-1))
+	  {
+	     for(int tx = 0; releaseonclose_ && (tx < tilesx_); tx++)
+	       {
+		  free(tilerow[tx]);
+		  tilerow[tx] = NULL;
+	       }
+
+	     if(control_ != NULL)
+	       {
+		  control_->Report(STAGE_ENCODE, y+1, height_);
+		  if(control_->IsCancelled() && (y < height_-1))
+		    {
+		       free(row);
+		       return false;
+		    }
+	       }
+	  }
+     }
+
+   free(row);
+   return true;
+}
+
+// Row y as it goes to the encoder: straight from the buffer, or put together from the tiles in scratch,
+// which holds a row. Only reads the image, so several threads can call it at once.
+const unsigned char * MyPngWriter::encode_row(int y, unsigned char * scratch)
+{
+   if(tiles_ == NULL)
+     {
+	return row_at(y);
+     }
+
+   size_t rowbytes = 4*(size_t)width_;
+   size_t tilerowbytes = 4*(size_t)tilesize_;
+   unsigned char * * tilerow = tiles_ + (size_t)(y/tilesize_)*tilesx_;
+   size_t offset = (size_t)(y%tilesize_)*tilerowbytes;
+
+   for(int tx = 0; tx < tilesx_; tx++)
+     {
+	size_t start = tx*tilerowbytes;
+	size_t count = (start + tilerowbytes < rowbytes) ? tilerowbytes : rowbytes - start;
+	if(tilerow[tx] != NULL)
+	  {
+	     memcpy(scratch + start, tilerow[tx] + offset, count);
+	  }
+	else
+	  {
+	     memset(scratch + start, 0, count);
+	  }
+     }
+   return scratch;
+}
+
+// Filters row, rowbytes bytes of 4 bytes pixels, against prev, the row above or zeros for the first one,
+// the way strategy says. out gets the filter type byte then the filtered bytes, trial must be as large.
+// Adaptive filtering tries each filter with png_filter_row() and keeps the one whose output, read as
+// signed bytes, has the smallest sum of absolute values, the first one on a tie, as libpng does.
+static void filter_row(int strategy, const png_byte * prev, const png_byte * row, size_t rowbytes,
+		       png_bytep out, png_bytep trial)
+{
+   const png_uint_32 bpp = 4;
+   png_bytep in = (png_bytep)row, above = (png_bytep)prev;
+
+   if(strategy == PNGWRITER_FILTER_NONE)
+     {
+	out[0] = PNG_FILTER_VALUE_NONE;
+	memcpy(out + 1, row, rowbytes);
+	return;
+     }
+   if(strategy == PNGWRITER_FILTER_FIXED)
+     {
+	out[0] = PNGWRITER_FIXED_FILTER;
+	png_filter_row(PNGWRITER_FIXED_FILTER, out + 1, in, above, (png_uint_32)rowbytes, bpp);
+	return;
+     }
+
+   // Each filter goes into the buffer not holding the best row so far.
+   png_bytep best = out, next = trial;
+   best[0] = PNG_FILTER_VALUE_NONE;
+   png_uint_32 mins = png_filter_row(PNG_FILTER_VALUE_NONE, best + 1, in, above, (png_uint_32)rowbytes, bpp);
+   for(int type = PNG_FILTER_VALUE_SUB; type < PNG_FILTER_VALUE_LAST; type++)
+     {
+	png_uint_32 sum = png_filter_row(type, next + 1, in, above, (png_uint_32)rowbytes, bpp);
+	if(sum < mins)
+	  {
+	     mins = sum;
+	     next[0] = (png_byte)type;
+	     png_bytep swap = best;
+	     best = next;
+	     next = swap;
+	  }
+     }
+   if(best != out)
+     {
+	memcpy(out, best, rowbytes + 1);
+     }
+}
+
+// Lets write_parallel() wait for the bands to be done, in any order.
+struct encode_queue
+{
+   Mutex mutex;
+   Condition done;
+};
+
+// One horizontal band of the image, filtered and deflated on its own by deflate_band().
+struct encode_band
+{
+   int dictrow;                        // First row filtered again only to prime the dictionary.
+   int firstrow;
+   int endrow;
+   bool last;                          // Ends the zlib stream, with Z_FINISH rather than Z_SYNC_FLUSH.
+   int level;
+   int windowbits;
+   int memlevel;
+   int strategy;
+   volatile long * rowsdone;           // Shared by all the bands, for the progress reports.
+
+   std::vector<png_byte> data;         // Raw deflate data, ends on a byte boundary.
+   uLong adler;                        // Adler-32 of the filtered rows of the band alone.
+   uLong length;                       // Bytes of filtered rows.
+   bool ok;
+   encode_queue * queue;
+   bool finished;                      // Set under queue->mutex once the fields above are final.
+};
+
+// Runs MyPngWriter::deflate_band() on a thread of the pool.
+class DeflateBandTask : public Task
+{
+public:
+   DeflateBandTask(MyPngWriter * writer, encode_band * band) : writer_(writer), band_(band) {}
+   void Run()
+   {
+      writer_->deflate_band(*band_);
+
+      ScopedLock lock(band_->queue->mutex);
+      band_->finished = true;
+      band_->queue->done.Broadcast();
+   }
+
+private:
+   MyPngWriter * writer_;
+   encode_band * band_;
+};
+
+void MyPngWriter::deflate_band(encode_band & band)
+{
+   band.ok = false;
+   if((control_ != NULL)&&(control_->IsCancelled()))
+     {
+	return;
+     }
+
+   size_t rowbytes = 4*(size_t)width_;
+   size_t filteredbytes = rowbytes + 1;
+   size_t window = (size_t)1 << band.windowbits;
+   int from = band.dictrow;
+
+   std::vector<png_byte> filtered((size_t)(band.endrow - from)*filteredbytes);
+   std::vector<png_byte> scratch(2*rowbytes), zeros(rowbytes, 0), trial(filteredbytes);
+   const png_byte * prev = (from > 0) ? encode_row(from-1, &scratch[((from-1)&1)*rowbytes]) : &zeros[0];
+   for(int y = from; y < band.endrow; y++)
+     {
+	// Alternate between the two scratch rows, so prev stays valid.
+	const png_byte * row = encode_row(y, &scratch[(y&1)*rowbytes]);
+	filter_row(filterstrategy_, prev, row, rowbytes, &filtered[(size_t)(y - from)*filteredbytes], &trial[0]);
+	prev = row;
+     }
+
+   size_t dictbytes = (size_t)(band.firstrow - from)*filteredbytes;
+   png_bytep input = &filtered[0] + dictbytes;
+   band.length = (uLong)(filtered.size() - dictbytes);
+   band.adler = adler32(adler32(0L, Z_NULL, 0), input, (uInt)band.length);
+
+   z_stream zs;
+   memset(&zs, 0, sizeof(zs));
+   if(deflateInit2(&zs, band.level, Z_DEFLATED, -band.windowbits, band.memlevel, band.strategy) != Z_OK)
+     {
+	return;
+     }
+   if(dictbytes > 0)
+     {
+	size_t size = (dictbytes < window) ? dictbytes : window;
+	deflateSetDictionary(&zs, input - size, (uInt)size);
+     }
+
+   int flush = band.last ? Z_FINISH : Z_SYNC_FLUSH;
+   int err;
+   band.data.resize(deflateBound(&zs, band.length) + 16);
+   zs.next_in = input;
+   zs.avail_in = (uInt)band.length;
+   for(;;)
+     {
+	zs.next_out = &band.data[0] + zs.total_out;
+	zs.avail_out = (uInt)(band.data.size() - zs.total_out);
+	err = deflate(&zs, flush);
+	// A sync flush is complete once there is room left, Z_FINISH once the stream has ended.
+	if((err != Z_OK)||((flush == Z_SYNC_FLUSH)&&(zs.avail_out > 0)))
+	  {
+	     break;
+	  }
+	band.data.resize(2*band.data.size());
+     }
+   // Only what was written is kept, not the room deflateBound() asked for.
+   std::vector<png_byte>(band.data.begin(), band.data.begin() + zs.total_out).swap(band.data);
+   band.ok = (flush == Z_FINISH) ? (err == Z_STREAM_END) : (err == Z_OK);
+   deflateEnd(&zs);
+
+   if(control_ != NULL)
+     {
+	long done = AtomicAdd(band.rowsdone, band.endrow - band.firstrow);
+	control_->Report(STAGE_ENCODE, (int)done, height_);
+     }
+}
+
+// The mode flag png_write_end() checks, png.h only defines it for libpng itself.
+#ifndef PNG_HAVE_IDAT
+#define PNG_HAVE_IDAT 0x04
+#endif
+
+// Writes the IDAT chunk filled so far in chunk, if any, and empties it.
+static void flush_idat(png_structp png_ptr, std::vector<png_byte> & chunk)
+{
+   static png_byte idat[5] = { 73,  68,  65,  84, '\0'};
+
+   if(!chunk.empty())
+     {
+	png_write_chunk(png_ptr, idat, &chunk[0], chunk.size());
+	chunk.clear();
+     }
+}
+
+// Appends len bytes of zlib stream to the IDAT chunk being filled in chunk, and writes it out each time it
+// reaches size bytes.
+static void append_idat(png_structp png_ptr, std::vector<png_byte> & chunk, size_t size, const png_byte * data, size_t len)
+{
+   while(len > 0)
+     {
+	size_t count = size - chunk.size();
+	if(count > len)
+	  {
+	     count = len;
+	  }
+	chunk.insert(chunk.end(), data, data + count);
+	data += count;
+	len -= count;
+
+	if(chunk.size() == size)
+	  {
+	     flush_idat(png_ptr, chunk);
+	  }
+     }
+}
+
+// Filters and deflates bands of PNGWRITER_DEFLATE_BAND_BYTES on threads threads and stitches them into one
+// zlib stream written as IDAT chunks, in place of png_write_row(). Every band but the last ends with a sync
+// flush, so they can follow each other, and their Adler-32 are combined into the stream's. Only
+// PNGWRITER_BANDS_PER_THREAD bands a thread are in flight, each written out as soon as the ones above it
+// are, and with releaseonclose_ the rows of tiles no band still to come reads are freed on the way.
+// Returns false if it was cancelled or a band failed.
+bool MyPngWriter::write_parallel(png_structp png_ptr, int threads)
+{
+   size_t filteredbytes = 4*(size_t)width_ + 1;
+   int bandrows = (int)(PNGWRITER_DEFLATE_BAND_BYTES/filteredbytes);
+   if(bandrows < 1)
+     {
+	bandrows = 1;
+     }
+   int count = (height_ + bandrows - 1)/bandrows;
+   int level = (png_ptr->zlib_level == Z_DEFAULT_COMPRESSION) ? 6 : png_ptr->zlib_level;
+   volatile long rowsdone = 0;
+
+   // The rows of the band above that fill the window are filtered again, the same way, as the dictionary.
+   size_t window = (size_t)1 << png_ptr->zlib_window_bits;
+   int dictrows = (int)((window + filteredbytes - 1)/filteredbytes);
+
+   encode_queue queue;
+   std::vector<encode_band> bands(count);
+   std::vector<DeflateBandTask> tasks;
+   for(int b = 0; b < count; b++)
+     {
+	encode_band & band = bands[b];
+	band.firstrow = b*bandrows;
+	band.dictrow = (band.firstrow > dictrows) ? band.firstrow - dictrows : 0;
+	band.endrow = (b == count-1) ? height_ : (b+1)*bandrows;
+	band.last = (b == count-1);
+	band.level = level;
+	band.windowbits = png_ptr->zlib_window_bits;
+	band.memlevel = png_ptr->zlib_mem_level;
+	band.strategy = png_ptr->zlib_strategy;
+	band.rowsdone = &rowsdone;
+	band.ok = false;
+	band.queue = &queue;
+	band.finished = false;
+	tasks.push_back(DeflateBandTask(this, &band));
+     }
+
+   // The zlib header, as deflate() writes it for these settings.
+   int flags = (level < 2) ? 0 : (level < 6) ? 1 : (level == 6) ? 2 : 3;
+   unsigned int header = ((Z_DEFLATED + ((png_ptr->zlib_window_bits - 8) << 4)) << 8) | (flags << 6);
+   header += 31 - header%31;
+   png_byte head[2] = { (png_byte)(header >> 8), (png_byte)header };
+
+   std::vector<png_byte> chunk;
+   size_t size = png_ptr->zbuf_size;
+   chunk.reserve(size);
+   append_idat(png_ptr, chunk, size, head, sizeof(head));
+
+   ThreadPool pool(threads);
+   int inflight = PNGWRITER_BANDS_PER_THREAD*pool.GetThreadCount();
+   int submitted = 0, freedrows = 0;
+   uLong adler = 0;
+   bool ok = true;
+   for(int b = 0; (b < count) && ok; b++)
+     {
+	for(; (submitted < count) && (submitted < b + inflight); submitted++)
+	  {
+	     pool.Submit(&tasks[submitted]);
+	  }
+
+	  {
+	     ScopedLock lock(queue.mutex);
+	     while(!bands[b].finished)
+	       {
+		  queue.done.Wait(queue.mutex);
+	       }
+	  }
+
+	if((control_ != NULL)&&(control_->IsCancelled()))
+	  {
+	     ok = false;
+	     break;
+	  }
+	if(!bands[b].ok)
+	  {
+	     std::cerr << " MyPngWriter::close - ERROR **: Not able to compress the image." << std::endl;
+	     ok = false;
+	     break;
+	  }
+
+	adler = (b == 0) ? bands[b].adler : adler32_combine(adler, bands[b].adler, bands[b].length);
+	if(!bands[b].data.empty())
+	  {
+	     append_idat(png_ptr, chunk, size, &bands[b].data[0], bands[b].data.size());
+	  }
+	std::vector<png_byte>().swap(bands[b].data);
+
+	if(releaseonclose_ && (tiles_ != NULL))
+	  {
+	     // The bands still to come read from the row above the dictionary rows of the next one down.
+	     int needed = (b == count-1) ? height_ : (bands[b+1].dictrow > 0) ? bands[b+1].dictrow - 1 : 0;
+	     int unused = (b == count-1) ? tilesy_ : needed/tilesize_;
+	     for(; freedrows < unused; freedrows++)
+	       {
+		  unsigned char * * tilerow = tiles_ + (size_t)freedrows*tilesx_;
+		  for(int tx = 0; tx < tilesx_; tx++)
+		    {
+		       free(tilerow[tx]);
+		       tilerow[tx] = NULL;
+		    }
+	       }
+	  }
+     }
+
+   // The tasks still queued point into bands, they end quickly once cancelled.
+   pool.Wait();
+   if(!ok)
+     {
+	return false;
+     }
+
+   png_byte tail[4] = { (png_byte)(adler >> 24), (png_byte)(adler >> 16), (png_byte)(adler >> 8), (png_byte)adler };
+   append_idat(png_ptr, chunk, size, tail, sizeof(tail));
+   flush_idat(png_ptr, chunk);
+
+   png_ptr->mode |= PNG_HAVE_IDAT;
+   return true;
+}
+
+// Drops the file being streamed without finishing it.
+void MyPngWriter::abandon_stream(void)
+{
+   if(stream_png_ != NULL)
+     {
+	png_destroy_write_struct(&stream_png_, &stream_info_);
+	fclose(stream_fp_);
+	stream_png_ = NULL;
+	stream_info_ = NULL;
+	stream_fp_ = NULL;
+     }
+   bandtop_ = height_;
+}
+
+///////////////////////////////////////////////////////
+void MyPngWriter::flushband()
+{
+   if((bandheight_ <= 0)||(bandtop_ >= height_))
+     {
+	return;
+     }
+
+   if(stream_png_ == NULL)
+     {
+	if(!open_for_write(&stream_fp_, &stream_png_, &stream_info_, PNG_COLOR_TYPE_RGBA))
+	  {
+	     // Nothing can be written, skip the rest of the image.
+	     bandtop_ = height_;
+	     return;
+	  }
+     }
+
+   int count = height_ - bandtop_;
+   if(count > rows_)
+     {
+	count = rows_;
+     }
+   for(int r = 0; r < count; r++)
+     {
+	png_write_row(stream_png_, pixels_ + (size_t)r*stride_);
+     }
+
+   fill_rows();
+   bandtop_ += rows_;
+
+   if(control_ != NULL)
+     {
+	control_->Report(STAGE_ENCODE, (bandtop_ < height_) ? bandtop_ : height_, height_);
+     }
+}
+
+int MyPngWriter::getbandtop(void)
+{
+   return bandtop_;
+}
+
+void MyPngWriter::setcontrol(const BuildControl * control)
+{
+   control_ = control;
+}
+
+void MyPngWriter::setreleaseonclose(bool release)
+{
+   releaseonclose_ = release;
+}
+
+void MyPngWriter::setencodethreads(int threads)
+{
+   encodethreads_ = (threads < 0) ? 0 : threads;
+}
+
+void MyPngWriter::setfilterstrategy(int strategy)
+{
+   if((strategy < PNGWRITER_FILTER_NONE)||(strategy > PNGWRITER_FILTER_ADAPTIVE))
+     {
+	std::cerr << " MyPngWriter::setfilterstrategy - ERROR **: Unknown filter strategy " << strategy << ", using adaptive filtering." << std::endl;
+	strategy = PNGWRITER_FILTER_ADAPTIVE;
+     }
+   filterstrategy_ = strategy;
+}
+
 ////////////////Reading routines/////////////////////
 /////////////////////////////////////////////////
 
+// What a thread reads PNG files with, kept from one file to the next: the file it is decoding, mapped into
+// memory or read into a buffer when it is small, how far libpng has read into it, and an arena everything
+// libpng allocates comes from, zlib's inflate state and window included. The arena is reset when the next
+// file is opened, so decoding a sprite costs no trip to the heap once the first ones have been read.
+struct png_input
+{
+   png_input() : file(PNGWRITER_MAP_FILE_BYTES), pos(0), arena(PNGWRITER_DECODE_ARENA_BYTES) {}
+
+   MappedFile file;
+   size_t pos;
+   MemoryArena arena;
+};
+
+static void delete_input(void * in)
+{
+   delete (png_input *)in;
+}
+
+static ThreadLocal thread_inputs(delete_input);
+
+static png_input & thread_input(void)
+{
+   png_input * in = (png_input *)thread_inputs.Get();
+   if(in == NULL)
+     {
+	in = new png_input;
+	thread_inputs.Set(in);
+     }
+   return *in;
+}
+
+// Closes the file of a png_input however readfromfile() returns.
+class png_input_closer
+{
+public:
+   explicit png_input_closer(png_input & in) : in_(in) {}
+   ~png_input_closer() { in_.file.Close(); }
+private:
+   png_input & in_;
+};
+
+static png_voidp arena_malloc(png_structp png_ptr, png_size_t size)
+{
+   return ((MemoryArena *)png_get_mem_ptr(png_ptr))->Allocate(size);
+}
+
+// The memory goes back all at once with MemoryArena::Reset().
+static void arena_free(png_structp /*png_ptr*/, png_voidp /*ptr*/)
+{
+}
+
+// libpng's read function, copying from the file in memory where png_init_io() would fread() from a FILE.
+static void PNGAPI read_mapped(png_structp png_ptr, png_bytep data, png_size_t length)
+{
+   png_input * in = (png_input *)png_get_io_ptr(png_ptr);
+
+   if(length > in->file.GetSize() - in->pos)
+     {
+	png_error(png_ptr, "Read Error");
+     }
+   memcpy(data, in->file.GetData() + in->pos, length);
+   in->pos += length;
+}
+
 // Modified with Mikkel's patch
-void MyPngWriter::readfromfile(char * name)
+bool MyPngWriter::readfromfile(char * name)
 {
-   png_FILE_p      fp;
+   PROFILE_SCOPE("MyPngWriter::readfromfile");
+
+   png_input &     in = thread_input();
    png_structp     png_ptr;
    png_infop       info_ptr;
-   unsigned char   **image;
+   unsigned char   *image;
+   size_t          stride;
    unsigned long   width, height;
    int bit_depth, color_type, interlace_type;
    //   png_uint_32     i;
    //
-   fp = fopen(name,"rb");
-   if (fp==NULL)
+   png_input_closer closer(in);
+   if (!in.file.Open(name, map_files_))
      {
 	std::cerr << " MyPngWriter::readfromfile - ERROR **: Error opening file \"" << std::flush;
 	std::cerr << name <<std::flush;
 	std::cerr << "\"." << std::endl << std::flush;
 	perror(" MyPngWriter::readfromfile - ERROR **");
-	return;
+	return false;
      }
 
-   if(!check_if_png(name, &fp))
+   if(!check_if_png(name, in))
      {
 	std::cerr << " MyPngWriter::readfromfile - ERROR **: Error opening file " << name << ". This may not be a valid png file. (check_if_png() failed)." << std::endl;
-	// fp has been closed already if check_if_png() fails.
-	return;
+	return false;
      }
 
 //   Code as it was before Sven's patch
@@ -488,12 +1337,11 @@ void MyPngWriter::readfromfile(char * name)
    // Mikkel's patch starts here
    // ///////////////////////////////////
    
-   if(!read_png_info(fp, &png_ptr, &info_ptr)) 
+   if(!read_png_info(in, &png_ptr, &info_ptr)) 
      {
 	 
 	std::cerr << " MyPngWriter::readfromfile - ERROR **: Error opening file " << name << ". read_png_info() failed." << std::endl; 
-	// fp has been closed already if read_png_info() fails. 
-	  return; 
+	  return false; 
      } 
    
    //Input transformations  
@@ -531,6 +1379,25 @@ void MyPngWriter::readfromfile(char * name)
 	png_set_gray_to_rgb(png_ptr); 
 	transformation_ = 1; 
      } 
+
+   // Everything else works on 8 bits RGBA, four bytes a pixel: a tRNS chunk becomes the alpha channel,
+   // images without one are made opaque and 16 bits samples are cut down to 8.
+   if(png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+     {
+	png_set_tRNS_to_alpha(png_ptr);
+	transformation_ = 1;
+     }
+   else if(!(color_type & PNG_COLOR_MASK_ALPHA))
+     {
+	png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+	transformation_ = 1;
+     }
+
+   if(bit_depth == 16)
+     {
+	png_set_strip_16(png_ptr);
+	transformation_ = 1;
+     }
 	 
 	 // If any of the above were applied,
    if(transformation_) 
@@ -550,11 +1417,10 @@ void MyPngWriter::readfromfile(char * name)
 	colortype_ = color_type; 
      } 
    
-   if(!read_png_image(fp, png_ptr, info_ptr, &image, &width, &height)) 
+   if(!read_png_image(in, png_ptr, info_ptr, &image, &stride, &width, &height)) 
      { 
 	std::cerr << " MyPngWriter::readfromfile - ERROR **: Error opening file " << name << ". read_png_image() failed." << std::endl; 
-	// fp has been closed already if read_png_image() fails. 
-	return; 
+	return false; 
      } 
    
    //stuff should now be in image[][].
@@ -565,21 +1431,30 @@ void MyPngWriter::readfromfile(char * name)
    if( image == NULL)
      {
 	std::cerr << " MyPngWriter::readfromfile - ERROR **: Error opening file " << name << ". Can't assign memory (after read_png_image(), image is NULL)." << std::endl;
-	fclose(fp);
-	return;
+	return false;
      }
 
-   //First we must get rid of the image already there, and free the memory.
-   int jjj;
-   for (jjj = 0; jjj < height_; jjj++) free(graph_[jjj]);
-   free(graph_);
+   //First we must get rid of the image already there, and free the memory, unless it was read into it.
+   if(image != pixels_)
+     {
+	FreeAligned(pixels_);
+	pixelsbytes_ = (size_t)height * stride;
+     }
+   free_tiles();
+   free(tiles_);
+   tiles_ = NULL;
+   tilesize_ = 0;
 
    //Must reassign the new size of the read image
    width_ = width;
    height_ = height;
+   rows_ = height_;
+   bandheight_ = 0;
+   bandtop_ = 0;
 
    //Graph now is the image.
-   graph_ = image;
+   pixels_ = image;
+   stride_ = stride;
 
    rowbytes_ = png_get_rowbytes(png_ptr, info_ptr);
 
@@ -669,58 +1544,47 @@ aliases
 
    filegamma_ = file_gamma;
 
-   fclose(fp);
+   PROFILE_COUNT(COUNTER_BYTES_READ, in.file.GetSize());
+   return true;
 }
 
 ///////////////////////////////////////////////////////
 
-void MyPngWriter::readfromfile(const char * name)
+bool MyPngWriter::readfromfile(const char * name)
 {
-   this->readfromfile((char *)(name));
+   return this->readfromfile((char *)(name));
 }
 
 /////////////////////////////////////////////////////////
-int MyPngWriter::check_if_png(char *file_name, png_FILE_p *fp)
+int MyPngWriter::check_if_png(char *file_name, png_input & in)
 {
-   char    sig[PNG_BYTES_TO_CHECK];
-
-   if ( /*(*fp = fopen(file_name, "rb")) */  *fp == NULL) // Fixed 10 10 04
-     {
-	//   exit(EXIT_FAILURE);
-	std::cerr << " MyPngWriter::check_if_png - ERROR **: Could not open file  " << file_name << " to read." << std::endl;
-	perror(" MyPngWriter::check_if_png - ERROR **");
-	return 0;
-     }
-
-   if (fread(sig, 1, PNG_BYTES_TO_CHECK, *fp) != PNG_BYTES_TO_CHECK)
+   if (in.file.GetSize() < PNG_BYTES_TO_CHECK)
      {
 	//exit(EXIT_FAILURE);
 	std::cerr << " MyPngWriter::check_if_png - ERROR **: File " << file_name << " does not appear to be a valid PNG file." << std::endl;
-	perror(" MyPngWriter::check_if_png - ERROR **");
-	fclose(*fp);
 	return 0;
      }
    
-   if (png_sig_cmp( (png_bytep) sig, (png_size_t)0, PNG_BYTES_TO_CHECK) /*png_check_sig((png_bytep) sig, PNG_BYTES_TO_CHECK)*/ ) 
+   if (png_sig_cmp( (png_bytep) in.file.GetData(), (png_size_t)0, PNG_BYTES_TO_CHECK) /*png_check_sig((png_bytep) sig, PNG_BYTES_TO_CHECK)*/ ) 
      {
 	std::cerr << " MyPngWriter::check_if_png - ERROR **: File " << file_name << " does not appear to be a valid PNG file. png_check_sig() failed." << std::endl;
-	fclose(*fp);
 	return 0;
      }
-   
-   
+   in.pos = PNG_BYTES_TO_CHECK;
    
    return 1; //Success
 }
 
 ///////////////////////////////////////////////////////
-int MyPngWriter::read_png_info(png_FILE_p fp, png_structp *png_ptr, png_infop *info_ptr)
+int MyPngWriter::read_png_info(png_input & in, png_structp *png_ptr, png_infop *info_ptr)
 {
-   *png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+   // Nothing of the file read before is in use any more.
+   in.arena.Reset();
+
+   *png_ptr = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL, &in.arena, arena_malloc, arena_free);
    if (*png_ptr == NULL)
      {
 	std::cerr << " MyPngWriter::read_png_info - ERROR **: Could not create read_struct." << std::endl;
-	fclose(fp);
 	return 0;
 	//exit(EXIT_FAILURE);
      }
@@ -730,29 +1594,108 @@ int MyPngWriter::read_png_info(png_FILE_p fp, png_structp *png_ptr, png_infop *i
 	png_destroy_read_struct(png_ptr, (png_infopp)NULL, (png_infopp)NULL);
 	std::cerr << " MyPngWriter::read_png_info - ERROR **: Could not create info_struct." << std::endl;
 	//exit(EXIT_FAILURE);
-	fclose(fp);
 	return 0;
      }
    if (setjmp((*png_ptr)->jmpbuf)) /*(setjmp(png_jmpbuf(*png_ptr)) )*//////////////////////////////////////
      {
 	png_destroy_read_struct(png_ptr, info_ptr, (png_infopp)NULL);
 	std::cerr << " MyPngWriter::read_png_info - ERROR **: This file may be a corrupted PNG file. (setjmp(*png_ptr)->jmpbf) failed)." << std::endl;
-	fclose(fp);
 	return 0;
 	//exit(EXIT_FAILURE);
      }
-   png_init_io(*png_ptr, fp);
+   png_set_read_fn(*png_ptr, &in, read_mapped);
    png_set_sig_bytes(*png_ptr, PNG_BYTES_TO_CHECK);
+   if (!crc_check_)
+     {
+	png_set_crc_action(*png_ptr, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+     }
    png_read_info(*png_ptr, *info_ptr);
 
    return 1;
 }
 
 ////////////////////////////////////////////////////////////
-int MyPngWriter::read_png_image(png_FILE_p fp, png_structp png_ptr, png_infop info_ptr,
-			      png_bytepp *image, png_uint_32 *width, png_uint_32 *height)
+void MyPngWriter::setcrccheck(bool check)
 {
-   unsigned int i,j;
+   crc_check_ = check;
+}
+
+void MyPngWriter::setmapfiles(bool map)
+{
+   map_files_ = map;
+}
+
+// Joins up the zlib stream of the image in file, size bytes starting with the first of its IDAT chunks,
+// copying the data of the chunks one after the other into out unless it is NULL. Returns its length, or 0
+// when the file ends inside a chunk or, with check_crc, a chunk has a bad CRC, leaving libpng to report it.
+static size_t join_idat(const png_byte * file, size_t size, png_byte * out, bool check_crc)
+{
+   static const png_byte name[4] = { 73,  68,  65,  84};
+   size_t pos = 0, len = 0;
+
+   while(size - pos >= 12 && memcmp(file + pos + 4, name, 4) == 0)
+     {
+	size_t length = png_get_uint_32((png_bytep)file + pos);
+	if(length > PNG_UINT_31_MAX || length > size - pos - 12)
+	  {
+	     return 0;
+	  }
+	if(check_crc && crc32(0, file + pos + 4, (uInt)length + 4) != png_get_uint_32((png_bytep)file + pos + 8 + length))
+	  {
+	     return 0;
+	  }
+	if(out != NULL)
+	  {
+	     memcpy(out + len, file + pos + 8, length);
+	  }
+	len += length;
+	pos += 12 + length;
+     }
+
+   return len;
+}
+
+// Decodes the image from the rest of the file in memory, where png_read_info() left in the first IDAT chunk,
+// with png_read_image_whole(), up to PNGWRITER_WHOLE_READ_BYTES of filtered rows. The data of a single IDAT
+// chunk is inflated where it is, several are joined up first. Nothing has been read when this returns false.
+static bool read_image_whole(const png_input & in, png_structp png_ptr, unsigned char * image, size_t stride, bool check_crc)
+{
+   if((size_t)png_ptr->height * (png_ptr->rowbytes + 1) > PNGWRITER_WHOLE_READ_BYTES)
+     {
+	return false;
+     }
+
+   if(in.pos < 8)
+     {
+	return false;
+     }
+
+   const png_byte * file = in.file.GetData() + in.pos - 8;
+   size_t size = in.file.GetSize() - in.pos + 8, len;
+   if(size < 12 || png_get_uint_32((png_bytep)file) != png_ptr->idat_size ||
+      (len = join_idat(file, size, NULL, check_crc)) == 0)
+     {
+	return false;
+     }
+
+   if(len == png_ptr->idat_size)
+     {
+	return png_read_image_whole(png_ptr, image, stride, (png_bytep)file + 8, len) != 0;
+     }
+
+   png_bytep data = (png_bytep)png_malloc_warn(png_ptr, (png_uint_32)len);
+   bool done = data != NULL && join_idat(file, size, data, false) == len &&
+	       png_read_image_whole(png_ptr, image, stride, data, len);
+   png_free(png_ptr, data);
+   return done;
+}
+
+////////////////////////////////////////////////////////////
+int MyPngWriter::read_png_image(png_input & in, png_structp png_ptr, png_infop info_ptr,
+			      unsigned char **image, size_t *stride, png_uint_32 *width, png_uint_32 *height)
+{
+   unsigned int i;
+   int pass;
 
    *width = png_get_image_width(png_ptr, info_ptr);
    *height = png_get_image_height(png_ptr, info_ptr);
@@ -760,38 +1703,45 @@ int MyPngWriter::read_png_image(png_FILE_p fp, png_structp png_ptr, png_infop in
    if( width == NULL)
      {
 	std::cerr << " MyPngWriter::read_png_image - ERROR **: png_get_image_width() returned NULL pointer." << std::endl;
-	fclose(fp);
 	return 0;
      }
 
    if( height == NULL)
      {
 	std::cerr << " MyPngWriter::read_png_image - ERROR **: png_get_image_height() returned NULL pointer." << std::endl;
-	fclose(fp);
 	return 0;
      }
 
-   if ((*image = (png_bytepp)malloc(*height * sizeof(png_bytep))) == NULL)
+   // One block for the whole image, the rows aligned the same way as in alloc_pixels(). The block of
+   // the image held so far is reused when the new one fits in it.
+   size_t rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+   *stride = (rowbytes + PNGWRITER_ROW_ALIGNMENT - 1) & ~(size_t)(PNGWRITER_ROW_ALIGNMENT - 1);
+   if (pixels_ != NULL && (size_t)*height * *stride <= pixelsbytes_)
+     {
+	*image = pixels_;
+     }
+   else if ((*image = (unsigned char *)AllocateAligned((size_t)*height * *stride, PNGWRITER_ROW_ALIGNMENT)) == NULL)
      {
 	std::cerr << " MyPngWriter::read_png_image - ERROR **: Could not allocate memory for reading image." << std::endl;
-	fclose(fp);
 	return 0;
 	//exit(EXIT_FAILURE);
      }
-   for (i = 0; i < *height; i++)
+
+   // What png_read_image() does, without needing an array of row pointers. A small image is inflated
+   // in one call when it can be, anything else row by row.
+   pass = png_set_interlace_handling(png_ptr);
+   png_ptr->num_rows = *height;
+   if (read_image_whole(in, png_ptr, *image, *stride, crc_check_))
+     {
+	return 1;
+     }
+   for (; pass > 0; pass--)
      {
-	(*image)[i] = (png_bytep)malloc(png_get_rowbytes(png_ptr, info_ptr));
-	if ((*image)[i] == NULL)
+	for (i = 0; i < *height; i++)
 	  {
-	     for (j = 0; j < i; j++) free((*image)[j]);
-	     free(*image);
-	     fclose(fp);
-	     std::cerr << " MyPngWriter::read_png_image - ERROR **: Could not allocate memory for reading image." << std::endl;
-	     return 0;
-	     //exit(EXIT_FAILURE);
+	     png_read_row(png_ptr, *image + (size_t)i * *stride, png_bytep_NULL);
 	  }
      }
-   png_read_image(png_ptr, *image);
 
    return 1;
 }
@@ -831,9 +1781,9 @@ void MyPngWriter::setgamma(double gamma)
 
 void MyPngWriter::setcompressionlevel(int level)
 {
-   if( (level < -1)||(level > 9) )
+   if( ((level < -1)||(level > 9)) && (level != PNGWRITER_COMPRESSION_QUICK) )
      {
-	std::cerr << " MyPngWriter::setcompressionlevel - ERROR **: Called with wrong compression level: should be -1 to 9, was: " << level << "." << std::endl;
+	std::cerr << " MyPngWriter::setcompressionlevel - ERROR **: Called with wrong compression level: should be -1 to 9 or PNGWRITER_COMPRESSION_QUICK, was: " << level << "." << std::endl;
      }
    compressionlevel_ = level;
 }
@@ -869,7 +1819,7 @@ void MyPngWriter::write_out_red_as_alpha()
     for (int kkkk = 0; kkkk < height_; kkkk++)
     {
         data[kkkk] = (png_bytep)malloc(width_ * sizeof(png_byte));
-        if(graph_[kkkk] == NULL)
+        if(data[kkkk] == NULL)
         {
             std::cerr << " MyPngWriter::MyPngWriter - ERROR **:  Not able to allocate memory for image." << std::endl;
         }
@@ -877,7 +1827,7 @@ void MyPngWriter::write_out_red_as_alpha()
 
     for (int i=0; i<height_; ++i)
         for (int j=0; j<width_; ++j)
-            data[i][j] = graph_[i][j*4];
+            data[i][j] = row_at(i)[j*4];
 
 
     png_FILE_p      fp;
@@ -895,14 +1845,8 @@ void MyPngWriter::write_out_red_as_alpha()
     png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     info_ptr = png_create_info_struct(png_ptr);
     png_init_io(png_ptr, fp);
-    if(compressionlevel_ != -2)
-    {
-        png_set_compression_level(png_ptr, compressionlevel_);
-    }
-    else
-    {
-        png_set_compression_level(png_ptr, PNGWRITER_DEFAULT_COMPRESSION);
-    }
+    set_compression(png_ptr, compressionlevel_);
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, filter_flags(filterstrategy_));
 
     png_set_IHDR(png_ptr, info_ptr, width_, height_,
         bit_depth_, PNG_COLOR_TYPE_GRAY, PNG_INTERLACE_NONE,
@@ -1,291 +1,461 @@
-//**********  MyPngWriter.h   **********************************************
-//  Author:                    Paul Blackburn
-//
-//  Email:                     individual61@users.sourceforge.net
-//
-//  Version:                   0.5.4   (19 / II / 2009)
-//
-//  Description:               Library that allows plotting a 48 bit
-//                             PNG image pixel by pixel, which can
-//                             then be opened with a graphics program.
-//
-//  License:                   GNU General Public License
-//                             Copyright 2002, 2003, 2004, 2005, 2006, 2007, 
-//                             2008, 2009 Paul Blackburn
-//
-//  Website: Main:             http://MyPngWriter.sourceforge.net/
-//           Sourceforge.net:  http://sourceforge.net/projects/MyPngWriter/
-//           Freshmeat.net:    http://freshmeat.net/projects/MyPngWriter/
-//
-//  Documentation:             The header file (MyPngWriter.h) is commented, but for a
-//                             quick reference document, and support,
-//                             take a look at the website.
-//
-//*************************************************************************
-
-/*
- *     This program is free software; you can redistribute it and/or modify
- *     it under the terms of the GNU General Public License as published by
- *     the Free Software Foundation; either version 2 of the License, or
- *     (at your option) any later version.
- *
- *     This program is distributed in the hope that it will be useful,
- *     but WITHOUT ANY WARRANTY; without even the implied warranty of
- *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *     GNU General Public License for more details.
- *
- *     You should have received a copy of the GNU General Public License
- *     along with this program; if not, write to the Free Software
- *     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
- *
+//**********  MyPngWriter.h   **********************************************
+//  Author:                    Paul Blackburn
+//
+//  Email:                     individual61@users.sourceforge.net
+//
+//  Version:                   0.5.4   (19 / II / 2009)
+//
+//  Description:               Library that allows plotting a 48 bit
+//                             PNG image pixel by pixel, which can
+//                             then be opened with a graphics program.
+//
+//  License:                   GNU General Public License
+//                             Copyright 2002, 2003, 2004, 2005, 2006, 2007, 
+//                             2008, 2009 Paul Blackburn
+//
+//  Website: Main:             http://MyPngWriter.sourceforge.net/
+//           Sourceforge.net:  http://sourceforge.net/projects/MyPngWriter/
+//           Freshmeat.net:    http://freshmeat.net/projects/MyPngWriter/
+//
+//  Documentation:             The header file (MyPngWriter.h) is commented, but for a
+//                             quick reference document, and support,
+//                             take a look at the website.
+//
+//*************************************************************************
+
+/*
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software
+ *     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
  * */
-#ifndef _MYPNGWRITER_H_
-#define _MYPNGWRITER_H_
-
-#include <png.h>
-
-#include <iostream>
-#include <cmath>
-#include <cwchar>
-#include <string>
-
-//png.h must be included before FreeType headers.
-#include <stdlib.h>
-#include <stdio.h>
-#include <setjmp.h>
-
-
-#define PNG_BYTES_TO_CHECK (4)
-#define PNGWRITER_DEFAULT_COMPRESSION (6)
-
-class MyPngWriter 
-{
- private:
-   
-   char * filename_;   
-   char * textauthor_;   
-   char * textdescription_;   
-   char * texttitle_;   
-   char * textsoftware_;   
-
-
-   
-   int height_;
-   int width_;
-   int  backgroundcolour_;
-   int bit_depth_;
-   int rowbytes_;
-   int colortype_;
-   int compressionlevel_;
-   bool transformation_; // Required by Mikkel's patch
-   
-   unsigned char * * graph_;
-   double filegamma_;
-   double screengamma_;
-   void circle_aux(int xcentre, int ycentre, int x, int y, int red, int green, int blue);
-   void circle_aux_blend(int xcentre, int ycentre, int x, int y, double opacity, int red, int green, int blue);
-   int check_if_png(char *file_name, png_FILE_p *fp);
-   int read_png_info(png_FILE_p fp, png_structp *png_ptr, png_infop *info_ptr);
-   int read_png_image(png_FILE_p fp, png_structp png_ptr, png_infop info_ptr,
- 		       png_bytepp *image, png_uint_32 *width, png_uint_32 *height);
-   void flood_fill_internal( int xstart, int ystart,  double start_red, double start_green, double start_blue, double fill_red, double fill_green, double fill_blue);
-   void flood_fill_internal_blend( int xstart, int ystart, double opacity,  double start_red, double start_green, double start_blue, double fill_red, double fill_green, double fill_blue);
-
-   
-   /* The algorithms HSVtoRGB and RGBtoHSV were found at http://www.cs.rit.edu/~ncs/
-    * which is a page that belongs to Nan C. Schaller, though
-    * these algorithms appear to be the work of Eugene Vishnevsky. 
-    * */
-   void HSVtoRGB( double *r, double *g, double *b, double h, double s, double v ); 
-   void RGBtoHSV( float r, float g, float b, float *h, float *s, float *v );
-
-   /* drwatop(), drawbottom() and filledtriangle() were contributed by Gurkan Sengun
-    * ( <gurkan@linuks.mine.nu>, http://www.linuks.mine.nu/ )
-    * */
-   void drawtop(long x1,long y1,long x2,long y2,long x3, int red, int green, int blue);
-   void drawbottom(long x1,long y1,long x2,long x3,long y3, int red, int green, int blue);
-   void drawbottom_blend(long x1,long y1,long x2,long x3,long y3, double opacity, int red, int green, int blue);
-   void drawtop_blend(long x1,long y1,long x2,long y2,long x3, double opacity, int red, int green, int blue);
-   
- public:
-
-   /* General Notes
-    * It is important to remember that all functions that accept an argument of type "const char *" will also
-    * accept "char *", this is done so you can have a changing filename (to make many PNG images in series 
-    * with a different name, for example), and to allow you to use string type objects which can be easily 
-    * turned into const char * (if theString is an object of type string, then it can be used as a const char *
-    * by saying theString.c_str()).
-    * It is also important to remember that whenever a function has a colour coeffiecient as its argument, 
-    * that argument can be either an int from 0 to 65535 or a double from 0.0 to 1.0. 
-    * It is important to make sure that you are calling the function with the type that you want.
-    * Remember that 1 is an int, while 1.0 is a double, and will thus determine what version of the function 
-    * will be used. Similarly, do not make the mistake of calling for example plot(x, y, 0.0, 0.0, 65535),
-    * because
-    * there is no plot(int, int, double, double, int).
-    * Also, please note that plot() and read() (and the functions that use them internally) 
-    * are protected against entering, for example, a colour coefficient that is over 65535
-    * or over 1.0. Similarly, they are protected against negative coefficients. read() will return 0
-    * when called outside the image range. This is actually useful as zero-padding should you need it.
-    * */
-
-   /* Compilation
-    * A typical compilation would look like this:
-    * 
-    * g++ my_program.cc -o my_program freetype-config --cflags \
-    *          -I/usr/local/include  -L/usr/local/lib -lpng -lpngwriter -lz -lfreetype
-    * 
-    * If you did not compile PNGwriter with FreeType support, then remove the
-    * FreeType-related flags and add -DNO_FREETYPE above.
-    * */
-   
-   /* Constructor
-    * The constructor requires the width and the height of the image, the background colour for the
-    * image and the filename of the file (a pointer or simple "myfile.png"). The background colour
-    * can only be initialized to a shade of grey (once the object has been created you can do whatever 
-    * you want, though), because generally one wants either a white (65535 or 1.0) or a black (0 or 0.0)
-    * background to start with.
-    * The default constructor creates a PNGwriter instance that is 250x250, white background,
-    * and filename "out.png".
-    * Tip: The filename can be given as easily as:
-    * pngwriter mypng(300, 300, 0.0, "myfile.png");    
-    * Tip: If you are going to create a PNGwriter instance for reading in a file that already exists, 
-    * then width and height can be 1 pixel, and the size will be automatically adjusted once you use
-    * readfromfile().
-    * */
-    MyPngWriter(int width, int height, int backgroundcolour, const char * filename);   
-
-   /* Destructor
-    * */
-   ~MyPngWriter();  
-
-   /* Assignment Operator
-    * */
-   MyPngWriter & operator = (const MyPngWriter & rhs);
-      
-   /*  Plot
-    * With this function a pixel at coordinates (x, y) can be set to the desired colour. 
-    * The pixels are numbered starting from (1, 1) and go to (width, height). 
-    * As with most functions in PNGwriter, it has been overloaded to accept either int arguments 
-    * for the colour coefficients, or those of type double. If they are of type int, 
-    * they go from 0 to 65535. If they are of type double, they go from 0.0 to 1.0.
-    * Tip: To plot using red, then specify plot(x, y, 1.0, 0.0, 0.0). To make pink, 
-    * just add a constant value to all three coefficients, like this:
-    * plot(x, y, 1.0, 0.4, 0.4). 
-    * Tip: If nothing is being plotted to your PNG file, make sure that you remember
-    * to close() the instance before your program is finished, and that the x and y position
-    * is actually within the bounds of your image. If either is not, then PNGwriter will 
-    * not complain-- it is up to you to check for this!
-    * Tip: If you try to plot with a colour coefficient out of range, a maximum or minimum
-    * coefficient will be assumed, according to the given coefficient. For example, attempting
-    * to plot plot(x, y, 1.0,-0.2,3.7) will set the green coefficient to 0 and the red coefficient
-    * to 1.0.
-    * */
-   void  plot(int x, int y, int red, int green, int blue, int alpha); 
-
+#ifndef _MYPNGWRITER_H_
+#define _MYPNGWRITER_H_
+
+#include <png.h>
+
+#include <iostream>
+#include <cmath>
+#include <cwchar>
+#include <string>
+
+//png.h must be included before FreeType headers.
+#include <stdlib.h>
+#include <stdio.h>
+#include <setjmp.h>
+#include "Progress.h"
+
+
+#define PNG_BYTES_TO_CHECK (4)
+#define PNGWRITER_DEFAULT_COMPRESSION (6)
+
+// setcompressionlevel() preset for iteration builds: level 1 with zlib's Z_QUICK strategy, which
+// trades file size for the fastest encode.
+#define PNGWRITER_COMPRESSION_QUICK (-3)
+
+// Alignment of the pixel buffer and of every row in it, a cache line.
+#define PNGWRITER_ROW_ALIGNMENT (64)
+
+// Largest filtered image data, filter type bytes included, that readfromfile() inflates in one call before
+// unfiltering it. Beyond what the cache holds the rows are read back from memory, and reading them one
+// at a time is faster.
+#define PNGWRITER_WHOLE_READ_BYTES (256*1024)
+
+// First block of the memory arena every thread decodes with, see readfromfile().
+#define PNGWRITER_DECODE_ARENA_BYTES (64*1024)
+
+// Smallest file readfromfile() maps into memory, smaller ones are read in one call into a buffer.
+#define PNGWRITER_MAP_FILE_BYTES (256*1024)
+
+// Bytes of filtered image data deflated as one band when close() encodes on several threads.
+#define PNGWRITER_DEFLATE_BAND_BYTES (1024*1024)
+
+// Bands close() keeps in flight for each encoding thread, deflated or waiting for the ones above to be written.
+#define PNGWRITER_BANDS_PER_THREAD 2
+
+// Filter strategies for setfilterstrategy().
+#define PNGWRITER_FILTER_NONE (0)
+#define PNGWRITER_FILTER_FIXED (1)
+#define PNGWRITER_FILTER_ADAPTIVE (2)
+
+// The filter every row gets with PNGWRITER_FILTER_FIXED.
+#define PNGWRITER_FIXED_FILTER PNG_FILTER_VALUE_UP
+
+// One pixel of an 8 bits RGBA image, as it is laid out in memory.
+struct rgba8
+{
+   png_byte r, g, b, a;
+};
+
+class MyPngWriter 
+{
+ private:
+   
+   char * filename_;   
+   char * textauthor_;   
+   char * textdescription_;   
+   char * texttitle_;   
+   char * textsoftware_;   
+
+
+   
+   int height_;
+   int width_;
+   int  backgroundcolour_;
+   int bit_depth_;
+   int rowbytes_;
+   int colortype_;
+   int compressionlevel_;
+   int encodethreads_;   // Threads close() filters and deflates the image on, 0 for one per core.
+   int filterstrategy_;  // One of the PNGWRITER_FILTER_ values.
+   bool transformation_; // Required by Mikkel's patch
+   
+   unsigned char * pixels_;  // rows_ rows of stride_ bytes in one block, each row PNGWRITER_ROW_ALIGNMENT aligned.
+   size_t pixelsbytes_;      // Size of the block, readfromfile() decodes into it again when the image fits.
+   size_t stride_;
+   int rows_;            // Number of rows held in pixels_.
+   int bandheight_;      // Rows kept in memory when streaming in bands, 0 keeps the whole image.
+   int bandtop_;         // Image row held in the first row of pixels_ while streaming in bands.
+   int tilesize_;        // Side of the square tiles of a tiled image, 0 if the image is held in rows.
+   int tilesx_;
+   int tilesy_;
+   unsigned char * * tiles_;  // tilesx_*tilesy_ tiles row by row, NULL where nothing was plotted yet.
+   bool releaseonclose_;      // close() frees the tiles once written, see setreleaseonclose().
+   png_FILE_p stream_fp_;
+   png_structp stream_png_;
+   png_infop stream_info_;
+   const BuildControl * control_;  // Told about the rows encoded, and asked whether to stop. May be NULL.
+   double filegamma_;
+   double screengamma_;
+   static bool crc_check_;   // See setcrccheck().
+   static bool map_files_;   // See setmapfiles().
+   void circle_aux(int xcentre, int ycentre, int x, int y, int red, int green, int blue);
+   void circle_aux_blend(int xcentre, int ycentre, int x, int y, double opacity, int red, int green, int blue);
+   void init(int width, int height, int backgroundcolour, const char * filename, int bandheight, int tilesize);
+   unsigned char * row_at(int y);
+   unsigned char * pixel_at(int x, int y, bool allocate);
+   int run_at(int x, int len);
+   bool alloc_pixels(int rows, size_t rowbytes);
+   void free_tiles(void);
+   bool write_tiles(png_structp png_ptr);
+   const unsigned char * encode_row(int y, unsigned char * scratch);
+   void deflate_band(struct encode_band & band);
+   bool write_parallel(png_structp png_ptr, int threads);
+   friend class DeflateBandTask;
+   void abandon_stream(void);
+   void fill_rows(void);
+   int open_for_write(png_FILE_p *fp, png_structp *png_ptr, png_infop *info_ptr, int colortype);
+   int check_if_png(char *file_name, struct png_input & in);
+   int read_png_info(struct png_input & in, png_structp *png_ptr, png_infop *info_ptr);
+   int read_png_image(struct png_input & in, png_structp png_ptr, png_infop info_ptr,
+ 		       unsigned char **image, size_t *stride, png_uint_32 *width, png_uint_32 *height);
+   void flood_fill_internal( int xstart, int ystart,  double start_red, double start_green, double start_blue, double fill_red, double fill_green, double fill_blue);
+   void flood_fill_internal_blend( int xstart, int ystart, double opacity,  double start_red, double start_green, double start_blue, double fill_red, double fill_green, double fill_blue);
+
+   
+   /* The algorithms HSVtoRGB and RGBtoHSV were found at http://www.cs.rit.edu/~ncs/
+    * which is a page that belongs to Nan C. Schaller, though
+    * these algorithms appear to be the work of Eugene Vishnevsky. 
+    * */
+   void HSVtoRGB( double *r, double *g, double *b, double h, double s, double v ); 
+   void RGBtoHSV( float r, float g, float b, float *h, float *s, float *v );
+
+   /* drwatop(), drawbottom() and filledtriangle() were contributed by Gurkan Sengun
+    * ( <gurkan@linuks.mine.nu>, http://www.linuks.mine.nu/ )
+    * */
+   void drawtop(long x1,long y1,long x2,long y2,long x3, int red, int green, int blue);
+   void drawbottom(long x1,long y1,long x2,long x3,long y3, int red, int green, int blue);
+   void drawbottom_blend(long x1,long y1,long x2,long x3,long y3, double opacity, int red, int green, int blue);
+   void drawtop_blend(long x1,long y1,long x2,long y2,long x3, double opacity, int red, int green, int blue);
+   
+ public:
+
+   /* General Notes
+    * It is important to remember that all functions that accept an argument of type "const char *" will also
+    * accept "char *", this is done so you can have a changing filename (to make many PNG images in series 
+    * with a different name, for example), and to allow you to use string type objects which can be easily 
+    * turned into const char * (if theString is an object of type string, then it can be used as a const char *
+    * by saying theString.c_str()).
+    * It is also important to remember that whenever a function has a colour coeffiecient as its argument, 
+    * that argument can be either an int from 0 to 65535 or a double from 0.0 to 1.0. 
+    * It is important to make sure that you are calling the function with the type that you want.
+    * Remember that 1 is an int, while 1.0 is a double, and will thus determine what version of the function 
+    * will be used. Similarly, do not make the mistake of calling for example plot(x, y, 0.0, 0.0, 65535),
+    * because
+    * there is no plot(int, int, double, double, int).
+    * Also, please note that plot() and read() (and the functions that use them internally) 
+    * are protected against entering, for example, a colour coefficient that is over 65535
+    * or over 1.0. Similarly, they are protected against negative coefficients. read() will return 0
+    * when called outside the image range. This is actually useful as zero-padding should you need it.
+    * */
+
+   /* Compilation
+    * A typical compilation would look like this:
+    * 
+    * g++ my_program.cc -o my_program freetype-config --cflags \
+    *          -I/usr/local/include  -L/usr/local/lib -lpng -lpngwriter -lz -lfreetype
+    * 
+    * If you did not compile PNGwriter with FreeType support, then remove the
+    * FreeType-related flags and add -DNO_FREETYPE above.
+    * */
+   
+   /* Constructor
+    * The constructor requires the width and the height of the image, the background colour for the
+    * image and the filename of the file (a pointer or simple "myfile.png"). The background colour
+    * can only be initialized to a shade of grey (once the object has been created you can do whatever 
+    * you want, though), because generally one wants either a white (65535 or 1.0) or a black (0 or 0.0)
+    * background to start with.
+    * The default constructor creates a PNGwriter instance that is 250x250, white background,
+    * and filename "out.png".
+    * Tip: The filename can be given as easily as:
+    * pngwriter mypng(300, 300, 0.0, "myfile.png");    
+    * Tip: If you are going to create a PNGwriter instance for reading in a file that already exists, 
+    * then width and height can be 1 pixel, and the size will be automatically adjusted once you use
+    * readfromfile().
+    * */
+    MyPngWriter(int width, int height, int backgroundcolour, const char * filename);   
+
+   /* Banded Constructor
+    * Same as above, but only bandheight rows of the image are kept in memory at a time, so a large
+    * image costs width*bandheight*4 bytes instead of width*height*4. Plot into the current band
+    * (rows getbandtop() to getbandtop()+bandheight-1, pixels outside it are ignored), then call
+    * flushband() to encode those rows and move on to the next band. close() flushes whatever is left
+    * and finishes the file.
+    * */
+    MyPngWriter(int width, int height, int backgroundcolour, const char * filename, int bandheight);
+
+   /* Tiled Constructor
+    * The image is held in tilesize x tilesize tiles that are only allocated once something is plotted
+    * in them, so the memory used follows the area actually drawn rather than width*height, and widths
+    * and heights far beyond what fits in memory as a whole are fine. The background is transparent
+    * black. close() writes the image out one row at a time, and frees the tiles as it goes if
+    * setreleaseonclose() asked for it.
+    * */
+    MyPngWriter(int width, int height, const char * filename, int tilesize);
+
+   /* Destructor
+    * */
+   ~MyPngWriter();  
+
+   /* Assignment Operator
+    * */
+   MyPngWriter & operator = (const MyPngWriter & rhs);
+      
+   /*  Plot
+    * With this function a pixel at coordinates (x, y) can be set to the desired colour. 
+    * The pixels are numbered starting from (0, 0) and go to (width - 1, height - 1). 
+    * As with most functions in PNGwriter, it has been overloaded to accept either int arguments 
+    * for the colour coefficients, or those of type double. If they are of type int, 
+    * they go from 0 to 65535. If they are of type double, they go from 0.0 to 1.0.
+    * Tip: To plot using red, then specify plot(x, y, 1.0, 0.0, 0.0). To make pink, 
+    * just add a constant value to all three coefficients, like this:
+    * plot(x, y, 1.0, 0.4, 0.4). 
+    * Tip: If nothing is being plotted to your PNG file, make sure that you remember
+    * to close() the instance before your program is finished, and that the x and y position
+    * is actually within the bounds of your image. If either is not, then PNGwriter will 
+    * not complain-- it is up to you to check for this!
+    * Tip: If you try to plot with a colour coefficient out of range, a maximum or minimum
+    * coefficient will be assumed, according to the given coefficient. For example, attempting
+    * to plot plot(x, y, 1.0,-0.2,3.7) will set the green coefficient to 0 and the red coefficient
+    * to 1.0.
+    * */
+   void  plot(int x, int y, int red, int green, int blue, int alpha); 
+
    /* Figures
     * These functions draw basic shapes. Available in both int and double versions.
     * The line functions use the fast Bresenham algorithm. Despite the name, 
     * the square functions draw rectangles. The circle functions use a fast 
     * integer math algorithm. The filled circle functions make use of sqrt().
     * */
-   void line(int xfrom, int yfrom, int xto, int yto, int red, int green,int  blue, int alpha);   
-
-   unsigned char getAlpha(int x, int y);
-   unsigned char getRed(int x, int  y);
-   unsigned char getGreen(int x, int  y);
-   unsigned char getBlue(int x, int  y);
-   
-   /* Clear
-    * The whole image is set to black.
-    * */ 
-   void clear(void);    
-   
-   /* Close
-    * Close the instance of the class, and write the image to disk.
-    * Tip: If you do not call this function before your program ends, no image
-    * will be written to disk.
-    * */
-   void close(void); 
-
-   /* Read From File
-    * Open the existing PNG image, and copy it into this instance of the class. It is important to mention 
-    * that PNG variants are supported. Very generally speaking, most PNG files can now be read (as of version 0.5.4), 
-    * but if they have an alpha channel it will be completely stripped. If the PNG file uses GIF-style transparency 
-    * (where one colour is chosen to be transparent), PNGwriter will not read the image properly, but will not 
-    * complain. Also, if any ancillary chunks are included in the PNG file (chroma, filter, etc.), it will render 
-    * with a slightly different tonality. For the vast majority of PNGs, this should not be an issue. Note: 
-    * If you read an 8-bit PNG, the internal representation of that instance of PNGwriter will be 8-bit (PNG 
-    * files of less than 8 bits will be upscaled to 8 bits). To convert it to 16-bit, just loop over all pixels, 
-    * reading them into a new instance of PNGwriter. New instances of PNGwriter are 16-bit by default.
-    * */
-
-   void readfromfile(char * name);  
-   void readfromfile(const char * name); 
-
-   /* Get Height
-    * When you open a PNG with readfromfile() you can find out its height with this function.
-    * */
-   int getheight(void);
-   
-   /* Get Width
-    * When you open a PNG with readfromfile() you can find out its width with this function.
-    * */
-   int getwidth(void);
-
-   /* Set Compression Level
-    * Set the compression level that will be used for the image. -1 is to use the  default,
-    * 0 is none, 9 is best compression. 
-    * Remember that this will affect how long it will take to close() the image. A value of 2 or 3
-    * is good enough for regular use, but for storage or transmission you might want to take the time
-    * to set it at 9.
-    * */
-    void setcompressionlevel(int level);
-
-   /* Get Bit Depth
-    * When you open a PNG with readfromfile() you can find out its bit depth with this function.
-    * Mostly for troubleshooting uses.
-    * */
-   int getbitdepth(void);
-   
-   /* Get Colour Type
-    * When you open a PNG with readfromfile() you can find out its colour type (libpng categorizes 
-    * different styles of image data with this number).
-    * Mostly for troubleshooting uses.
-    * */
-   int getcolortype(void);
-   
-   /* Set Gamma Coeff
-    * Set the image's gamma (file gamma) coefficient. This is experimental, but use it if your image's colours seem too bright
-    * or too dark. The default value of 0.5 should be fine. The standard disclaimer about Mac and PC gamma
-    * settings applies.
-    * */
-   void setgamma(double gamma);
-
-   
-   /* Get Gamma Coeff
-    * Get the image's gamma coefficient. This is experimental.
-    * */
-   double getgamma(void);
-
-    /* Version Number
-    * Returns the PNGwriter version number.
-    */
-  static double version(void);  
-
-   /* Write PNG
-    * Writes the PNG image to disk. You can still change the PNGwriter instance after this.
-    * Tip: This is exactly the same as close(), but easier to remember.
-    * Tip: To make a sequence of images using only one instance of PNGwriter, alter the image, change its name,
-    * write_png(), then alter the image, change its name, write_png(), etc.
-    */
-   void write_png(void);
-
-   void write_out_red_as_alpha();
-
-   /* Invert
-    * Inverts the image in RGB colourspace.
-    * */
-   void invert(void);
-
-};
-#endif
+   void line(int xfrom, int yfrom, int xto, int yto, int red, int green,int  blue, int alpha);   
+
+   unsigned char getAlpha(int x, int y);
+   unsigned char getRed(int x, int  y);
+   unsigned char getGreen(int x, int  y);
+   unsigned char getBlue(int x, int  y);
+
+   /* Rows and spans
+    * Direct access to the pixels of an 8 bits RGBA image, 4 bytes a pixel, for loops that would
+    * otherwise call plot() or the get functions for every pixel.
+    * row() gives the width pixels of row y, or NULL if the row is not held in memory as one
+    * (outside the image or the current band, or a tiled image).
+    * span() gives len pixels from (x, y) to write into, or NULL if they are not contiguous in
+    * memory (outside the image or the current band, or across a tile). A tile is allocated.
+    * */
+   const unsigned char * row(int y);
+   rgba8 * span(int x, int y, int len);
+
+   /* Blit and Fill
+    * Set the len pixels from (x, y) to the ones at pixels, or all to colour. Pixels outside the
+    * image or the current band are skipped, and tiles are only allocated for pixels that are not
+    * transparent black, as with plot().
+    * */
+   void blit(int x, int y, const rgba8 * pixels, int len);
+   void fill(int x, int y, int len, rgba8 colour);
+   
+   /* Clear
+    * The whole image is set to black.
+    * */ 
+   void clear(void);    
+   
+   /* Close
+    * Close the instance of the class, and write the image to disk.
+    * Tip: If you do not call this function before your program ends, no image
+    * will be written to disk.
+    * */
+   void close(void); 
+
+   /* Flush Band
+    * Only for instances created with the banded constructor. Hands the rows of the current band to
+    * libpng, resets them to the background colour and moves the band down by bandheight rows.
+    * The file is created on the first call.
+    * */
+   void flushband(void);
+
+   /* Get Band Top
+    * First image row of the current band. Always 0 for instances that keep the whole image.
+    * */
+   int getbandtop(void);
+
+   /* Set Control
+    * close() and flushband() report the rows encoded so far to control, as STAGE_ENCODE, after each band
+    * or row of tiles. Once control is cancelled, close() stops at the next one and leaves an incomplete
+    * file behind, for the caller to remove. NULL (the default) encodes the whole image silently.
+    * */
+   void setcontrol(const BuildControl * control);
+
+   /* Set Release On Close
+    * Only for instances created with the tiled constructor. With release true, close() frees each
+    * row of tiles once it has been encoded, so writing the image takes no more memory than drawing
+    * it did, but the image is blank afterwards. false (the default) keeps the image, so it can be
+    * changed and written again.
+    * */
+   void setreleaseonclose(bool release);
+
+   /* Read From File
+    * Open the existing PNG image, and copy it into this instance of the class. It is important to mention 
+    * that PNG variants are supported. Very generally speaking, most PNG files can now be read (as of version 0.5.4), 
+    * but if they have an alpha channel it will be completely stripped. If the PNG file uses GIF-style transparency 
+    * (where one colour is chosen to be transparent), PNGwriter will not read the image properly, but will not 
+    * complain. Also, if any ancillary chunks are included in the PNG file (chroma, filter, etc.), it will render 
+    * with a slightly different tonality. For the vast majority of PNGs, this should not be an issue. Note: 
+    * If you read an 8-bit PNG, the internal representation of that instance of PNGwriter will be 8-bit (PNG 
+    * files of less than 8 bits will be upscaled to 8 bits). To convert it to 16-bit, just loop over all pixels, 
+    * reading them into a new instance of PNGwriter. New instances of PNGwriter are 16-bit by default.
+    * Returns false if the file cannot be opened or decoded, the image held before is then kept.
+    * */
+
+   bool readfromfile(char * name);  
+   bool readfromfile(const char * name); 
+
+   /* Get Height
+    * When you open a PNG with readfromfile() you can find out its height with this function.
+    * */
+   int getheight(void);
+   
+   /* Get Width
+    * When you open a PNG with readfromfile() you can find out its width with this function.
+    * */
+   int getwidth(void);
+
+   /* Set Compression Level
+    * Set the compression level that will be used for the image. -1 is to use the  default,
+    * 0 is none, 9 is best compression. PNGWRITER_COMPRESSION_QUICK encodes fastest of all,
+    * with files somewhat larger than level 1.
+    * Remember that this will affect how long it will take to close() the image. A value of 2 or 3
+    * is good enough for regular use, but for storage or transmission you might want to take the time
+    * to set it at 9.
+    * */
+    void setcompressionlevel(int level);
+
+   /* Set Encode Threads
+    * close() filters and deflates horizontal bands of the image on this many threads and stitches
+    * them into one zlib stream, each band primed with the end of the one above as its dictionary.
+    * 1 (the default) encodes on the calling thread with libpng, 0 uses one thread per core, which
+    * is the same as 1 on a single core. Only a few bands are held at a time, each written out once the
+    * ones above it are. Instances created with the banded constructor always stream on the calling thread.
+    * */
+   void setencodethreads(int threads);
+
+   /* Set Filter Strategy
+    * How close() filters the rows before deflating them. PNGWRITER_FILTER_ADAPTIVE (the default)
+    * tries every filter on each row and keeps the one libpng's heuristic prefers, PNGWRITER_FILTER_FIXED
+    * uses PNGWRITER_FIXED_FILTER on every row and PNGWRITER_FILTER_NONE leaves the rows as they are.
+    * The other two skip trying the filters, so close() is faster, but the files are usually larger,
+    * much larger without filtering.
+    * */
+   void setfilterstrategy(int strategy);
+
+   /* Get Bit Depth
+    * When you open a PNG with readfromfile() you can find out its bit depth with this function.
+    * Mostly for troubleshooting uses.
+    * */
+   int getbitdepth(void);
+   
+   /* Get Colour Type
+    * When you open a PNG with readfromfile() you can find out its colour type (libpng categorizes 
+    * different styles of image data with this number).
+    * Mostly for troubleshooting uses.
+    * */
+   int getcolortype(void);
+   
+   /* Set Gamma Coeff
+    * Set the image's gamma (file gamma) coefficient. This is experimental, but use it if your image's colours seem too bright
+    * or too dark. The default value of 0.5 should be fine. The standard disclaimer about Mac and PC gamma
+    * settings applies.
+    * */
+   void setgamma(double gamma);
+
+   
+   /* Get Gamma Coeff
+    * Get the image's gamma coefficient. This is experimental.
+    * */
+   double getgamma(void);
+
+    /* Version Number
+    * Returns the PNGwriter version number.
+    */
+  static double version(void);  
+
+   /* Set CRC Check
+    * Whether readfromfile() checks the CRC of the chunks it reads, on by default. Turning it off
+    * skips computing them at all, and a corrupted chunk is used as it is, so only do it for files
+    * that have been checked already, like the outputs of an earlier build. Applies to every instance.
+    * */
+   static void setcrccheck(bool check);
+
+   /* Set Map Files
+    * Whether readfromfile() maps files of PNGWRITER_MAP_FILE_BYTES and more into memory, on by default.
+    * A mapped file another program truncates while it is decoded kills the process with SIGBUS, so turn
+    * it off when the files may change under the reader, as they do in watch mode. They are then read
+    * into a buffer, and a truncated one is a read error. Applies to every instance.
+    * */
+   static void setmapfiles(bool map);
+
+   /* Write PNG
+    * Writes the PNG image to disk. You can still change the PNGwriter instance after this.
+    * Tip: This is exactly the same as close(), but easier to remember.
+    * Tip: To make a sequence of images using only one instance of PNGwriter, alter the image, change its name,
+    * write_png(), then alter the image, change its name, write_png(), etc.
+    */
+   void write_png(void);
+
+   void write_out_red_as_alpha();
+
+   /* Invert
+    * Inverts the image in RGB colourspace.
+    * */
+   void invert(void);
+
+};
+#endif
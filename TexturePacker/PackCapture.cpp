@@ -0,0 +1,150 @@
+#include "PackCapture.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include "Platform.h"
+#include "ByteOrder.h"
+
+bool WritePackCapture(std::ostream& out, int width, int height, PackOrder order, const std::vector<SpriteInfo>& sprites)
+{
+    WriteU32(out, PACK_CAPTURE_MAGIC);
+    WriteU32(out, PACK_CAPTURE_VERSION);
+    WriteU32(out, width);
+    WriteU32(out, height);
+    WriteU32(out, order);
+    WriteU32(out, sprites.size());
+
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInfo& sprite = sprites[i];
+
+        WriteU32(out, sprite.srcW);
+        WriteU32(out, sprite.srcH);
+        WriteU32(out, sprite.shapeMask);
+        WriteU32(out, sprite.vertex.size());
+
+        for (int j = 0; j < sprite.vertex.size(); ++j)
+        {
+            WriteU32(out, sprite.vertex[j].x);
+            WriteU32(out, sprite.vertex[j].y);
+        }
+    }
+
+    return out.good();
+}
+
+bool ReadPackCapture(std::istream& in, int& width, int& height, PackOrder& order,
+    std::vector<SpriteInfo>& sprites, std::vector<std::string>& names)
+{
+    unsigned int magic, version, orderValue, spriteCount;
+    if (!ReadU32(in, magic) || magic != PACK_CAPTURE_MAGIC || !ReadU32(in, version) || version != PACK_CAPTURE_VERSION)
+        return false;
+    if (!ReadI32(in, width) || !ReadI32(in, height) || !ReadU32(in, orderValue) || orderValue >= ORDER_COUNT)
+        return false;
+    if (!ReadU32(in, spriteCount))
+        return false;
+
+    std::vector<SpriteInfo> read;
+    std::vector<std::string> readNames;
+
+    for (unsigned int i = 0; i < spriteCount; ++i)
+    {
+        SpriteInfo sprite;
+        unsigned int vertexCount;
+        if (!ReadI32(in, sprite.srcW) || !ReadI32(in, sprite.srcH) || !ReadI32(in, sprite.shapeMask) || !ReadU32(in, vertexCount))
+            return false;
+
+        // No reserve(), the count of a damaged file must not turn into a huge allocation.
+        for (unsigned int j = 0; j < vertexCount; ++j)
+        {
+            CPoint pt;
+            if (!ReadI32(in, pt.x) || !ReadI32(in, pt.y))
+                return false;
+            sprite.vertex.push_back(pt);
+        }
+
+        sprite.x = sprite.y = -1;
+        sprite.w = sprite.h = 0;
+        sprite.fitted = false;
+        sprite.userData = NULL;
+
+        std::ostringstream name;
+        name << "#" << i;
+
+        read.push_back(sprite);
+        readNames.push_back(name.str());
+    }
+
+    order = (PackOrder)orderValue;
+    names.swap(readNames);
+    sprites.swap(read);
+    for (int i = 0; i < sprites.size(); ++i)
+        sprites[i].userData = (void*)&names[i];
+
+    return true;
+}
+
+// FNV-1a over the placement of every sprite, in the order Pack() left them.
+unsigned int GetPlacementDigest(const std::vector<SpriteInfo>& sprites)
+{
+    unsigned int digest = 2166136261u;
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        int fields[5] = { sprites[i].srcW, sprites[i].srcH, sprites[i].fitted, sprites[i].x, sprites[i].y };
+        for (int k = 0; k < 5; ++k)
+        {
+            for (int b = 0; b < 4; ++b)
+            {
+                digest ^= (fields[k] >> (b * 8)) & 0xff;
+                digest *= 16777619u;
+            }
+        }
+    }
+    return digest;
+}
+
+bool ReplayPackCapture(const std::string& path, int repeatCount)
+{
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    int width, height;
+    PackOrder order;
+    std::vector<SpriteInfo> captured;
+    std::vector<std::string> names;
+    if (!ReadPackCapture(in, width, height, order, captured, names))
+    {
+        std::cerr << "Cannot read pack capture " << path << "\n";
+        return false;
+    }
+
+    printf("Replaying %d sprites on %dx%d, sorted by %s\n",
+        (int)captured.size(), width, height, TexturePacker::GetOrderName(order));
+
+    double bestTime = 0, totalTime = 0;
+    for (int run = 0; run < repeatCount; ++run)
+    {
+        std::vector<SpriteInfo> sprites = captured;
+
+        double startTime = GetTimeInSeconds();
+        TexturePacker packer(width, height, order);
+        packer.Pack(sprites);
+        double time = GetTimeInSeconds() - startTime;
+
+        totalTime += time;
+        if (run == 0 || time < bestTime)
+            bestTime = time;
+
+        if (run == repeatCount - 1)
+        {
+            int fitted = 0;
+            for (int i = 0; i < sprites.size(); ++i)
+                fitted += sprites[i].fitted ? 1 : 0;
+
+            printf("Fitted %d of %d sprites, placement digest %08x\n", fitted, (int)sprites.size(), GetPlacementDigest(sprites));
+        }
+    }
+
+    printf("Pack took %.2f ms best, %.2f ms average over %d runs\n",
+        bestTime * 1000, totalTime * 1000 / repeatCount, repeatCount);
+    return true;
+}
@@ -0,0 +1,32 @@
+#ifndef _PACKCAPTURE_H_
+#define _PACKCAPTURE_H_
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "TexturePacker.h"
+
+//  Exactly what TexturePacker::Pack() was handed, so that a packing can be run again without the images:
+//  the texture size, the sort order and every sprite in the order it came, with its source size, shape
+//  mask and bounding polygon. Names and pixels are left out, a capture can be sent around freely.
+//
+//  Little-endian, every field 32 bits:
+//
+//  magic version width height order spriteCount
+//  per sprite: srcW srcH shapeMask vertexCount, then vertexCount x, y pairs
+const static unsigned int PACK_CAPTURE_MAGIC = 0x50435054; // "TPCP"
+const static unsigned int PACK_CAPTURE_VERSION = 1;
+
+bool WritePackCapture(std::ostream& out, int width, int height, PackOrder order, const std::vector<SpriteInfo>& sprites);
+
+// Reads a capture into sprites, replacing what it held. The sprites are named by their index,
+// "#0", "#1" ..., in names, which their userData point to.
+bool ReadPackCapture(std::istream& in, int& width, int& height, PackOrder& order,
+    std::vector<SpriteInfo>& sprites, std::vector<std::string>& names);
+
+// Packs the sprites of the capture repeatCount times and prints how long it took and a digest of
+// where the sprites went, which stays the same as long as the packer places them the same way.
+// Returns false if the capture cannot be read.
+bool ReplayPackCapture(const std::string& path, int repeatCount);
+
+#endif
@@ -0,0 +1,371 @@
+#include "Platform.h"
+#include <fstream>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+double GetTimeInSeconds()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+int GetProcessNumber()
+{
+#ifdef _WIN32
+    return (int)GetCurrentProcessId();
+#else
+    return (int)getpid();
+#endif
+}
+
+bool MakeDirectory(const std::string& path)
+{
+#ifdef _WIN32
+    return CreateDirectoryA(path.c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+    struct stat status;
+    return mkdir(path.c_str(), 0777) == 0 || (stat(path.c_str(), &status) == 0 && S_ISDIR(status.st_mode));
+#endif
+}
+
+bool ListDirectory(const std::string& path, std::vector<std::string>& names)
+{
+#ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA((path + "\\*").c_str(), &entry);
+    if (find == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        std::string name = entry.cFileName;
+        if (name != "." && name != "..")
+            names.push_back(name);
+    }
+    while (FindNextFileA(find, &entry));
+
+    FindClose(find);
+    return true;
+#else
+    DIR* dir = opendir(path.c_str());
+    if (dir == NULL)
+        return false;
+
+    while (dirent* entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..")
+            names.push_back(name);
+    }
+
+    closedir(dir);
+    return true;
+#endif
+}
+
+bool GetFileStatus(const std::string& path, double& size, double& modifiedTime)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+        return false;
+
+    size = data.nFileSizeHigh * 4294967296.0 + data.nFileSizeLow;
+    modifiedTime = (data.ftLastWriteTime.dwHighDateTime * 4294967296.0 + data.ftLastWriteTime.dwLowDateTime) * 1e-7;
+    return true;
+#else
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0)
+        return false;
+
+    size = (double)status.st_size;
+    modifiedTime = (double)status.st_mtime;
+    return true;
+#endif
+}
+
+bool TouchFile(const std::string& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    SYSTEMTIME now;
+    FILETIME time;
+    GetSystemTime(&now);
+    SystemTimeToFileTime(&now, &time);
+    BOOL ok = SetFileTime(file, NULL, NULL, &time);
+    CloseHandle(file);
+    return ok != 0;
+#else
+    return utime(path.c_str(), NULL) == 0;
+#endif
+}
+
+bool RemoveFile(const std::string& path)
+{
+    return remove(path.c_str()) == 0;
+}
+
+bool RenameFile(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+bool CopyFileContents(const std::string& from, const std::string& to)
+{
+    std::ifstream in(from.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    // Inserting an empty stream buffer would flag the output as failed.
+    std::ofstream out(to.c_str(), std::ios::out | std::ios::binary);
+    if (in.peek() != EOF)
+        out << in.rdbuf();
+    out.close();
+
+    if (!out)
+    {
+        RemoveFile(to);
+        return false;
+    }
+    return true;
+}
+
+FILE* OpenReplacing(const std::string& path)
+{
+    RemoveFile(path);
+    return fopen(path.c_str(), "wb");
+}
+
+bool OpenReplacing(const std::string& path, std::ofstream& out)
+{
+    RemoveFile(path);
+    out.open(path.c_str(), std::ios::out | std::ios::binary);
+    return out.is_open();
+}
+
+bool LinkOrCopyFile(const std::string& from, const std::string& to)
+{
+    RemoveFile(to);
+
+#ifdef _WIN32
+    if (CreateHardLinkA(to.c_str(), from.c_str(), NULL))
+        return true;
+#else
+    if (link(from.c_str(), to.c_str()) == 0)
+        return true;
+#endif
+
+    // Not on the same volume, or links are not supported there.
+    return CopyFileContents(from, to);
+}
+
+void* AllocateAligned(size_t size, size_t alignment)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* p = NULL;
+    return posix_memalign(&p, alignment, size) == 0 ? p : NULL;
+#endif
+}
+
+void FreeAligned(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+bool PrefetchFile(const std::string& path)
+{
+#ifdef _WIN32
+    return false;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    bool ok = posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0;
+    close(fd);
+    return ok;
+#endif
+}
+
+MappedFile::MappedFile(size_t minMappedSize)
+:mData(NULL)
+,mSize(0)
+,mMapped(false)
+,mMinMappedSize(minMappedSize)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path, bool map)
+{
+    Close();
+
+    // The mapping keeps the file open, its handle is not needed any more once the view exists.
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (ULONGLONG)size.QuadPart > (size_t)-1)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Nothing to map in an empty file.
+    if (!map || (size_t)size.QuadPart < mMinMappedSize || size.QuadPart == 0)
+    {
+        bool ok = ReadAll(file, (size_t)size.QuadPart);
+        CloseHandle(file);
+        return ok;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+        return false;
+
+    mData = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (mData == NULL)
+        return false;
+
+    mSize = (size_t)size.QuadPart;
+    mMapped = true;
+    return true;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+
+    // Nothing to map in an empty file.
+    if (!map || (size_t)status.st_size < mMinMappedSize || status.st_size == 0)
+    {
+        bool ok = ReadAll(fd, (size_t)status.st_size);
+        close(fd);
+        return ok;
+    }
+
+    void* data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    // Read ahead all of it, and drop the pages behind the reader instead of something else.
+    madvise(data, (size_t)status.st_size, MADV_SEQUENTIAL);
+    madvise(data, (size_t)status.st_size, MADV_WILLNEED);
+
+    mData = (const unsigned char*)data;
+    mSize = (size_t)status.st_size;
+    mMapped = true;
+    return true;
+#endif
+}
+
+void MappedFile::Close()
+{
+    if (mMapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+#else
+        munmap((void*)mData, mSize);
+#endif
+    }
+    mData = NULL;
+    mSize = 0;
+    mMapped = false;
+}
+
+#ifdef _WIN32
+bool MappedFile::ReadAll(void* file, size_t size)
+{
+    if (mBuffer.size() < size)
+        mBuffer.resize(size);
+
+    for (size_t done = 0; done < size; )
+    {
+        DWORD part = (DWORD)std::min(size - done, (size_t)0x40000000), count;
+        if (!ReadFile((HANDLE)file, &mBuffer[done], part, &count, NULL) || count == 0)
+            return false;
+        done += count;
+    }
+
+    mData = size > 0 ? &mBuffer[0] : NULL;
+    mSize = size;
+    return true;
+}
+#else
+bool MappedFile::ReadAll(int fd, size_t size)
+{
+    if (mBuffer.size() < size)
+        mBuffer.resize(size);
+
+    for (size_t done = 0; done < size; )
+    {
+        ssize_t count = read(fd, &mBuffer[done], size - done);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        done += count;
+    }
+
+    mData = size > 0 ? &mBuffer[0] : NULL;
+    mSize = size;
+    return true;
+}
+#endif
@@ -0,0 +1,89 @@
+#ifndef _PLATFORM_H_
+#define _PLATFORM_H_
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <stdio.h>
+
+// Seconds elapsed since an arbitrary point, for measuring intervals.
+double GetTimeInSeconds();
+
+int GetProcessNumber();
+
+// Creates a directory, returns true if it exists afterwards.
+bool MakeDirectory(const std::string& path);
+
+// Names of the entries of a directory, without "." and "..".
+bool ListDirectory(const std::string& path, std::vector<std::string>& names);
+
+// Size in bytes and time of the last modification in seconds of a file, false if it does not exist.
+bool GetFileStatus(const std::string& path, double& size, double& modifiedTime);
+
+// Sets the modification time of a file to now.
+bool TouchFile(const std::string& path);
+
+bool RemoveFile(const std::string& path);
+
+// Renames a file, replacing the destination if it exists.
+bool RenameFile(const std::string& from, const std::string& to);
+
+// Writes a copy of from to to, replacing it.
+bool CopyFileContents(const std::string& from, const std::string& to);
+
+// Makes to a hard link to from, or a copy of it where a link is not possible. Replaces to.
+bool LinkOrCopyFile(const std::string& from, const std::string& to);
+
+// Creates a file to write in binary. One already there is removed first rather than written over,
+// it may be a hard link LinkOrCopyFile() made into the build cache. NULL if it cannot be created.
+FILE* OpenReplacing(const std::string& path);
+
+// The same, opening out on the file. Returns whether it is open.
+bool OpenReplacing(const std::string& path, std::ofstream& out);
+
+// Allocates size bytes starting on a multiple of alignment, a power of two. NULL if out of memory.
+void* AllocateAligned(size_t size, size_t alignment);
+
+// Frees what AllocateAligned() returned, NULL is ignored.
+void FreeAligned(void* p);
+
+// Asks the system to start reading a file into memory in the background, so that opening it soon
+// after does not wait on the disk. Returns at once, false if it cannot be done here.
+bool PrefetchFile(const std::string& path);
+
+// A file mapped read only into memory, for reading it through once from start to end. Files smaller
+// than minMappedSize are read into a buffer kept from one file to the next instead, for a few pages
+// mapping them and taking them down again costs more than copying them.
+class MappedFile
+{
+public:
+    explicit MappedFile(size_t minMappedSize = 0);
+    ~MappedFile();
+
+    // Maps or reads the whole file, closing the one open before. An empty file has no data. False if
+    // it cannot be opened or read. With map false it is always read: a mapped file that is truncated
+    // while it is read raises SIGBUS, where reading it only fails.
+    bool Open(const std::string& path, bool map = true);
+    void Close();
+
+    const unsigned char* GetData() const { return mData; }
+    size_t GetSize() const { return mSize; }
+
+private:
+#ifdef _WIN32
+    bool ReadAll(void* file, size_t size);
+#else
+    bool ReadAll(int fd, size_t size);
+#endif
+
+    const unsigned char* mData;
+    size_t mSize;
+    bool mMapped;
+    size_t mMinMappedSize;
+    std::vector<unsigned char> mBuffer;
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+#endif
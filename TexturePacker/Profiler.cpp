@@ -0,0 +1,138 @@
+#include "Profiler.h"
+#include <fstream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+#include "Threading.h"
+
+bool Profiler::sEnabled = false;
+
+struct ProfileScope
+{
+    const char* name;
+    double start;
+    double duration;
+    long thread;
+};
+
+struct ScopeTotal
+{
+    int calls;
+    double total;
+    double longest;
+};
+
+struct CompareName
+{
+    bool operator()(const char* a, const char* b) const
+    {
+        return strcmp(a, b) < 0;
+    }
+};
+
+const char* const COUNTER_NAMES[COUNTER_COUNT] =
+{
+    "Candidates tried",
+    "NotOverlap calls",
+    "PNG bytes read",
+    "PNG bytes written",
+};
+
+static Mutex sMutex;
+static std::vector<ProfileScope> sScopes;
+static volatile long sCounters[COUNTER_COUNT];
+static double sStartTime;
+
+void Profiler::Enable()
+{
+    sStartTime = GetTimeInSeconds();
+    sEnabled = true;
+}
+
+void Profiler::AddScope(const char* name, double start, double duration)
+{
+    ProfileScope scope;
+    scope.name = name;
+    scope.start = start;
+    scope.duration = duration;
+    scope.thread = GetCurrentThreadNumber();
+
+    ScopedLock lock(sMutex);
+    sScopes.push_back(scope);
+}
+
+void Profiler::AddCount(ProfileCounter counter, long value)
+{
+    AtomicAdd(&sCounters[counter], value);
+}
+
+bool Profiler::WriteTrace(const std::string& path)
+{
+    ScopedLock lock(sMutex);
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == NULL)
+    {
+        perror(path.c_str());
+        return false;
+    }
+
+    // Times are in microseconds from Enable().
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+
+    for (int i = 0; i < sScopes.size(); ++i)
+    {
+        const ProfileScope& scope = sScopes[i];
+        fprintf(file, "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %ld, \"ts\": %.3f, \"dur\": %.3f},\n",
+            scope.name, scope.thread, (scope.start - sStartTime) * 1e6, scope.duration * 1e6);
+    }
+
+    double end = (GetTimeInSeconds() - sStartTime) * 1e6;
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        fprintf(file, "{\"name\": \"%s\", \"ph\": \"C\", \"pid\": 1, \"ts\": %.3f, \"args\": {\"total\": %ld}}%s\n",
+            COUNTER_NAMES[i], end, sCounters[i], i + 1 < COUNTER_COUNT ? "," : "");
+    }
+
+    fprintf(file, "]}\n");
+    return fclose(file) == 0;
+}
+
+void Profiler::PrintSummary()
+{
+    ScopedLock lock(sMutex);
+
+    std::map<const char*, ScopeTotal, CompareName> totals;
+    for (int i = 0; i < sScopes.size(); ++i)
+    {
+        const ProfileScope& scope = sScopes[i];
+
+        std::map<const char*, ScopeTotal, CompareName>::iterator it = totals.find(scope.name);
+        if (it == totals.end())
+        {
+            ScopeTotal total = { 0, 0, 0 };
+            it = totals.insert(std::make_pair(scope.name, total)).first;
+        }
+
+        ++it->second.calls;
+        it->second.total += scope.duration;
+        it->second.longest = std::max(it->second.longest, scope.duration);
+    }
+
+    printf("\n%-28s %10s %12s %12s %12s\n", "Scope", "Calls", "Total(ms)", "Average(us)", "Longest(ms)");
+
+    for (std::map<const char*, ScopeTotal, CompareName>::iterator it = totals.begin(); it != totals.end(); ++it)
+    {
+        const ScopeTotal& total = it->second;
+        printf("%-28s %10d %12.1f %12.1f %12.1f\n", it->first, total.calls,
+            total.total * 1000, total.total * 1e6 / total.calls, total.longest * 1000);
+    }
+
+    printf("\n");
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        printf("%-28s %10ld\n", COUNTER_NAMES[i], sCounters[i]);
+    }
+}
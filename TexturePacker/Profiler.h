@@ -0,0 +1,75 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <string>
+#include "Platform.h"
+
+enum ProfileCounter
+{
+    COUNTER_CANDIDATES,             // Positions tried by TexturePacker::TryArrangeARect().
+    COUNTER_NOT_OVERLAP,            // Calls to TexturePacker::NotOverlap().
+    COUNTER_BYTES_READ,             // Bytes of the PNG files decoded.
+    COUNTER_BYTES_WRITTEN,          // Bytes of the PNG files written.
+
+    COUNTER_COUNT
+};
+
+//  Collects how long the stages take and how often the hot paths run, on every thread.
+//  Nothing is collected until Enable() is called, until then a PROFILE_SCOPE or a PROFILE_COUNT
+//  costs a test of a flag.
+class Profiler
+{
+public:
+
+    static void Enable();
+
+    static bool IsEnabled() { return sEnabled; }
+
+    // A scope named name ran on the calling thread from start for duration, in seconds.
+    static void AddScope(const char* name, double start, double duration);
+
+    static void AddCount(ProfileCounter counter, long value);
+
+    // Writes every scope collected so far as a Chrome trace (chrome://tracing, Perfetto).
+    static bool WriteTrace(const std::string& path);
+
+    // Prints the total, average and longest time of each kind of scope, and the counters.
+    static void PrintSummary();
+
+private:
+
+    static bool sEnabled;
+};
+
+// Times the enclosing scope when the profiler is enabled. name must be a string literal.
+class ScopedTimer
+{
+public:
+
+    explicit ScopedTimer(const char* name)
+    :mName(name)
+    ,mStart(Profiler::IsEnabled() ? GetTimeInSeconds() : -1)
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        if (mStart >= 0)
+            Profiler::AddScope(mName, mStart, GetTimeInSeconds() - mStart);
+    }
+
+private:
+
+    const char* mName;
+    double mStart;
+};
+
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+
+#define PROFILE_SCOPE(name) ScopedTimer PROFILE_JOIN(profileScope, __LINE__)(name)
+
+#define PROFILE_COUNT(counter, value) \
+    do { if (Profiler::IsEnabled()) Profiler::AddCount(counter, value); } while (0)
+
+#endif
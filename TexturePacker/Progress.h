@@ -0,0 +1,77 @@
+#ifndef _PROGRESS_H_
+#define _PROGRESS_H_
+
+#include <signal.h>
+#include <stddef.h>
+
+enum BuildStage
+{
+    STAGE_DECODE,                   // Sprites decoded and bounded.
+    STAGE_PACK,                     // Sprites given a place, or found not to fit.
+    STAGE_COMPOSE,                  // Sprites drawn into the packed texture, when it is not written in bands.
+    STAGE_ENCODE,                   // Rows of the packed texture encoded.
+    STAGE_JOBS,                     // Jobs of a batch finished.
+
+    STAGE_COUNT
+};
+
+inline const char* GetStageName(BuildStage stage)
+{
+    static const char* const names[STAGE_COUNT] = { "decode", "pack", "compose", "encode", "jobs" };
+    return (stage >= 0 && stage < STAGE_COUNT) ? names[stage] : "";
+}
+
+// Told how far a build has come.
+class ProgressListener
+{
+public:
+
+    virtual ~ProgressListener() {}
+
+    // done of the total units of stage are finished. Called on the thread doing the work, which
+    // is not always the same one in a batch, and waits for it to return.
+    virtual void OnProgress(BuildStage stage, int done, int total) = 0;
+};
+
+// Asks builds to stop. Cancel() only sets a flag, so it can be called from any thread or from a
+// signal handler. The builds look at it between sprites, candidate positions and rows of tiles.
+class CancellationToken
+{
+public:
+
+    CancellationToken()
+    :mCancelled(0)
+    {
+    }
+
+    void Cancel() { mCancelled = 1; }
+
+    bool IsCancelled() const { return mCancelled != 0; }
+
+private:
+
+    volatile sig_atomic_t mCancelled;
+};
+
+// Where a build reports its progress and finds out whether to stop, either can be NULL.
+struct BuildControl
+{
+    ProgressListener* listener;
+    const CancellationToken* cancel;
+
+    explicit BuildControl(ProgressListener* listener = NULL, const CancellationToken* cancel = NULL)
+    :listener(listener)
+    ,cancel(cancel)
+    {
+    }
+
+    void Report(BuildStage stage, int done, int total) const
+    {
+        if (listener != NULL)
+            listener->OnProgress(stage, done, total);
+    }
+
+    bool IsCancelled() const { return cancel != NULL && cancel->IsCancelled(); }
+};
+
+#endif
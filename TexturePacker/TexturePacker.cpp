@@ -19,6 +19,7 @@ history:
 *********************************************************************/
 #include "TexturePacker.h"
 #include "GeoUtil.h"
+#include "Profiler.h"
 #include <algorithm>
 
 
@@ -31,42 +32,119 @@ struct Comp {
     }
 };
 
-TexturePacker::TexturePacker(int width, int height)
+struct CompareWidth {
+    bool operator()(const SpriteInfo& a, const SpriteInfo& b)
+    {
+        return a.w > b.w || (a.w == b.w && a.h > b.h);
+    }
+};
+
+struct CompareArea {
+    bool operator()(const SpriteInfo& a, const SpriteInfo& b)
+    {
+        return a.w * a.h > b.w * b.h;
+    }
+};
+
+struct CompareLongerSide {
+    bool operator()(const SpriteInfo& a, const SpriteInfo& b)
+    {
+        return std::max(a.w, a.h) > std::max(b.w, b.h);
+    }
+};
+
+struct ComparePerimeter {
+    bool operator()(const SpriteInfo& a, const SpriteInfo& b)
+    {
+        return a.w + a.h > b.w + b.h;
+    }
+};
+
+TexturePacker::TexturePacker(int width, int height, PackOrder order)
 :mWidth(width)
 ,mHeight(height)
+,mOrder(order)
+,mControl(NULL)
 {    
     mPossibleLocations.push_back(std::make_pair(0, 0));
 }
 
-void TexturePacker::Pack(std::vector<SpriteInfo>& spriteList)
+const char* TexturePacker::GetOrderName(PackOrder order)
+{
+    static const char* const names[ORDER_COUNT] = { "height", "width", "area", "longer-side", "perimeter" };
+    return (order >= 0 && order < ORDER_COUNT) ? names[order] : "";
+}
+
+bool TexturePacker::Pack(std::vector<SpriteInfo>& spriteList, const BuildControl& control)
 {
+    PROFILE_SCOPE("Pack");
+
     int size = (int)spriteList.size();
 
     // Calculate sprites' width and height, then sort them.
     for (int i = 0; i < spriteList.size(); ++i)
     {
-        int w = 0, h = 0;
-        const SpriteInfo &sprite = spriteList[i];
-        for (int j = 0; j <sprite.vertex.size(); ++j)
-        {
-            CPoint pt = sprite.vertex[j];
-            w = std::max(pt.x, w);
-            h = std::max(pt.y, h);
-        }
-        spriteList[i].w = w + BOUNDING_PAD;
-        spriteList[i].h = h + BOUNDING_PAD;
+        CalculateSize(spriteList[i]);
     }
 
 	// Sort sprites.
-    std::sort(spriteList.begin(), spriteList.end(), Comp());
+    switch (mOrder)
+    {
+    case ORDER_BY_WIDTH:        std::sort(spriteList.begin(), spriteList.end(), CompareWidth()); break;
+    case ORDER_BY_AREA:         std::sort(spriteList.begin(), spriteList.end(), CompareArea()); break;
+    case ORDER_BY_LONGER_SIDE:  std::sort(spriteList.begin(), spriteList.end(), CompareLongerSide()); break;
+    case ORDER_BY_PERIMETER:    std::sort(spriteList.begin(), spriteList.end(), ComparePerimeter()); break;
+    default:                    std::sort(spriteList.begin(), spriteList.end(), Comp()); break;
+    }
 
     mPossibleLocations.clear();
     mPossibleLocations.push_back(std::make_pair(0, 0));
 
-    for (int i = 0; i < size; ++i)
+    mControl = &control;
+    for (int i = 0; i < size && !control.IsCancelled(); ++i)
     {
         TryArrangeARect(spriteList[i]);
+        control.Report(STAGE_PACK, i + 1, size);
     }
+    mControl = NULL;
+
+    return !control.IsCancelled();
+}
+
+bool TexturePacker::Replace(SpriteInfo& sprite)
+{
+    for (int i = 0; i < mOccupiedRects.size(); ++i)
+    {
+        if (mOccupiedRects[i].userData == sprite.userData)
+        {
+            mOccupiedRects.erase(mOccupiedRects.begin() + i);
+            break;
+        }
+    }
+
+    CalculateSize(sprite);
+
+    if (sprite.fitted && CanBePlacedAt(sprite.x, sprite.y, sprite))
+    {
+        mOccupiedRects.push_back(sprite);
+        return true;
+    }
+
+    sprite.fitted = false;
+    return TryArrangeARect(sprite);
+}
+
+void TexturePacker::CalculateSize(SpriteInfo& sprite)
+{
+    int w = 0, h = 0;
+    for (int j = 0; j <sprite.vertex.size(); ++j)
+    {
+        CPoint pt = sprite.vertex[j];
+        w = std::max(pt.x, w);
+        h = std::max(pt.y, h);
+    }
+    sprite.w = w + BOUNDING_PAD;
+    sprite.h = h + BOUNDING_PAD;
 }
 
 bool TexturePacker::CanBePlacedAt(int x, int y, SpriteInfo &sprite)
@@ -79,7 +157,8 @@ bool TexturePacker::CanBePlacedAt(int x, int y, SpriteInfo &sprite)
     sprite.x = x; 
 	sprite.y = y;
 
-    for (int j = 0; j < mOccupiedRects.size(); ++j)
+    int j;
+    for (j = 0; j < mOccupiedRects.size(); ++j)
     {
         const SpriteInfo &oth = mOccupiedRects[j];
 
@@ -90,11 +169,15 @@ bool TexturePacker::CanBePlacedAt(int x, int y, SpriteInfo &sprite)
         }
 	}
 
+    PROFILE_COUNT(COUNTER_NOT_OVERLAP, result ? j : j + 1);
+
     return result;
 }
 
 bool TexturePacker::TryArrangeARect(SpriteInfo &sprite)
 {
+    PROFILE_SCOPE("TryArrangeARect");
+
     std::vector<std::pair<int,int> > possiblePositions = mPossibleLocations;
 
 	// Find more possible positions in the corners of existing sprites.
@@ -105,6 +188,10 @@ bool TexturePacker::TryArrangeARect(SpriteInfo &sprite)
 
     for (int i=0; i<possiblePositions.size(); ++i)
     {
+        // A sprite can have thousands of positions to try, do not wait for all of them once cancelled.
+        if (mControl != NULL && mControl->IsCancelled())
+            return false;
+
         int x = possiblePositions[i].first;
         int y = possiblePositions[i].second;
 
@@ -112,6 +199,8 @@ bool TexturePacker::TryArrangeARect(SpriteInfo &sprite)
 
         if (canBePlaced)
         {
+            PROFILE_COUNT(COUNTER_CANDIDATES, i + 1);
+
             sprite.fitted = true;
             sprite.x = x;
             sprite.y = y;
@@ -188,6 +277,7 @@ bool TexturePacker::TryArrangeARect(SpriteInfo &sprite)
             return true;
         }
     }
+    PROFILE_COUNT(COUNTER_CANDIDATES, (long)possiblePositions.size());
     return false;
 }
 
@@ -209,6 +299,44 @@ bool IsPointInside(const SpriteInfo& sprite, int x, int y)
     return inside;
 }
 
+// a / b rounded down, b != 0.
+inline long long FloorDiv(long long a, long long b)
+{
+    long long q = a / b;
+    if (a % b != 0 && ((a < 0) != (b < 0)))
+        --q;
+    return q;
+}
+
+// Narrows [from, to] of row y, in the coordinates of the sprite image, to the pixels IsPointInside()
+// accepts, without testing them one by one. Returns false if none is left.
+bool ClipRowToSprite(const SpriteInfo& sprite, int y, int& from, int& to)
+{
+    int n = sprite.vertex.size();
+    for (int i = 0; i < n && from <= to; ++i)
+    {
+        const CPoint& p0 = sprite.vertex[i];
+        const CPoint& p1 = sprite.vertex[(i + 1) % n];
+
+        // LeftOn() keeps the points with (x - p0.x) * dy >= dx * (y - p0.y).
+        long long dx = p1.x - p0.x, dy = p1.y - p0.y;
+        long long c = dx * (y - p0.y);
+        if (dy > 0)
+        {
+            from = (int)std::max((long long)from, p0.x - FloorDiv(-c, dy));
+        }
+        else if (dy < 0)
+        {
+            to = (int)std::min((long long)to, p0.x + FloorDiv(c, dy));
+        }
+        else if (c > 0)
+        {
+            return false;
+        }
+    }
+    return from <= to;
+}
+
 // Try to find positions in the corner of another sprite that our new sprite might be able to place at.
 inline void FindPossiblePositionsInCorners(const SpriteInfo& sprite,const SpriteInfo& oth, std::vector<std::pair<int,int> >& possiblePositions)
 {
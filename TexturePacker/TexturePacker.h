@@ -2,6 +2,7 @@
 #define _TEXTURESPACEARRANGER_H_
 #include <string>
 #include <vector>
+#include "Progress.h"
 
 
 struct MyRect
@@ -32,22 +33,46 @@ struct SpriteInfo
 {    
     int x, y;                   // The position of this sprite in the packed texture.
     int w, h;                   // Width and height of this sprite.
+    int srcW, srcH;             // Width and height of the source image.
     void *userData;
     bool fitted;                // Flag to tell if this sprite has already got a position in the packed texture.
     std::vector<CPoint> vertex;
     int  shapeMask; // Mask to indicate if any of the 4 corners of this sprite has a cutting line.
 };
 
+// The order sprites are packed in by Pack(), largest first.
+enum PackOrder
+{
+    ORDER_BY_HEIGHT,
+    ORDER_BY_WIDTH,
+    ORDER_BY_AREA,
+    ORDER_BY_LONGER_SIDE,
+    ORDER_BY_PERIMETER,
+
+    ORDER_COUNT
+};
+
 class TexturePacker
 {
 public:
 
-    TexturePacker(int width, int height);
+    TexturePacker(int width, int height, PackOrder order = ORDER_BY_HEIGHT);
 
-    void Pack(std::vector<SpriteInfo>& sprites);
+    static const char* GetOrderName(PackOrder order);
+
+    // Reports each sprite placed (or found not to fit) to control. Returns false if control was
+    // cancelled, the sprites not placed yet are then left unfitted.
+    bool Pack(std::vector<SpriteInfo>& sprites, const BuildControl& control = BuildControl());
+
+    // Puts back a sprite already packed by Pack() (found by its userData) after its shape changed.
+    // It keeps its place if the new shape still fits there, otherwise it takes the first place it fits.
+    // Returns false, with sprite.fitted cleared, if it fits nowhere.
+    bool Replace(SpriteInfo& sprite);
 
 protected:
 
+    void CalculateSize(SpriteInfo& sprite);
+
     void FindMorePossiblePositions(std::vector<std::pair<int,int> >& possiblePositions, const SpriteInfo &sprite);
 
     bool CanBePlacedAt(int x, int y, SpriteInfo &sprite);
@@ -62,6 +87,8 @@ protected:
 
     int mWidth;
     int mHeight;    
+    PackOrder mOrder;
+    const BuildControl* mControl;       // Only while Pack() runs.
 };
 
 #endif
\ No newline at end of file
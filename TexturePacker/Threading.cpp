@@ -0,0 +1,233 @@
+#include "Threading.h"
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef _WIN32
+
+Mutex::Mutex()              { InitializeCriticalSection(&mHandle); }
+Mutex::~Mutex()             { DeleteCriticalSection(&mHandle); }
+void Mutex::Lock()          { EnterCriticalSection(&mHandle); }
+void Mutex::Unlock()        { LeaveCriticalSection(&mHandle); }
+
+Condition::Condition()      { InitializeConditionVariable(&mHandle); }
+Condition::~Condition()     {}
+void Condition::Wait(Mutex& mutex) { SleepConditionVariableCS(&mHandle, &mutex.mHandle, INFINITE); }
+void Condition::Signal()    { WakeConditionVariable(&mHandle); }
+void Condition::Broadcast() { WakeAllConditionVariable(&mHandle); }
+
+long AtomicAdd(volatile long* target, long value)
+{
+    return InterlockedExchangeAdd(target, value) + value;
+}
+
+long GetCurrentThreadNumber()
+{
+    return (long)GetCurrentThreadId();
+}
+
+ThreadLocal::ThreadLocal(Destructor destructor)
+:mIndex(FlsAlloc(Release))
+,mDestructor(destructor)
+{
+}
+
+ThreadLocal::~ThreadLocal()
+{
+    FlsFree(mIndex);
+}
+
+void* ThreadLocal::Get() const
+{
+    Slot* slot = (Slot*)FlsGetValue(mIndex);
+    return slot != NULL ? slot->value : NULL;
+}
+
+void ThreadLocal::Set(void* value)
+{
+    Slot* slot = (Slot*)FlsGetValue(mIndex);
+    if (slot == NULL)
+    {
+        slot = new Slot;
+        slot->destructor = mDestructor;
+        FlsSetValue(mIndex, slot);
+    }
+    slot->value = value;
+}
+
+void WINAPI ThreadLocal::Release(void* p)
+{
+    Slot* slot = (Slot*)p;
+    if (slot->value != NULL && slot->destructor != NULL)
+        slot->destructor(slot->value);
+    delete slot;
+}
+
+#else
+
+Mutex::Mutex()              { pthread_mutex_init(&mHandle, NULL); }
+Mutex::~Mutex()             { pthread_mutex_destroy(&mHandle); }
+void Mutex::Lock()          { pthread_mutex_lock(&mHandle); }
+void Mutex::Unlock()        { pthread_mutex_unlock(&mHandle); }
+
+Condition::Condition()      { pthread_cond_init(&mHandle, NULL); }
+Condition::~Condition()     { pthread_cond_destroy(&mHandle); }
+void Condition::Wait(Mutex& mutex) { pthread_cond_wait(&mHandle, &mutex.mHandle); }
+void Condition::Signal()    { pthread_cond_signal(&mHandle); }
+void Condition::Broadcast() { pthread_cond_broadcast(&mHandle); }
+
+long AtomicAdd(volatile long* target, long value)
+{
+    return __sync_add_and_fetch(target, value);
+}
+
+long GetCurrentThreadNumber()
+{
+#ifdef __linux__
+    return (long)syscall(SYS_gettid);
+#else
+    return (long)pthread_self();
+#endif
+}
+
+ThreadLocal::ThreadLocal(Destructor destructor)
+{
+    pthread_key_create(&mKey, destructor);
+}
+
+ThreadLocal::~ThreadLocal()
+{
+    pthread_key_delete(mKey);
+}
+
+void* ThreadLocal::Get() const
+{
+    return pthread_getspecific(mKey);
+}
+
+void ThreadLocal::Set(void* value)
+{
+    pthread_setspecific(mKey, value);
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+ThreadPool::ThreadPool(int threadCount)
+:mRunning(0)
+,mStopping(false)
+{
+    if (threadCount <= 0)
+        threadCount = GetCoreCount();
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+#ifdef _WIN32
+        HANDLE thread = (HANDLE)_beginthreadex(NULL, 0, ThreadEntry, this, 0, NULL);
+        if (thread != 0)
+            mThreads.push_back(thread);
+#else
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, ThreadEntry, this) == 0)
+            mThreads.push_back(thread);
+#endif
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    Wait();
+
+    mMutex.Lock();
+    mStopping = true;
+    mTaskReady.Broadcast();
+    mMutex.Unlock();
+
+    for (int i = 0; i < mThreads.size(); ++i)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(mThreads[i], INFINITE);
+        CloseHandle(mThreads[i]);
+#else
+        pthread_join(mThreads[i], NULL);
+#endif
+    }
+}
+
+void ThreadPool::Submit(Task* task)
+{
+    // Without a thread to run it, run it right away.
+    if (mThreads.empty())
+    {
+        task->Run();
+        return;
+    }
+
+    ScopedLock lock(mMutex);
+    mQueue.push_back(task);
+    mTaskReady.Signal();
+}
+
+void ThreadPool::Wait()
+{
+    ScopedLock lock(mMutex);
+    while (!mQueue.empty() || mRunning > 0)
+        mAllDone.Wait(mMutex);
+}
+
+void ThreadPool::WorkerLoop()
+{
+    mMutex.Lock();
+    for (;;)
+    {
+        while (mQueue.empty() && !mStopping)
+            mTaskReady.Wait(mMutex);
+
+        if (mQueue.empty())
+            break;
+
+        Task* task = mQueue.front();
+        mQueue.pop_front();
+        ++mRunning;
+
+        mMutex.Unlock();
+        task->Run();
+        mMutex.Lock();
+
+        --mRunning;
+        if (mQueue.empty() && mRunning == 0)
+            mAllDone.Broadcast();
+    }
+    mMutex.Unlock();
+}
+
+#ifdef _WIN32
+unsigned __stdcall ThreadPool::ThreadEntry(void* pool)
+{
+    ((ThreadPool*)pool)->WorkerLoop();
+    return 0;
+}
+#else
+void* ThreadPool::ThreadEntry(void* pool)
+{
+    ((ThreadPool*)pool)->WorkerLoop();
+    return NULL;
+}
+#endif
+
+int ThreadPool::GetCoreCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
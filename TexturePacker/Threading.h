@@ -0,0 +1,168 @@
+#ifndef _THREADING_H_
+#define _THREADING_H_
+
+#include <vector>
+#include <deque>
+
+#ifdef _WIN32
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600     // Condition variables need Vista or later.
+#endif
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+class Mutex
+{
+public:
+    Mutex();
+    ~Mutex();
+
+    void Lock();
+    void Unlock();
+
+private:
+    friend class Condition;
+
+#ifdef _WIN32
+    CRITICAL_SECTION mHandle;
+#else
+    pthread_mutex_t mHandle;
+#endif
+
+    Mutex(const Mutex&);
+    Mutex& operator=(const Mutex&);
+};
+
+class ScopedLock
+{
+public:
+    explicit ScopedLock(Mutex& mutex) : mMutex(mutex) { mMutex.Lock(); }
+    ~ScopedLock() { mMutex.Unlock(); }
+
+private:
+    Mutex& mMutex;
+
+    ScopedLock(const ScopedLock&);
+    ScopedLock& operator=(const ScopedLock&);
+};
+
+class Condition
+{
+public:
+    Condition();
+    ~Condition();
+
+    // The mutex must be locked by the caller, it is released while waiting.
+    void Wait(Mutex& mutex);
+    void Signal();
+    void Broadcast();
+
+private:
+#ifdef _WIN32
+    CONDITION_VARIABLE mHandle;
+#else
+    pthread_cond_t mHandle;
+#endif
+
+    Condition(const Condition&);
+    Condition& operator=(const Condition&);
+};
+
+// Adds value to *target atomically and returns the new value.
+long AtomicAdd(volatile long* target, long value);
+
+// Identifies the calling thread among the running ones.
+long GetCurrentThreadNumber();
+
+// A pointer with a value of its own in every thread, NULL until the thread sets it. When a thread
+// ends, the destructor is called with its value if that is not NULL.
+class ThreadLocal
+{
+public:
+    typedef void (*Destructor)(void* value);
+
+    explicit ThreadLocal(Destructor destructor);
+    ~ThreadLocal();
+
+    void* Get() const;
+    void Set(void* value);
+
+private:
+#ifdef _WIN32
+    // Fiber local storage calls back with the value alone when a thread ends, so every thread
+    // gets a Slot with the destructor next to its value.
+    struct Slot
+    {
+        void* value;
+        Destructor destructor;
+    };
+
+    static void WINAPI Release(void* slot);
+
+    DWORD mIndex;
+    Destructor mDestructor;
+#else
+    pthread_key_t mKey;
+#endif
+
+    ThreadLocal(const ThreadLocal&);
+    ThreadLocal& operator=(const ThreadLocal&);
+};
+
+// A unit of work for the ThreadPool.
+class Task
+{
+public:
+    virtual ~Task() {}
+    virtual void Run() = 0;
+};
+
+// A fixed set of worker threads running the submitted tasks in order.
+class ThreadPool
+{
+public:
+
+    // threadCount <= 0 starts one thread per core.
+    explicit ThreadPool(int threadCount);
+
+    // Runs whatever is still queued, then stops the threads.
+    ~ThreadPool();
+
+    // The pool does not take ownership of the task, it must stay alive until Wait() returns.
+    void Submit(Task* task);
+
+    // Blocks until every submitted task has run.
+    void Wait();
+
+    int GetThreadCount() const { return (int)mThreads.size(); }
+
+    static int GetCoreCount();
+
+private:
+
+    void WorkerLoop();
+
+#ifdef _WIN32
+    static unsigned __stdcall ThreadEntry(void* pool);
+    std::vector<HANDLE> mThreads;
+#else
+    static void* ThreadEntry(void* pool);
+    std::vector<pthread_t> mThreads;
+#endif
+
+    Mutex mMutex;
+    Condition mTaskReady;
+    Condition mAllDone;
+    std::deque<Task*> mQueue;
+    int mRunning;
+    bool mStopping;
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif
@@ -0,0 +1,958 @@
+//  Microbenchmarks of the hot paths: packing, overlap tests, bounding polygons, compositing and
+//  PNG encoding/decoding, on synthetic sprites (rectangles, discs and shapes with a corner cut
+//  along a diagonal). Built by WeTexturePackerBench, see PrintUsage() for the options.
+//
+//  Every benchmark runs until it has taken at least --min-time seconds and reports, per operation,
+//  the time and the C++ heap allocations (operator new), along with sprites/s and MB/s of
+//  pixels where they make sense.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <new>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../AtlasBuilder.h"
+#include "../BoundingGenerator.h"
+#include "../MyPngWriter.h"
+#include "../Platform.h"
+#include "../Threading.h"
+
+bool IsPointInside(const SpriteInfo& sprite, int x, int y);
+
+//////////////////////////////////////////////////////////////////////////
+
+static volatile long sAllocations = 0;
+
+void* operator new(size_t size)
+{
+    AtomicAdd(&sAllocations, 1);
+    void* p = malloc(size > 0 ? size : 1);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) throw()
+{
+    free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+    free(p);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// Same sequence on every platform, unlike rand().
+class Random
+{
+public:
+
+    explicit Random(unsigned int seed) : mState(seed) {}
+
+    int Next(int from, int to)
+    {
+        mState = mState * 1103515245 + 12345;
+        return from + (int)((mState >> 8) % (unsigned int)(to - from + 1));
+    }
+
+private:
+
+    unsigned int mState;
+};
+
+enum SpriteShape
+{
+    SHAPE_RECTANGLE,
+    SHAPE_DISC,
+    SHAPE_DIAGONAL,
+
+    SHAPE_COUNT
+};
+
+// Plots a sprite of the given shape, opaque inside and transparent black outside.
+// Row and column 0 are left alone, MyPngWriter does not plot there.
+void DrawShape(MyPngWriter& image, SpriteShape shape, int w, int h, int seed)
+{
+    double cx = w / 2.0, cy = h / 2.0;
+
+    for (int y = 1; y < h; ++y)
+    {
+        for (int x = 1; x < w; ++x)
+        {
+            bool inside = true;
+            if (shape == SHAPE_DISC)
+            {
+                double dx = (x - cx) / cx, dy = (y - cy) / cy;
+                inside = dx * dx + dy * dy <= 1.0;
+            }
+            else if (shape == SHAPE_DIAGONAL)
+            {
+                inside = x * h + y * w >= w * h / 2;
+            }
+
+            if (inside)
+                image.plot(x, y, (x * 7 + seed) & 255, (y * 13) & 255, (x + y + seed) & 255, 255);
+        }
+    }
+}
+
+// Sprite images of every shape, sizes from minSize to maxSize, with their bounding polygons.
+struct SpriteSet
+{
+    std::vector<MyPngWriter*> images;
+    std::vector<SpriteInfo> shapes;
+    std::vector<std::string> names;
+    double pixelBytes;
+
+    SpriteSet(int count, int minSize, int maxSize)
+    :pixelBytes(0)
+    {
+        Random random(count);
+        names.reserve(count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            int w = random.Next(minSize, maxSize);
+            int h = random.Next(minSize, maxSize);
+
+            MyPngWriter* image = new MyPngWriter(w, h, 0, "");
+            DrawShape(*image, (SpriteShape)(i % SHAPE_COUNT), w, h, i);
+            images.push_back(image);
+            pixelBytes += 4.0 * w * h;
+
+            char name[32];
+            sprintf(name, "sprite%d.png", i);
+            names.push_back(name);
+
+            BoundingGenerator boundGen;
+            SpriteInfo info = boundGen.GenerateMoreCompactBounding(image);
+            info.x = info.y = -1;
+            info.fitted = false;
+            info.userData = (void*)&names.back();
+            shapes.push_back(info);
+        }
+    }
+
+    ~SpriteSet()
+    {
+        for (int i = 0; i < images.size(); ++i)
+            delete images[i];
+    }
+
+    // count sprites made of the shapes of this set, each one with a userData of its own.
+    void Repeat(int count, std::vector<SpriteInfo>& sprites) const
+    {
+        sprites.clear();
+        sprites.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            sprites.push_back(shapes[i % shapes.size()]);
+            sprites.back().userData = (void*)(size_t)(i + 1);
+        }
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+class Benchmark
+{
+public:
+
+    virtual ~Benchmark() {}
+
+    // Called before every Run(), not timed.
+    virtual void Setup() {}
+
+    virtual void Run() = 0;
+};
+
+struct BenchmarkResult
+{
+    double seconds;                 // Per run.
+    double allocations;             // Per run.
+};
+
+BenchmarkResult Measure(Benchmark& benchmark, double minTime)
+{
+    double total = 0;
+    long allocations = 0;
+    int runs = 0;
+
+    do
+    {
+        benchmark.Setup();
+
+        long allocationsBefore = sAllocations;
+        double start = GetTimeInSeconds();
+        benchmark.Run();
+        total += GetTimeInSeconds() - start;
+        allocations += sAllocations - allocationsBefore;
+
+        ++runs;
+    }
+    while (total < minTime);
+
+    BenchmarkResult result;
+    result.seconds = total / runs;
+    result.allocations = (double)allocations / runs;
+    return result;
+}
+
+// ops: operations in one run, sprites and bytes: handled by one run, 0 if meaningless.
+void Report(const char* name, int count, const BenchmarkResult& result, double ops, double sprites, double bytes)
+{
+    printf("%-28s %8d %14.1f", name, count, result.seconds * 1e9 / ops);
+
+    if (sprites > 0)
+        printf(" %14.0f", sprites / result.seconds);
+    else
+        printf(" %14s", "-");
+
+    if (bytes > 0)
+        printf(" %10.1f", bytes / result.seconds / (1024 * 1024));
+    else
+        printf(" %10s", "-");
+
+    printf(" %12.2f\n", result.allocations / ops);
+    fflush(stdout);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// Side of a square texture with room for the sprites, at most MAX_TEXTURE_SIZE.
+int GetTextureSize(const std::vector<SpriteInfo>& sprites)
+{
+    double area = 0;
+    for (int i = 0; i < sprites.size(); ++i)
+        area += (double)sprites[i].srcW * sprites[i].srcH;
+
+    int size = (int)sqrt(area * 1.3) + 1;
+    return size < MAX_TEXTURE_SIZE ? size : MAX_TEXTURE_SIZE;
+}
+
+class PackBenchmark : public Benchmark
+{
+public:
+
+    PackBenchmark(const SpriteSet& set, int count)
+    {
+        set.Repeat(count, mTemplate);
+        mSize = GetTextureSize(mTemplate);
+    }
+
+    virtual void Setup()
+    {
+        mSprites = mTemplate;
+    }
+
+    virtual void Run()
+    {
+        TexturePacker packer(mSize, mSize);
+        packer.Pack(mSprites);
+    }
+
+private:
+
+    std::vector<SpriteInfo> mTemplate;
+    std::vector<SpriteInfo> mSprites;
+    int mSize;
+};
+
+// Exposes the overlap test of the packer.
+class OverlapProbe : public TexturePacker
+{
+public:
+
+    OverlapProbe() : TexturePacker(MAX_TEXTURE_SIZE, MAX_TEXTURE_SIZE) {}
+
+    bool Test(const SpriteInfo& a, const SpriteInfo& b) { return NotOverlap(a, b); }
+};
+
+// Every sprite of a packed texture against its neighbours in packing order, so that both the quick
+// bounding box rejections and the polygon tests are measured, in their real proportions.
+class NotOverlapBenchmark : public Benchmark
+{
+public:
+
+    enum { NEIGHBOURS = 64 };
+
+    NotOverlapBenchmark(const SpriteSet& set, int count)
+    :mResult(0)
+    {
+        set.Repeat(count, mSprites);
+
+        TexturePacker packer(GetTextureSize(mSprites), GetTextureSize(mSprites));
+        packer.Pack(mSprites);
+    }
+
+    virtual void Run()
+    {
+        int n = mSprites.size();
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 1; j <= NEIGHBOURS; ++j)
+                mResult += mProbe.Test(mSprites[i], mSprites[(i + j) % n]);
+        }
+    }
+
+    double GetOps() const { return (double)mSprites.size() * NEIGHBOURS; }
+
+private:
+
+    OverlapProbe mProbe;
+    std::vector<SpriteInfo> mSprites;
+    long mResult;
+};
+
+// Exposes the first stage of the bounding polygon generation.
+class BoundingProbe : public BoundingGenerator
+{
+public:
+
+    void FindBoundingPixelsOf(MyPngWriter* image)
+    {
+        mPngFile = image;
+        FindBoundingPixels();
+        mPngFile = NULL;
+    }
+};
+
+class FindBoundingPixelsBenchmark : public Benchmark
+{
+public:
+
+    explicit FindBoundingPixelsBenchmark(const SpriteSet& set) : mSet(set) {}
+
+    virtual void Run()
+    {
+        for (int i = 0; i < mSet.images.size(); ++i)
+            mProbe.FindBoundingPixelsOf(mSet.images[i]);
+    }
+
+private:
+
+    const SpriteSet& mSet;
+    BoundingProbe mProbe;
+};
+
+// FindBoundingPixels() followed by TryCutCorner() on the 4 corners.
+class BoundingBenchmark : public Benchmark
+{
+public:
+
+    explicit BoundingBenchmark(const SpriteSet& set) : mSet(set) {}
+
+    virtual void Run()
+    {
+        for (int i = 0; i < mSet.images.size(); ++i)
+        {
+            BoundingGenerator boundGen;
+            boundGen.GenerateMoreCompactBounding(mSet.images[i]);
+        }
+    }
+
+private:
+
+    const SpriteSet& mSet;
+};
+
+// The IsPointInside() test alone, over every pixel of the bounding box of each sprite.
+class IsPointInsideBenchmark : public Benchmark
+{
+public:
+
+    explicit IsPointInsideBenchmark(const SpriteSet& set)
+    :mSet(set)
+    ,mInside(0)
+    {
+    }
+
+    virtual void Run()
+    {
+        for (int i = 0; i < mSet.shapes.size(); ++i)
+        {
+            SpriteInfo info = mSet.shapes[i];
+            info.x = info.y = 0;
+
+            for (int y = 0; y < info.srcH; ++y)
+                for (int x = 0; x < info.srcW; ++x)
+                    mInside += IsPointInside(info, x, y);
+        }
+    }
+
+private:
+
+    const SpriteSet& mSet;
+    long mInside;
+};
+
+// DrawSprite() of every sprite of a packed texture onto a tiled canvas.
+class ComposeBenchmark : public Benchmark
+{
+public:
+
+    // The packed texture is written to path by close().
+    ComposeBenchmark(const SpriteSet& set, const char* path)
+    :mSet(set)
+    ,mPath(path)
+    ,mCanvas(NULL)
+    {
+        mSprites = set.shapes;
+        mSize = GetTextureSize(mSprites);
+
+        TexturePacker packer(mSize, mSize);
+        packer.Pack(mSprites);
+    }
+
+    ~ComposeBenchmark()
+    {
+        delete mCanvas;
+    }
+
+    virtual void Setup()
+    {
+        delete mCanvas;
+        mCanvas = new MyPngWriter(mSize, mSize, mPath, CANVAS_TILE_SIZE);
+    }
+
+    virtual void Run()
+    {
+        for (int i = 0; i < mSprites.size(); ++i)
+        {
+            const SpriteInfo& info = mSprites[i];
+            if (info.fitted)
+            {
+                int index = (int)((std::string*)info.userData - &mSet.names[0]);
+                DrawSprite(*mCanvas, *mSet.images[index], info, 0, mSize, false);
+            }
+        }
+    }
+
+    // The packed texture, for the encoding benchmarks.
+    MyPngWriter* GetCanvas() { return mCanvas; }
+
+    int GetSize() const { return mSize; }
+
+private:
+
+    const SpriteSet& mSet;
+    const char* mPath;
+    std::vector<SpriteInfo> mSprites;
+    MyPngWriter* mCanvas;
+    int mSize;
+};
+
+class CloseBenchmark : public Benchmark
+{
+public:
+
+    // encodeThreads, filterStrategy and compressionLevel as for MyPngWriter::setencodethreads(),
+    // setfilterstrategy() and setcompressionlevel().
+    CloseBenchmark(const SpriteSet& set, const char* path, int encodeThreads, int filterStrategy = PNGWRITER_FILTER_ADAPTIVE,
+                   int compressionLevel = PNGWRITER_DEFAULT_COMPRESSION)
+    :mCompose(set, path)
+    ,mEncodeThreads(encodeThreads)
+    ,mFilterStrategy(filterStrategy)
+    ,mCompressionLevel(compressionLevel)
+    {
+    }
+
+    virtual void Setup()
+    {
+        // close() frees the tiles, so the texture is composed again, untimed.
+        mCompose.Setup();
+        mCompose.Run();
+        mCompose.GetCanvas()->setreleaseonclose(true);
+        mCompose.GetCanvas()->setencodethreads(mEncodeThreads);
+        mCompose.GetCanvas()->setfilterstrategy(mFilterStrategy);
+        mCompose.GetCanvas()->setcompressionlevel(mCompressionLevel);
+    }
+
+    virtual void Run()
+    {
+        mCompose.GetCanvas()->close();
+    }
+
+    double GetBytes() const { return 4.0 * mCompose.GetSize() * mCompose.GetSize(); }
+
+private:
+
+    ComposeBenchmark mCompose;
+    int mEncodeThreads;
+    int mFilterStrategy;
+    int mCompressionLevel;
+};
+
+// png_filter_row() with each of the 5 filters on every row of every sprite, as adaptive filtering does,
+// at the PNG_SIMD_ level given.
+class FilterRowBenchmark : public Benchmark
+{
+public:
+
+    FilterRowBenchmark(const SpriteSet& set, int simdLevel)
+    :mSet(set)
+    ,mSimdLevel(simdLevel)
+    {
+    }
+
+    // Back to the best level the CPU has, for the benchmarks that follow.
+    ~FilterRowBenchmark()
+    {
+        png_simd_support(PNG_SIMD_AVX2);
+    }
+
+    virtual void Setup()
+    {
+        png_simd_support(mSimdLevel);
+    }
+
+    virtual void Run()
+    {
+        for (int i = 0; i < mSet.images.size(); ++i)
+        {
+            MyPngWriter* image = mSet.images[i];
+            png_uint_32 rowBytes = 4 * image->getwidth();
+            mOut.resize(rowBytes);
+            mZeros.assign(rowBytes, 0);
+
+            png_bytep prev = &mZeros[0];
+            for (int y = 0; y < image->getheight(); ++y)
+            {
+                png_bytep row = (png_bytep)image->row(y);
+                for (int filter = PNG_FILTER_VALUE_NONE; filter < PNG_FILTER_VALUE_LAST; ++filter)
+                    png_filter_row(filter, &mOut[0], row, prev, rowBytes, 4);
+                prev = row;
+            }
+        }
+    }
+
+private:
+
+    const SpriteSet& mSet;
+    int mSimdLevel;
+    std::vector<png_byte> mOut, mZeros;
+};
+
+typedef uLong (*Checksum)(uLong value, const Bytef* buf, uInt len);
+
+const int ZLIB_SIMD_ALL = Z_SIMD_SSE2 | Z_SIMD_SSSE3 | Z_SIMD_PCLMUL | Z_SIMD_AVX2;
+
+// checksum, crc32() or adler32(), over the pixels of every sprite, with the zlibSimdSupport() mask given.
+class ChecksumBenchmark : public Benchmark
+{
+public:
+
+    ChecksumBenchmark(const SpriteSet& set, Checksum checksum, int simdMask)
+    :mSet(set)
+    ,mChecksum(checksum)
+    ,mSimdMask(simdMask)
+    ,mValue(0)
+    {
+    }
+
+    ~ChecksumBenchmark()
+    {
+        zlibSimdSupport(ZLIB_SIMD_ALL);
+    }
+
+    virtual void Setup()
+    {
+        zlibSimdSupport(mSimdMask);
+    }
+
+    virtual void Run()
+    {
+        for (int i = 0; i < mSet.images.size(); ++i)
+        {
+            MyPngWriter* image = mSet.images[i];
+            uInt rowBytes = 4 * image->getwidth();
+            for (int y = 0; y < image->getheight(); ++y)
+                mValue = mChecksum(mValue, (const Bytef*)image->row(y), rowBytes);
+        }
+    }
+
+private:
+
+    const SpriteSet& mSet;
+    Checksum mChecksum;
+    int mSimdMask;
+    uLong mValue;
+};
+
+// Compares checksum with the zlibSimdSupport() mask given to the C code, on pieces of every length
+// up to a few NMAX blocks, at every alignment, starting from random values, with runs of 0xff
+// bytes for the largest sums. Returns the number of pieces that differ.
+int CheckChecksum(Checksum checksum, int simdMask)
+{
+    Random random(simdMask);
+    std::vector<Bytef> data(3 * 5552 + 64);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = (Bytef)(i % 3 == 0 ? 0xff : random.Next(0, 255));
+
+    int differences = 0;
+    for (int i = 0; i < 2000; ++i)
+    {
+        uInt offset = random.Next(0, 63);
+        uInt len = random.Next(0, (int)data.size() - 64);
+        uLong start = (uLong)random.Next(0, 65520) | ((uLong)random.Next(0, 65520) << 16);
+
+        zlibSimdSupport(0);
+        uLong expected = checksum(start, &data[offset], len);
+        zlibSimdSupport(simdMask);
+        if (checksum(start, &data[offset], len) != expected)
+            ++differences;
+    }
+
+    zlibSimdSupport(ZLIB_SIMD_ALL);
+    return differences;
+}
+
+class ReadFromFileBenchmark : public Benchmark
+{
+public:
+
+    // Decoded at the PNG_SIMD_ level given, the best one the CPU has by default.
+    explicit ReadFromFileBenchmark(const char* path, int simdLevel = PNG_SIMD_AVX2)
+    :mPath(path)
+    ,mSimdLevel(simdLevel)
+    {
+    }
+
+    ~ReadFromFileBenchmark()
+    {
+        png_simd_support(PNG_SIMD_AVX2);
+    }
+
+    virtual void Setup()
+    {
+        png_simd_support(mSimdLevel);
+    }
+
+    virtual void Run()
+    {
+        MyPngWriter image(1, 1, 0, "");
+        image.readfromfile(mPath);
+    }
+
+private:
+
+    const char* mPath;
+    int mSimdLevel;
+};
+
+// readfromfile() of every sprite of a set, each one written to a file of its own first, the way
+// the sprites of a packed texture are read.
+class ReadSpritesBenchmark : public Benchmark
+{
+public:
+
+    explicit ReadSpritesBenchmark(const SpriteSet& set)
+    :mSet(set)
+    {
+        for (int i = 0; i < set.images.size(); ++i)
+        {
+            int w = set.images[i]->getwidth(), h = set.images[i]->getheight();
+            MyPngWriter image(w, h, 0, set.names[i].c_str());
+            DrawShape(image, (SpriteShape)(i % SHAPE_COUNT), w, h, i);
+            image.close();
+        }
+    }
+
+    ~ReadSpritesBenchmark()
+    {
+        for (int i = 0; i < mSet.names.size(); ++i)
+            remove(mSet.names[i].c_str());
+    }
+
+    virtual void Run()
+    {
+        MyPngWriter image(1, 1, 0, "");
+        for (int i = 0; i < mSet.names.size(); ++i)
+            image.readfromfile(mSet.names[i].c_str());
+    }
+
+private:
+
+    const SpriteSet& mSet;
+};
+
+// Writes the 8 bits RGBA image at from to path as PNG_COLOR_TYPE_PALETTE, with a 3-3-2 bits palette
+// and index 0 transparent, or PNG_COLOR_TYPE_GRAY_ALPHA, for the decoders of the other colour types.
+bool WriteConvertedPng(const char* from, const char* path, int colorType)
+{
+    MyPngWriter image(1, 1, 0, "");
+    image.readfromfile(from);
+    int w = image.getwidth(), h = image.getheight();
+
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL)
+        return false;
+
+    png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (setjmp(png_jmpbuf(png_ptr)))
+    {
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        fclose(fp);
+        return false;
+    }
+
+    png_init_io(png_ptr, fp);
+    png_set_IHDR(png_ptr, info_ptr, w, h, 8, colorType, PNG_INTERLACE_NONE,
+        PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+
+    if (colorType == PNG_COLOR_TYPE_PALETTE)
+    {
+        png_color palette[256];
+        png_byte trans = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            palette[i].red = (png_byte)((i >> 5) * 255 / 7);
+            palette[i].green = (png_byte)(((i >> 2) & 7) * 255 / 7);
+            palette[i].blue = (png_byte)((i & 3) * 255 / 3);
+        }
+        png_set_PLTE(png_ptr, info_ptr, palette, 256);
+        png_set_tRNS(png_ptr, info_ptr, &trans, 1, NULL);
+    }
+    png_write_info(png_ptr, info_ptr);
+
+    int channels = colorType == PNG_COLOR_TYPE_PALETTE ? 1 : 2;
+    std::vector<png_byte> out(w * channels);
+    for (int y = 0; y < h; ++y)
+    {
+        const unsigned char* p = image.row(y);
+        for (int x = 0; x < w; ++x, p += 4)
+        {
+            if (colorType == PNG_COLOR_TYPE_PALETTE)
+            {
+                // Index 0 is black, only the transparent pixels get it.
+                int index = (p[0] & 0xe0) | ((p[1] >> 3) & 0x1c) | (p[2] >> 6);
+                out[x] = (png_byte)(p[3] == 0 ? 0 : (index == 0 ? 1 : index));
+            }
+            else
+            {
+                out[2 * x] = (png_byte)((p[0] + p[1] + p[2]) / 3);
+                out[2 * x + 1] = p[3];
+            }
+        }
+        png_write_row(png_ptr, &out[0]);
+    }
+
+    png_write_end(png_ptr, info_ptr);
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+    fclose(fp);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void PrintUsage()
+{
+    std::cout << "Usage:\n"
+              << "    WeTexturePackerBench {--counts N,N,...} {--min-time Seconds} {--max-pack-time Seconds}\n"
+              << "    --counts          Sprite counts of the packing benchmarks, 100,1000,10000,100000 by default.\n"
+              << "    --min-time        How long each benchmark runs at least, 0.5 by default.\n"
+              << "    --max-pack-time   Packing benchmarks expected to take longer than this are skipped,\n"
+              << "                      estimated from the previous count, 60 by default.\n";
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<int> counts;
+    double minTime = 0.5;
+    double maxPackTime = 60;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--counts" && i + 1 < argc)
+        {
+            for (const char* p = argv[++i]; *p; )
+            {
+                counts.push_back(atoi(p));
+                while (*p && *p != ',') ++p;
+                if (*p == ',') ++p;
+            }
+        }
+        else if (arg == "--min-time" && i + 1 < argc)
+        {
+            minTime = atof(argv[++i]);
+        }
+        else if (arg == "--max-pack-time" && i + 1 < argc)
+        {
+            maxPackTime = atof(argv[++i]);
+        }
+        else
+        {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    if (counts.empty())
+    {
+        counts.push_back(100);
+        counts.push_back(1000);
+        counts.push_back(10000);
+        counts.push_back(100000);
+    }
+
+    const char* pngPath = "WeTexturePackerBench.png";
+
+    // Sprites in the size range of the usual UI and character sprites.
+    SpriteSet set(300, 8, 128);
+
+    printf("%-28s %8s %14s %14s %10s %12s\n", "Benchmark", "N", "ns/op", "sprites/s", "MB/s", "allocs/op");
+
+    bool failed = false;
+    double lastPackTime = 0, growth = 2;
+    int lastCount = 0;
+    for (int i = 0; i < counts.size(); ++i)
+    {
+        int count = counts[i];
+
+        // Packing grows faster than linearly with the sprite count, at the rate seen between the last two counts.
+        double estimate = lastCount > 0 ? lastPackTime * pow((double)count / lastCount, growth) : 0;
+        if (estimate > maxPackTime)
+        {
+            printf("%-28s %8d   skipped, estimated %.0f s, see --max-pack-time\n", "Pack", count, estimate);
+            continue;
+        }
+
+        PackBenchmark pack(set, count);
+        BenchmarkResult result = Measure(pack, minTime);
+        Report("Pack", count, result, count, count, 0);
+        if (lastCount > 0 && count != lastCount)
+            growth = log(result.seconds / lastPackTime) / log((double)count / lastCount);
+        lastPackTime = result.seconds;
+        lastCount = count;
+
+        NotOverlapBenchmark notOverlap(set, count);
+        Report("NotOverlap", count, Measure(notOverlap, minTime), notOverlap.GetOps(), 0, 0);
+    }
+
+    int spriteCount = set.images.size();
+    double pixelBytes = set.pixelBytes;
+
+    FindBoundingPixelsBenchmark findBoundingPixels(set);
+    Report("FindBoundingPixels", spriteCount, Measure(findBoundingPixels, minTime), spriteCount, spriteCount, pixelBytes);
+
+    BoundingBenchmark bounding(set);
+    Report("GenerateMoreCompactBounding", spriteCount, Measure(bounding, minTime), spriteCount, spriteCount, pixelBytes);
+
+    IsPointInsideBenchmark isPointInside(set);
+    Report("IsPointInside (per pixel)", spriteCount, Measure(isPointInside, minTime), pixelBytes / 4, 0, pixelBytes);
+
+    ComposeBenchmark compose(set, pngPath);
+    Report("DrawSprite", spriteCount, Measure(compose, minTime), spriteCount, spriteCount, pixelBytes);
+
+    CloseBenchmark close(set, pngPath, 1);
+    Report("MyPngWriter::close", 1, Measure(close, minTime), 1, 0, close.GetBytes());
+
+    // Encoded on one thread per core.
+    char closeName[64];
+    sprintf(closeName, "MyPngWriter::close x%d", ThreadPool::GetCoreCount());
+    CloseBenchmark parallelClose(set, pngPath, 0);
+    Report(closeName, 1, Measure(parallelClose, minTime), 1, 0, parallelClose.GetBytes());
+
+    CloseBenchmark fixedClose(set, pngPath, 1, PNGWRITER_FILTER_FIXED);
+    Report("MyPngWriter::close fixed", 1, Measure(fixedClose, minTime), 1, 0, fixedClose.GetBytes());
+
+    CloseBenchmark unfilteredClose(set, pngPath, 1, PNGWRITER_FILTER_NONE);
+    Report("MyPngWriter::close none", 1, Measure(unfilteredClose, minTime), 1, 0, unfilteredClose.GetBytes());
+
+    CloseBenchmark fastClose(set, pngPath, 1, PNGWRITER_FILTER_ADAPTIVE, 1);
+    Report("MyPngWriter::close level 1", 1, Measure(fastClose, minTime), 1, 0, fastClose.GetBytes());
+
+    CloseBenchmark quickClose(set, pngPath, 1, PNGWRITER_FILTER_ADAPTIVE, PNGWRITER_COMPRESSION_QUICK);
+    Report("MyPngWriter::close quick", 1, Measure(quickClose, minTime), 1, 0, quickClose.GetBytes());
+
+    // Up to the best vector instructions the CPU has.
+    const char* simdNames[] = { "png_filter_row C", "png_filter_row SSE2", "png_filter_row SSSE3", "png_filter_row AVX2" };
+    int simdLevel = png_simd_support(-1);
+    for (int level = PNG_SIMD_NONE; level <= simdLevel; ++level)
+    {
+        // Nothing of its own at SSSE3 level.
+        if (level == PNG_SIMD_SSSE3)
+            continue;
+
+        FilterRowBenchmark filterRow(set, level);
+        Report(simdNames[level], spriteCount, Measure(filterRow, minTime), spriteCount, spriteCount, pixelBytes);
+    }
+
+    // The vector code of zlib against its C code, then both timed.
+    struct ChecksumRun
+    {
+        const char* name;
+        Checksum checksum;
+        int simdMask;
+    };
+    const ChecksumRun checksumRuns[] = { { "crc32 slice-by-8", crc32, 0 },
+                                         { "crc32 PCLMUL", crc32, Z_SIMD_PCLMUL },
+                                         { "adler32 C", adler32, 0 },
+                                         { "adler32 SSSE3", adler32, Z_SIMD_SSSE3 },
+                                         { "adler32 AVX2", adler32, Z_SIMD_SSSE3 | Z_SIMD_AVX2 } };
+    int zlibSimd = zlibSimdSupport(-1);
+    for (int i = 0; i < sizeof(checksumRuns) / sizeof(checksumRuns[0]); ++i)
+    {
+        const ChecksumRun& run = checksumRuns[i];
+        if ((zlibSimd & run.simdMask) != run.simdMask)
+            continue;
+
+        int differences = run.simdMask != 0 ? CheckChecksum(run.checksum, run.simdMask) : 0;
+        if (differences > 0)
+        {
+            printf("%-28s %d of 2000 checks differ from the C code\n", run.name, differences);
+            failed = true;
+            continue;
+        }
+
+        ChecksumBenchmark checksum(set, run.checksum, run.simdMask);
+        Report(run.name, spriteCount, Measure(checksum, minTime), spriteCount, spriteCount, pixelBytes);
+    }
+
+    ReadFromFileBenchmark read(pngPath);
+    Report("MyPngWriter::readfromfile", 1, Measure(read, minTime), 1, 0, close.GetBytes());
+
+    // Without checking the chunk CRCs, as with --no-crc.
+    MyPngWriter::setcrccheck(false);
+    ReadFromFileBenchmark readNoCrc(pngPath);
+    Report("readfromfile no crc", 1, Measure(readNoCrc, minTime), 1, 0, close.GetBytes());
+    MyPngWriter::setcrccheck(true);
+
+    // Unfiltered by the C code.
+    ReadFromFileBenchmark readC(pngPath, PNG_SIMD_NONE);
+    Report("MyPngWriter::readfromfile C", 1, Measure(readC, minTime), 1, 0, close.GetBytes());
+
+    ReadSpritesBenchmark readSprites(set);
+    Report("readfromfile sprites", spriteCount, Measure(readSprites, minTime), spriteCount, spriteCount, pixelBytes);
+
+    // The same texture in the other colour types, expanded to RGBA on the way in.
+    const char* convertedPath = "WeTexturePackerBench2.png";
+    const int colorTypes[] = { PNG_COLOR_TYPE_PALETTE, PNG_COLOR_TYPE_GRAY_ALPHA };
+    const char* convertedNames[][2] = { { "readfromfile palette", "readfromfile palette C" },
+                                        { "readfromfile gray+alpha", "readfromfile gray+alpha C" } };
+    for (int i = 0; i < 2; ++i)
+    {
+        if (!WriteConvertedPng(pngPath, convertedPath, colorTypes[i]))
+            continue;
+
+        ReadFromFileBenchmark readConverted(convertedPath);
+        Report(convertedNames[i][0], 1, Measure(readConverted, minTime), 1, 0, close.GetBytes());
+
+        ReadFromFileBenchmark readConvertedC(convertedPath, PNG_SIMD_NONE);
+        Report(convertedNames[i][1], 1, Measure(readConvertedC, minTime), 1, 0, close.GetBytes());
+    }
+
+    remove(convertedPath);
+    remove(pngPath);
+    return failed ? -1 : 0;
+}
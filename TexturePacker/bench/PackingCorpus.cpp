@@ -0,0 +1,455 @@
+//  Runs the packer over a corpus of recorded sprite sets (the .sprites files written by --data, or the
+//  .capture files written by --capture, sizes and polygons without any pixels) and reports, for every set, backend and order,
+//  how long packing took and how well it packed:
+//
+//  - pages:      packed textures of the recorded size needed to hold every sprite that fits at all,
+//  - unfitted:   sprites larger than an empty texture,
+//  - occupancy:  pixels covered by the sprite polygons over the pixels of the pages, in percent. Only
+//                the rectangle around the sprites of the last page counts, so a tighter packing shows
+//                even when it does not save a page.
+//
+//  The results can be written as CSV, and compared against a CSV written earlier: a packing that
+//  needs more pages, leaves more sprites out, loses more occupancy or takes longer than the
+//  thresholds allow is reported as a regression, and the exit code is 1.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include "../AtlasMetadataWriter.h"
+#include "../TexturePacker.h"
+#include "../PackCapture.h"
+#include "../Platform.h"
+
+enum PackBackend
+{
+    BACKEND_POLYGON,                // The sprites as their bounding polygons, as the packer is used.
+    BACKEND_RECTANGLE,              // The bounding rectangles of the polygons.
+
+    BACKEND_COUNT
+};
+
+const char* const BACKEND_NAMES[BACKEND_COUNT] = { "polygon", "rectangle" };
+
+struct CorpusResult
+{
+    std::string set;
+    std::string backend;
+    std::string order;
+    int sprites;
+    int pages;
+    int unfitted;
+    double occupancy;               // Percent.
+    double time;                    // Milliseconds for packing every page.
+};
+
+inline int Gcd(int a, int b)
+{
+    a = abs(a);
+    b = abs(b);
+    while (b != 0)
+    {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Pixels inside or on the polygon, which is what DrawSprite() copies. With integer vertices,
+// that is area + boundary / 2 + 1 (Pick's theorem).
+double CountPolygonPixels(const std::vector<CPoint>& vertex)
+{
+    int n = vertex.size();
+    if (n < 3)
+        return 0;
+
+    double twiceArea = 0;
+    int boundary = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        const CPoint& p0 = vertex[i];
+        const CPoint& p1 = vertex[(i + 1) % n];
+        twiceArea += (double)p0.x * p1.y - (double)p1.x * p0.y;
+        boundary += Gcd(p1.x - p0.x, p1.y - p0.y);
+    }
+
+    return fabs(twiceArea) / 2 + boundary / 2.0 + 1;
+}
+
+// The bounding rectangle of the polygon of the sprite, with no corner cut.
+void MakeRectangle(SpriteInfo& sprite)
+{
+    if (sprite.vertex.empty())
+        return;
+
+    int left = sprite.vertex[0].x, right = left;
+    int top = sprite.vertex[0].y, bottom = top;
+    for (int i = 1; i < sprite.vertex.size(); ++i)
+    {
+        left = std::min(left, sprite.vertex[i].x);
+        right = std::max(right, sprite.vertex[i].x);
+        top = std::min(top, sprite.vertex[i].y);
+        bottom = std::max(bottom, sprite.vertex[i].y);
+    }
+
+    CPoint corners[4] = { {left, top}, {left, bottom}, {right, bottom}, {right, top} };
+    sprite.vertex.assign(corners, corners + 4);
+    sprite.shapeMask = 0;
+}
+
+// The rectangle around the polygons of the fitted sprites.
+double GetUsedArea(const std::vector<SpriteInfo>& sprites)
+{
+    int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+    for (int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInfo& sprite = sprites[i];
+        if (!sprite.fitted)
+            continue;
+
+        for (int j = 0; j < sprite.vertex.size(); ++j)
+        {
+            left = std::min(left, sprite.x + sprite.vertex[j].x);
+            right = std::max(right, sprite.x + sprite.vertex[j].x);
+            top = std::min(top, sprite.y + sprite.vertex[j].y);
+            bottom = std::max(bottom, sprite.y + sprite.vertex[j].y);
+        }
+    }
+
+    return left <= right ? (double)(right - left + 1) * (bottom - top + 1) : 0;
+}
+
+// Packs the sprites on as many pages as it takes. Returns the pixels of the sprites left out,
+// and in usedArea the pixels of the full pages plus the used part of the last one.
+double PackPages(const std::vector<SpriteInfo>& sprites, const std::map<void*, double>& pixels,
+    int width, int height, PackOrder order, int& pages, int& unfitted, double& usedArea)
+{
+    std::vector<SpriteInfo> remaining = sprites;
+    pages = 0;
+    unfitted = 0;
+    usedArea = 0;
+
+    while (!remaining.empty())
+    {
+        TexturePacker packer(width, height, order);
+        packer.Pack(remaining);
+
+        std::vector<SpriteInfo> next;
+        for (int i = 0; i < remaining.size(); ++i)
+        {
+            if (!remaining[i].fitted)
+            {
+                next.push_back(remaining[i]);
+                next.back().x = next.back().y = -1;
+            }
+        }
+
+        // What does not fit on an empty page never will.
+        if (next.size() == remaining.size())
+            break;
+
+        usedArea = (double)width * height * pages + GetUsedArea(remaining);
+        ++pages;
+        remaining.swap(next);
+    }
+
+    double leftOut = 0;
+    for (int i = 0; i < remaining.size(); ++i)
+        leftOut += pixels.find(remaining[i].userData)->second;
+
+    unfitted = remaining.size();
+    return leftOut;
+}
+
+CorpusResult RunSet(const std::string& setName, const std::vector<SpriteInfo>& recorded, int width, int height,
+    PackBackend backend, PackOrder order, double minTime)
+{
+    std::map<void*, double> pixels;
+    double totalPixels = 0;
+    for (int i = 0; i < recorded.size(); ++i)
+    {
+        double count = CountPolygonPixels(recorded[i].vertex);
+        pixels[recorded[i].userData] = count;
+        totalPixels += count;
+    }
+
+    std::vector<SpriteInfo> sprites = recorded;
+    if (backend == BACKEND_RECTANGLE)
+    {
+        for (int i = 0; i < sprites.size(); ++i)
+            MakeRectangle(sprites[i]);
+    }
+
+    CorpusResult result;
+    result.set = setName;
+    result.backend = BACKEND_NAMES[backend];
+    result.order = TexturePacker::GetOrderName(order);
+    result.sprites = sprites.size();
+
+    // Small sets are packed again until the time is long enough to be measured.
+    double leftOut = 0, usedArea = 0, total = 0;
+    int runs = 0;
+    do
+    {
+        double start = GetTimeInSeconds();
+        leftOut = PackPages(sprites, pixels, width, height, order, result.pages, result.unfitted, usedArea);
+        total += GetTimeInSeconds() - start;
+        ++runs;
+    }
+    while (total < minTime);
+
+    result.time = total * 1000 / runs;
+    result.occupancy = usedArea > 0 ? 100 * (totalPixels - leftOut) / usedArea : 0;
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+const char* const CSV_HEADER = "set,backend,order,sprites,pages,unfitted,occupancy,time_ms";
+
+inline bool HasSuffix(const std::string& name, const std::string& suffix)
+{
+    return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Reads a .sprites or a .capture file, the name of the set is the file name without the extension.
+bool ReadSpriteSet(const std::string& dir, const std::string& name, std::string& setName, int& width, int& height,
+    std::vector<SpriteInfo>& sprites, std::vector<std::string>& spriteNames)
+{
+    std::string path = dir + "/" + name;
+
+    if (HasSuffix(name, ".sprites"))
+    {
+        std::ifstream in(path.c_str());
+        setName = name.substr(0, name.size() - 8);
+        return ReadSpriteDescriptors(in, width, height, sprites, spriteNames);
+    }
+
+    if (HasSuffix(name, ".capture"))
+    {
+        // Every order is tried anyway, the recorded one does not matter.
+        std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+        PackOrder order;
+        setName = name.substr(0, name.size() - 8);
+        return ReadPackCapture(in, width, height, order, sprites, spriteNames);
+    }
+
+    return false;
+}
+
+inline std::string GetResultKey(const CorpusResult& result)
+{
+    return result.set + "," + result.backend + "," + result.order;
+}
+
+bool WriteResults(const std::string& path, const std::vector<CorpusResult>& results)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == NULL)
+    {
+        perror(path.c_str());
+        return false;
+    }
+
+    fprintf(file, "%s\n", CSV_HEADER);
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const CorpusResult& r = results[i];
+        fprintf(file, "%s,%s,%s,%d,%d,%d,%.3f,%.3f\n", r.set.c_str(), r.backend.c_str(), r.order.c_str(),
+            r.sprites, r.pages, r.unfitted, r.occupancy, r.time);
+    }
+
+    return fclose(file) == 0;
+}
+
+bool ReadResults(const std::string& path, std::map<std::string, CorpusResult>& results)
+{
+    std::ifstream in(path.c_str());
+    std::string line;
+    if (!std::getline(in, line) || line.compare(0, strlen(CSV_HEADER), CSV_HEADER) != 0)
+    {
+        std::cerr << "Not a corpus result file: " << path << "\n";
+        return false;
+    }
+
+    while (std::getline(in, line))
+    {
+        std::vector<std::string> fields;
+        std::istringstream tokens(line);
+        std::string field;
+        while (std::getline(tokens, field, ','))
+            fields.push_back(field);
+
+        if (fields.size() < 8)
+            continue;
+
+        CorpusResult r;
+        r.set = fields[0];
+        r.backend = fields[1];
+        r.order = fields[2];
+        r.sprites = atoi(fields[3].c_str());
+        r.pages = atoi(fields[4].c_str());
+        r.unfitted = atoi(fields[5].c_str());
+        r.occupancy = atof(fields[6].c_str());
+        r.time = atof(fields[7].c_str());
+        results[GetResultKey(r)] = r;
+    }
+
+    return true;
+}
+
+// Timings below this many milliseconds are too noisy to compare.
+const double MIN_COMPARED_TIME = 1.0;
+
+int CompareResults(const std::vector<CorpusResult>& results, const std::map<std::string, CorpusResult>& baseline,
+    double maxTimeIncrease, double maxOccupancyDrop)
+{
+    int regressions = 0;
+
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const CorpusResult& r = results[i];
+        std::map<std::string, CorpusResult>::const_iterator it = baseline.find(GetResultKey(r));
+        if (it == baseline.end())
+            continue;
+
+        const CorpusResult& b = it->second;
+        std::ostringstream problems;
+
+        if (r.pages > b.pages)
+            problems << " pages " << b.pages << " -> " << r.pages;
+        if (r.unfitted > b.unfitted)
+            problems << " unfitted " << b.unfitted << " -> " << r.unfitted;
+        if (r.occupancy < b.occupancy - maxOccupancyDrop)
+            problems << " occupancy " << b.occupancy << "% -> " << r.occupancy << "%";
+        if (b.time >= MIN_COMPARED_TIME && r.time > b.time * (1 + maxTimeIncrease / 100))
+            problems << " time " << b.time << " ms -> " << r.time << " ms";
+
+        if (!problems.str().empty())
+        {
+            printf("REGRESSION %s:%s\n", GetResultKey(r).c_str(), problems.str().c_str());
+            ++regressions;
+        }
+    }
+
+    return regressions;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void PrintUsage()
+{
+    std::cout << "Usage:\n"
+              << "    WeTexturePackerCorpus CorpusDir {Options}\n"
+              << "    Packs every .sprites file (written with --data Name.sprites) and .capture file\n"
+              << "    (written with --capture Name.capture) of CorpusDir with each backend and order,\n"
+              << "    and reports the time and quality of the packing.\n"
+              << "Options:\n"
+              << "    --out File                  Write the results as CSV.\n"
+              << "    --baseline File             Compare against results written earlier with --out.\n"
+              << "    --max-time-increase Pct     Slow down tolerated against the baseline, 25% by default.\n"
+              << "    --max-occupancy-drop Pts    Occupancy loss tolerated, 0.5 percentage points by default.\n"
+              << "    --min-time Seconds          Repeat the packing of small sets for this long, 0.2 by default.\n"
+              << "    --size WxH                  Pack on textures of this size instead of the recorded one.\n";
+}
+
+int main(int argc, char** argv)
+{
+    std::string corpusDir, outPath, baselinePath;
+    double maxTimeIncrease = 25, maxOccupancyDrop = 0.5, minTime = 0.2;
+    int width = 0, height = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--out" && hasValue)
+            outPath = argv[++i];
+        else if (arg == "--baseline" && hasValue)
+            baselinePath = argv[++i];
+        else if (arg == "--max-time-increase" && hasValue)
+            maxTimeIncrease = atof(argv[++i]);
+        else if (arg == "--max-occupancy-drop" && hasValue)
+            maxOccupancyDrop = atof(argv[++i]);
+        else if (arg == "--min-time" && hasValue)
+            minTime = atof(argv[++i]);
+        else if (arg == "--size" && hasValue && sscanf(argv[++i], "%dx%d", &width, &height) == 2)
+            continue;
+        else if (arg.compare(0, 2, "--") != 0 && corpusDir.empty())
+            corpusDir = arg;
+        else
+        {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    std::vector<std::string> names;
+    if (corpusDir.empty() || !ListDirectory(corpusDir, names))
+    {
+        PrintUsage();
+        return -1;
+    }
+    std::sort(names.begin(), names.end());
+
+    std::vector<CorpusResult> results;
+
+    printf("%-24s %-10s %-12s %8s %6s %9s %10s %12s\n",
+        "Set", "Backend", "Order", "Sprites", "Pages", "Unfitted", "Occupancy", "Time(ms)");
+
+    for (int i = 0; i < names.size(); ++i)
+    {
+        const std::string& name = names[i];
+        if (!HasSuffix(name, ".sprites") && !HasSuffix(name, ".capture"))
+            continue;
+
+        std::string setName;
+        std::vector<SpriteInfo> sprites;
+        std::vector<std::string> spriteNames;
+        int recordedWidth, recordedHeight;
+        if (!ReadSpriteSet(corpusDir, name, setName, recordedWidth, recordedHeight, sprites, spriteNames))
+        {
+            std::cerr << "Cannot read sprite set " << name << "\n";
+            continue;
+        }
+
+        for (int backend = 0; backend < BACKEND_COUNT; ++backend)
+        {
+            for (int order = 0; order < ORDER_COUNT; ++order)
+            {
+                CorpusResult r = RunSet(setName, sprites, width > 0 ? width : recordedWidth, height > 0 ? height : recordedHeight,
+                    (PackBackend)backend, (PackOrder)order, minTime);
+                results.push_back(r);
+
+                printf("%-24s %-10s %-12s %8d %6d %9d %9.2f%% %12.2f\n", r.set.c_str(), r.backend.c_str(), r.order.c_str(),
+                    r.sprites, r.pages, r.unfitted, r.occupancy, r.time);
+                fflush(stdout);
+            }
+        }
+    }
+
+    if (!outPath.empty() && !WriteResults(outPath, results))
+        return -1;
+
+    if (!baselinePath.empty())
+    {
+        std::map<std::string, CorpusResult> baseline;
+        if (!ReadResults(baselinePath, baseline))
+            return -1;
+
+        int regressions = CompareResults(results, baseline, maxTimeIncrease, maxOccupancyDrop);
+        printf("\n%d regressions against %s\n", regressions, baselinePath.c_str());
+        return regressions > 0 ? 1 : 0;
+    }
+
+    return 0;
+}
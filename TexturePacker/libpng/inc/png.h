@@ -487,9 +487,6 @@ PNG_EXPORT_VAR (const int FARDATA) png_pass_ystart[7];
 PNG_EXPORT_VAR (const int FARDATA) png_pass_yinc[7];
 PNG_EXPORT_VAR (const int FARDATA) png_pass_mask[7];
 PNG_EXPORT_VAR (const int FARDATA) png_pass_dsp_mask[7];
-#ifdef PNG_USE_PNGGCCRD
-PNG_EXPORT_VAR (const int FARDATA) png_pass_width[7];
-#endif
 /* This isn't currently used.  If you need it, see png.c for more details.
 PNG_EXPORT_VAR (const int FARDATA) png_pass_height[7];
 */
@@ -1345,7 +1342,7 @@ struct png_struct_def
    png_byte filter_type;
 #endif
 
-#if defined(PNG_1_0_X) || (defined(PNG_DEBUG) && defined(PNG_USE_PNGGCCRD))
+#if defined(PNG_1_0_X)
 /* New member added in libpng-1.0.10, ifdef'ed out in 1.2.0 */
    png_uint_32 row_buf_size;
 #endif
@@ -1353,10 +1350,6 @@ struct png_struct_def
 /* New members added in libpng-1.2.0 */
 #if defined(PNG_ASSEMBLER_CODE_SUPPORTED)
 #  if !defined(PNG_1_0_X)
-#    if defined(PNG_MMX_CODE_SUPPORTED)
-   png_byte     mmx_bitdepth_threshold;
-   png_uint_32  mmx_rowbytes_threshold;
-#    endif
    png_uint_32  asm_flags;
 #  endif
 #endif
@@ -1388,6 +1381,11 @@ struct png_struct_def
    png_uint_32 user_height_max;
 #endif
 
+#if defined(PNG_READ_EXPAND_SUPPORTED)
+   png_bytep palette_rgba;           /* palette and tRNS as RGBA, for */
+                                     /* the vector expansion */
+#endif
+
 };
 
 
@@ -1697,6 +1695,19 @@ extern PNG_EXPORT(void,png_read_image) PNGARG((png_structp png_ptr,
    png_bytepp image));
 #endif
 
+#ifndef PNG_NO_SEQUENTIAL_READ_SUPPORTED
+/* Read the whole image from its compressed data already in memory: data
+ * holds the contents of all the IDAT chunks one after the other, size bytes,
+ * which are inflated in a single call into one buffer of filtered rows, then
+ * unfiltered in place and transformed into image, a row every stride bytes.
+ * The data is not read through png_ptr, so png_read_end() cannot follow.
+ * Returns 0, leaving png_ptr as it was for png_read_row(), when the image is
+ * interlaced, rows were already read, or data is not exactly the image.
+ */
+extern PNG_EXPORT(int,png_read_image_whole) PNGARG((png_structp png_ptr,
+   png_bytep image, png_size_t stride, png_bytep data, png_size_t size));
+#endif
+
 /* write a row of image data */
 extern PNG_EXPORT(void,png_write_row) PNGARG((png_structp png_ptr,
    png_bytep row));
@@ -1796,6 +1807,17 @@ extern PNG_EXPORT(void,png_set_filter) PNGARG((png_structp png_ptr, int method,
 #define PNG_FILTER_VALUE_PAETH 4
 #define PNG_FILTER_VALUE_LAST  5
 
+/* Filter row_bytes bytes of row, bpp bytes to a pixel, with filter_type (one
+ * of the values above) against prev_row into out, without the filter type
+ * byte, and return the sum of the filtered bytes taken as signed values: the
+ * measure the default heuristic picks the smallest of.  prev_row, the row
+ * above or zeros for the first one, is only read by Up, Avg and Paeth, and
+ * out may be row for None.  Uses SSE2 or AVX2 when the CPU has them.
+ */
+extern PNG_EXPORT(png_uint_32,png_filter_row) PNGARG((int filter_type,
+   png_bytep out, png_bytep row, png_bytep prev_row, png_uint_32 row_bytes,
+   png_uint_32 bpp));
+
 #if defined(PNG_WRITE_WEIGHTED_FILTER_SUPPORTED) /* EXPERIMENTAL */
 /* The "heuristic_method" is given by one of the PNG_FILTER_HEURISTIC_
  * defines, either the default (minimum-sum-of-absolute-differences), or
@@ -2498,36 +2520,10 @@ extern PNG_EXPORT(png_uint_32,png_permit_mng_features) PNGARG((png_structp
 #define PNG_HANDLE_CHUNK_IF_SAFE      2
 #define PNG_HANDLE_CHUNK_ALWAYS       3
 
-/* Added to version 1.2.0 */
+/* Added to version 1.2.0.  There is no MMX code any more (see pngconf.h),
+ * these functions report none and ignore what they are given.
+ */
 #if defined(PNG_ASSEMBLER_CODE_SUPPORTED)
-#if defined(PNG_MMX_CODE_SUPPORTED)
-#define PNG_ASM_FLAG_MMX_SUPPORT_COMPILED  0x01  /* not user-settable */
-#define PNG_ASM_FLAG_MMX_SUPPORT_IN_CPU    0x02  /* not user-settable */
-#define PNG_ASM_FLAG_MMX_READ_COMBINE_ROW  0x04
-#define PNG_ASM_FLAG_MMX_READ_INTERLACE    0x08
-#define PNG_ASM_FLAG_MMX_READ_FILTER_SUB   0x10
-#define PNG_ASM_FLAG_MMX_READ_FILTER_UP    0x20
-#define PNG_ASM_FLAG_MMX_READ_FILTER_AVG   0x40
-#define PNG_ASM_FLAG_MMX_READ_FILTER_PAETH 0x80
-#define PNG_ASM_FLAGS_INITIALIZED          0x80000000  /* not user-settable */
-
-#define PNG_MMX_READ_FLAGS ( PNG_ASM_FLAG_MMX_READ_COMBINE_ROW  \
-                           | PNG_ASM_FLAG_MMX_READ_INTERLACE    \
-                           | PNG_ASM_FLAG_MMX_READ_FILTER_SUB   \
-                           | PNG_ASM_FLAG_MMX_READ_FILTER_UP    \
-                           | PNG_ASM_FLAG_MMX_READ_FILTER_AVG   \
-                           | PNG_ASM_FLAG_MMX_READ_FILTER_PAETH )
-#define PNG_MMX_WRITE_FLAGS ( 0 )
-
-#define PNG_MMX_FLAGS ( PNG_ASM_FLAG_MMX_SUPPORT_COMPILED \
-                      | PNG_ASM_FLAG_MMX_SUPPORT_IN_CPU   \
-                      | PNG_MMX_READ_FLAGS                \
-                      | PNG_MMX_WRITE_FLAGS )
-
-#define PNG_SELECT_READ   1
-#define PNG_SELECT_WRITE  2
-#endif /* PNG_MMX_CODE_SUPPORTED */
-
 #if !defined(PNG_1_0_X)
 /* pngget.c */
 extern PNG_EXPORT(png_uint_32,png_get_mmx_flagmask)
@@ -2561,7 +2557,7 @@ extern PNG_EXPORT(void,png_set_mmx_thresholds)
 #endif /* PNG_1_0_X */
 
 #if !defined(PNG_1_0_X)
-/* png.c, pnggccrd.c, or pngvcrd.c */
+/* png.c, returns -1: not compiled in */
 extern PNG_EXPORT(int,png_mmx_support) PNGARG((void));
 #endif /* PNG_ASSEMBLER_CODE_SUPPORTED */
 
@@ -2584,6 +2580,19 @@ extern PNG_EXPORT(png_uint_32,png_get_user_height_max) PNGARG((png_structp
    png_ptr));
 #endif
 
+/* Vector instruction sets libpng can use, see png_simd_support() */
+#define PNG_SIMD_NONE   0
+#define PNG_SIMD_SSE2   1
+#define PNG_SIMD_SSSE3  2
+#define PNG_SIMD_AVX2   3
+
+/* Returns the vector instruction set libpng uses, a PNG_SIMD_ value: the
+ * best one built in that the CPU and operating system support, limited to
+ * max_level when it is 0 or more, to compare or test the code paths.  The
+ * limit applies to every png_struct.  Pass -1 to only ask.
+ */
+extern PNG_EXPORT(int,png_simd_support) PNGARG((int max_level));
+
 /* Maintainer: Put new public prototypes here ^, in libpng.3, and project defs */
 
 #ifdef PNG_READ_COMPOSITE_NODIV_SUPPORTED
@@ -3165,10 +3174,23 @@ PNG_EXTERN void png_do_write_interlace PNGARG((png_row_infop row_info,
 PNG_EXTERN void png_read_filter_row PNGARG((png_structp png_ptr,
    png_row_infop row_info, png_bytep row, png_bytep prev_row, int filter));
 
+/* Same with SSE2, SSSE3 or AVX2, returns 0 if the C code must do it instead
+ * (pngrsimd.c) */
+PNG_EXTERN int png_read_filter_row_simd PNGARG((png_row_infop row_info,
+   png_bytep row, png_bytep prev_row, int filter));
+
 /* Choose the best filter to use and filter the row data */
 PNG_EXTERN void png_write_find_filter PNGARG((png_structp png_ptr,
    png_row_infop row_info));
 
+/* Same for the unweighted heuristic with png_filter_row(), returns the row
+ * to write (pngwsimd.c) */
+PNG_EXTERN png_bytep png_write_find_filter_simd PNGARG((png_structp png_ptr,
+   png_uint_32 row_bytes, png_uint_32 bpp));
+
+/* The PNG_SIMD_ level png_simd_support() allows (png.c) */
+PNG_EXTERN int png_simd_level PNGARG((void));
+
 /* Write out the filtered row. */
 PNG_EXTERN void png_write_filtered_row PNGARG((png_structp png_ptr,
    png_bytep filtered_row));
@@ -3299,6 +3321,28 @@ PNG_EXTERN void png_do_expand PNGARG((png_row_infop row_info,
    png_bytep row, png_color_16p trans_value));
 #endif
 
+/* Same as the functions above with SSE2, SSSE3 or AVX2 for the layouts that
+ * lead to 8 bit RGBA, return 0 if the C code must do it instead
+ * (pngrtsimd.c) */
+#if defined(PNG_READ_EXPAND_SUPPORTED)
+PNG_EXTERN int png_do_expand_palette_simd PNGARG((png_structp png_ptr,
+   png_row_infop row_info, png_bytep row));
+PNG_EXTERN int png_do_expand_simd PNGARG((png_row_infop row_info,
+   png_bytep row, png_color_16p trans_value));
+#endif
+#if defined(PNG_READ_GRAY_TO_RGB_SUPPORTED)
+PNG_EXTERN int png_do_gray_to_rgb_simd PNGARG((png_row_infop row_info,
+   png_bytep row));
+#endif
+#if defined(PNG_READ_16_TO_8_SUPPORTED)
+PNG_EXTERN int png_do_chop_simd PNGARG((png_row_infop row_info,
+   png_bytep row));
+#endif
+#if defined(PNG_READ_FILLER_SUPPORTED)
+PNG_EXTERN int png_do_read_filler_simd PNGARG((png_row_infop row_info,
+   png_bytep row, png_uint_32 filler, png_uint_32 flags));
+#endif
+
 /* The following decodes the appropriate chunks, and does error correction,
  * then calls the appropriate callback for the chunk if it is valid.
  */
@@ -3464,13 +3508,6 @@ PNG_EXTERN void png_do_write_intrapixel PNGARG((png_row_infop row_info,
    png_bytep row));
 #endif
 
-#if defined(PNG_ASSEMBLER_CODE_SUPPORTED)
-#if defined(PNG_MMX_CODE_SUPPORTED)
-/* png.c */ /* PRIVATE */
-PNG_EXTERN void png_init_mmx_flags PNGARG((png_structp png_ptr));
-#endif
-#endif
-
 #if defined(PNG_INCH_CONVERSIONS) && defined(PNG_FLOATING_POINT_SUPPORTED)
 PNG_EXTERN png_uint_32 png_get_pixels_per_inch PNGARG((png_structp png_ptr,
 png_infop info_ptr));
@@ -723,38 +723,48 @@
 #  define PNG_EASY_ACCESS_SUPPORTED
 #endif
 
-/* PNG_ASSEMBLER_CODE was enabled by default in version 1.2.0 
- * even when PNG_USE_PNGVCRD or PNG_USE_PNGGCCRD is not defined.
+/* PNG_ASSEMBLER_CODE_SUPPORTED only keeps the asm_flags and MMX functions
+ * added to the API in 1.2.0.  The 32-bit MMX assembler behind them
+ * (pnggccrd.c and pngvcrd.c) has been removed: it could not be built for
+ * x86-64, and the SSE2 code below replaces it.  The functions now report
+ * that no MMX code is compiled in, and PNG_NO_MMX_CODE is no longer needed.
  *
- * PNG_NO_ASSEMBLER_CODE disables use of all assembler code and optimized C,
- * and removes or includes several functions in the API.
- *
- * PNG_NO_MMX_CODE disables the use of MMX code without changing the API.
- * When MMX code is off, then optimized C replacement functions are used.
-*/
+ * PNG_NO_ASSEMBLER_CODE removes these functions from the API.
+ */
 #if defined(PNG_READ_SUPPORTED) && !defined(PNG_NO_ASSEMBLER_CODE)
 #  ifndef PNG_ASSEMBLER_CODE_SUPPORTED
 #    define PNG_ASSEMBLER_CODE_SUPPORTED
 #  endif
-#  if defined(XP_MACOSX) && !defined(PNG_NO_MMX_CODE)
-     /* work around Intel-Mac compiler bug */
-#    define PNG_NO_MMX_CODE
-#  endif
-#  if !defined(PNG_MMX_CODE_SUPPORTED) && !defined(PNG_NO_MMX_CODE) && \
-     defined(__MMX__)
-#    define PNG_MMX_CODE_SUPPORTED
-#  endif
-#  if !defined(PNG_USE_PNGGCCRD) && !defined(PNG_NO_MMX_CODE) && \
-     !defined(PNG_USE_PNGVCRD) && defined(__MMX__)
-#    define PNG_USE_PNGGCCRD
-#  endif
+#endif
+#if defined(PNG_MMX_CODE_SUPPORTED) || defined(PNG_USE_PNGGCCRD) || \
+    defined(PNG_USE_PNGVCRD)
+#  error "The MMX code is gone, pngrsimd.c and pngwsimd.c use SSE2 instead"
 #endif
 
-/* If you are sure that you don't need thread safety and you are compiling
-   with PNG_USE_PNGCCRD for an MMX application, you can define this for
-   faster execution.  See pnggccrd.c.
-#define PNG_THREAD_UNSAFE_OK
-*/
+/* Vector code for x86 (SSE2, SSSE3 and AVX2), picked at run time from what
+ * the CPU has by png_simd_level() in png.c, for filtering (pngwsimd.c) and
+ * unfiltering (pngrsimd.c) rows.  PNG_NO_SIMD builds without it; other
+ * processors always use the C code.
+ */
+#if !defined(PNG_NO_SIMD) && !defined(PNG_SIMD_X86_SUPPORTED) && \
+    (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || \
+    defined(_M_X64))
+#  define PNG_SIMD_X86_SUPPORTED
+   /* AVX2 intrinsics need gcc 4.9, clang or Visual C++ 2012 */
+#  if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || \
+      (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || \
+      (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define PNG_SIMD_AVX2_SUPPORTED
+#  endif
+#endif
+#ifdef PNG_SIMD_X86_SUPPORTED
+   /* gcc and clang only let a function use the instructions it is built for */
+#  if defined(__GNUC__)
+#    define PNG_SIMD_TARGET(isa) __attribute__((target(isa)))
+#  else
+#    define PNG_SIMD_TARGET(isa)
+#  endif
+#endif
 
 #if !defined(PNG_1_0_X)
 #if !defined(PNG_NO_USER_MEM) && !defined(PNG_USER_MEM_SUPPORTED)
@@ -1440,47 +1450,6 @@ typedef z_stream FAR *  png_zstreamp;
 #  define PNG_ZBUF_SIZE 65536L
 #endif
 
-#ifdef PNG_READ_SUPPORTED
-/* Prior to libpng-1.0.9, this block was in pngasmrd.h */
-#if defined(PNG_INTERNAL)
-
-/* These are the default thresholds before the MMX code kicks in; if either
- * rowbytes or bitdepth is below the threshold, plain C code is used.  These
- * can be overridden at runtime via the png_set_mmx_thresholds() call in
- * libpng 1.2.0 and later.  The values below were chosen by Intel.
- */
-
-#ifndef PNG_MMX_ROWBYTES_THRESHOLD_DEFAULT
-#  define PNG_MMX_ROWBYTES_THRESHOLD_DEFAULT  128  /*  >=  */
-#endif
-#ifndef PNG_MMX_BITDEPTH_THRESHOLD_DEFAULT
-#  define PNG_MMX_BITDEPTH_THRESHOLD_DEFAULT  9    /*  >=  */   
-#endif
-
-/* Set this in the makefile for VC++ on Pentium, not here. */
-/* Platform must be Pentium.  Makefile must assemble and load pngvcrd.c .
- * MMX will be detected at run time and used if present.
- */
-#ifdef PNG_USE_PNGVCRD
-#  define PNG_HAVE_ASSEMBLER_COMBINE_ROW
-#  define PNG_HAVE_ASSEMBLER_READ_INTERLACE
-#  define PNG_HAVE_ASSEMBLER_READ_FILTER_ROW
-#endif
-
-/* Set this in the makefile for gcc/as on Pentium, not here. */
-/* Platform must be Pentium.  Makefile must assemble and load pnggccrd.c .
- * MMX will be detected at run time and used if present.
- */
-#ifdef PNG_USE_PNGGCCRD
-#  define PNG_HAVE_ASSEMBLER_COMBINE_ROW
-#  define PNG_HAVE_ASSEMBLER_READ_INTERLACE
-#  define PNG_HAVE_ASSEMBLER_READ_FILTER_ROW
-#endif
-/* - see pnggccrd.c for info about what is currently enabled */
-
-#endif /* PNG_INTERNAL */
-#endif /* PNG_READ_SUPPORTED */
-
 /* Added at libpng-1.2.8 */
 #endif /* PNG_VERSION_INFO_ONLY */
 
@@ -67,11 +67,6 @@ const int FARDATA png_pass_ystart[] = {0, 0, 4, 0, 2, 0, 1};
 /* offset to next interlace block in the y direction */
 const int FARDATA png_pass_yinc[] = {8, 8, 8, 4, 4, 2, 2};
 
-/* width of interlace block (used in assembler routines only) */
-#ifdef PNG_HAVE_ASSEMBLER_COMBINE_ROW
-const int FARDATA png_pass_width[] = {8, 4, 4, 2, 2, 1, 1};
-#endif
-
 /* Height of interlace block.  This is not currently used - if you need
  * it, uncomment it here and in png.h
 const int FARDATA png_pass_height[] = {8, 8, 4, 4, 2, 2, 1};
@@ -778,66 +773,117 @@ png_access_version_number(void)
    return((png_uint_32) PNG_LIBPNG_VER);
 }
 
+#if defined(PNG_SIMD_X86_SUPPORTED)
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
 
-#if defined(PNG_READ_SUPPORTED) && defined(PNG_ASSEMBLER_CODE_SUPPORTED)
-#if !defined(PNG_1_0_X)
-#if defined(PNG_MMX_CODE_SUPPORTED)
-/* this INTERNAL function was added to libpng 1.2.0 */
-void /* PRIVATE */
-png_init_mmx_flags (png_structp png_ptr)
+static void
+png_cpuid(unsigned int leaf, unsigned int regs[4])
 {
-    if(png_ptr == NULL) return;
-    png_ptr->mmx_rowbytes_threshold = 0;
-    png_ptr->mmx_bitdepth_threshold = 0;
+#  if defined(_MSC_VER)
+   int r[4];
+   __cpuidex(r, (int)leaf, 0);
+   regs[0] = (unsigned int)r[0]; regs[1] = (unsigned int)r[1];
+   regs[2] = (unsigned int)r[2]; regs[3] = (unsigned int)r[3];
+#  else
+   regs[0] = regs[1] = regs[2] = regs[3] = 0;
+   if (leaf <= __get_cpuid_max(0, 0))
+      __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#  endif
+}
 
-#  if (defined(PNG_USE_PNGVCRD) || defined(PNG_USE_PNGGCCRD))
+#  if defined(PNG_SIMD_AVX2_SUPPORTED)
+/* Whether the operating system saves the AVX registers (XCR0 bits 1 and 2) */
+static int
+png_os_saves_ymm(void)
+{
+#    if defined(_MSC_VER)
+   return (_xgetbv(0) & 6) == 6;
+#    else
+   unsigned int lo, hi;
+   /* xgetbv, spelled out for assemblers that don't know it */
+   __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0"
+      : "=a" (lo), "=d" (hi) : "c" (0));
+   return (lo & 6) == 6;
+#    endif
+}
+#  endif
 
-    png_ptr->asm_flags |= PNG_ASM_FLAG_MMX_SUPPORT_COMPILED;
+static int
+png_detect_simd(void)
+{
+   unsigned int regs[4];
+   int level = PNG_SIMD_NONE;
 
-    if (png_mmx_support() > 0) {
-        png_ptr->asm_flags |= PNG_ASM_FLAG_MMX_SUPPORT_IN_CPU
-#    ifdef PNG_HAVE_ASSEMBLER_COMBINE_ROW
-                              | PNG_ASM_FLAG_MMX_READ_COMBINE_ROW
-#    endif
-#    ifdef PNG_HAVE_ASSEMBLER_READ_INTERLACE
-                              | PNG_ASM_FLAG_MMX_READ_INTERLACE
-#    endif
-#    ifndef PNG_HAVE_ASSEMBLER_READ_FILTER_ROW
-                              ;
-#    else
-                              | PNG_ASM_FLAG_MMX_READ_FILTER_SUB
-                              | PNG_ASM_FLAG_MMX_READ_FILTER_UP
-                              | PNG_ASM_FLAG_MMX_READ_FILTER_AVG
-                              | PNG_ASM_FLAG_MMX_READ_FILTER_PAETH ;
+   png_cpuid(0, regs);
+   if (regs[0] < 1)
+      return level;
 
-        png_ptr->mmx_rowbytes_threshold = PNG_MMX_ROWBYTES_THRESHOLD_DEFAULT;
-        png_ptr->mmx_bitdepth_threshold = PNG_MMX_BITDEPTH_THRESHOLD_DEFAULT;
-#    endif
-    } else {
-        png_ptr->asm_flags &= ~( PNG_ASM_FLAG_MMX_SUPPORT_IN_CPU
-                               | PNG_MMX_READ_FLAGS
-                               | PNG_MMX_WRITE_FLAGS );
-    }
+   png_cpuid(1, regs);
+   if (regs[3] & (1U << 26))
+      level = PNG_SIMD_SSE2;
+   if (level == PNG_SIMD_SSE2 && (regs[2] & (1U << 9)))
+      level = PNG_SIMD_SSSE3;
+
+#  if defined(PNG_SIMD_AVX2_SUPPORTED)
+   /* AVX2 needs OSXSAVE and AVX on leaf 1 as well as leaf 7 ebx bit 5 */
+   if (level == PNG_SIMD_SSSE3 && (regs[2] & (1U << 27)) &&
+       (regs[2] & (1U << 28)) && png_os_saves_ymm())
+   {
+      png_cpuid(7, regs);
+      if (regs[1] & (1U << 5))
+         level = PNG_SIMD_AVX2;
+   }
+#  endif
 
-#  else /* !(PNGVCRD || PNGGCCRD) */
+   return level;
+}
+#endif /* PNG_SIMD_X86_SUPPORTED */
 
-    /* clear all MMX flags; no support is compiled in */
-    png_ptr->asm_flags &= ~( PNG_MMX_FLAGS );
+/* -1 until the CPU has been asked, then what it supports and the caller
+ * allows.  Every thread computes the same value, so the race is harmless.
+ */
+static int png_simd_detected = -1;
+static int png_simd_max_level = PNG_SIMD_AVX2;
 
-#  endif /* ?(PNGVCRD || PNGGCCRD) */
+int /* PRIVATE */
+png_simd_level(void)
+{
+   if (png_simd_detected < 0)
+   {
+#if defined(PNG_SIMD_X86_SUPPORTED)
+      png_simd_detected = png_detect_simd();
+#else
+      png_simd_detected = PNG_SIMD_NONE;
+#endif
+   }
+   return png_simd_detected < png_simd_max_level ?
+      png_simd_detected : png_simd_max_level;
+}
+
+/* This function was added to libpng-1.2.16 */
+int PNGAPI
+png_simd_support(int max_level)
+{
+   if (max_level >= 0)
+      png_simd_max_level = max_level;
+   return png_simd_level();
 }
 
-#endif /* !(PNG_MMX_CODE_SUPPORTED) */
 
-/* this function was added to libpng 1.2.0 */
-#if !defined(PNG_USE_PNGGCCRD) && \
-    !(defined(PNG_MMX_CODE_SUPPORTED) && defined(PNG_USE_PNGVCRD))
+#if defined(PNG_READ_SUPPORTED) && defined(PNG_ASSEMBLER_CODE_SUPPORTED)
+#if !defined(PNG_1_0_X)
+/* this function was added to libpng 1.2.0.  The MMX code it reported on
+ * has been replaced by SSE2, see png_simd_support().
+ */
 int PNGAPI
 png_mmx_support(void)
 {
     return -1;
 }
-#endif
 #endif /* PNG_1_0_X  && PNG_ASSEMBLER_CODE_SUPPORTED */
 #endif /* PNG_READ_SUPPORTED */
 
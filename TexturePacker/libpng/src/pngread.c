@@ -55,12 +55,6 @@ png_create_read_struct_2(png_const_charp user_png_ver, png_voidp error_ptr,
    if (png_ptr == NULL)
       return (NULL);
 
-#if !defined(PNG_1_0_X)
-#ifdef PNG_MMX_CODE_SUPPORTED
-   png_init_mmx_flags(png_ptr);   /* 1.2.0 addition */
-#endif
-#endif /* PNG_1_0_X */
-
    /* added at libpng-1.2.6 */
 #ifdef PNG_SET_USER_LIMITS_SUPPORTED
    png_ptr->user_width_max=PNG_USER_WIDTH_MAX;
@@ -907,6 +901,129 @@ png_read_image(png_structp png_ptr, png_bytepp image)
 }
 #endif /* PNG_NO_SEQUENTIAL_READ_SUPPORTED */
 
+#ifndef PNG_NO_SEQUENTIAL_READ_SUPPORTED
+/* Read the entire image from the IDAT data the application already has in
+ * memory.  Going through png_read_row() inflates a row at a time out of
+ * zbuf, and zlib copies everything it writes into its window on each call
+ * to keep the stream going.  Here one inflate() with Z_FINISH writes all the
+ * filtered rows and needs no window, then each row is unfiltered against the
+ * one before it in the same buffer.
+ */
+int PNGAPI
+png_read_image_whole(png_structp png_ptr, png_bytep image, png_size_t stride,
+   png_bytep data, png_size_t size)
+{
+   z_stream zs;
+   png_bytep rows, row, prev_row;
+   png_size_t row_size, rows_size;
+   png_uint_32 i;
+   int ret, transform;
+
+   png_debug(1, "in png_read_image_whole\n");
+   if (png_ptr == NULL || image == NULL || data == NULL)
+      return 0;
+
+   if (!(png_ptr->flags & PNG_FLAG_ROW_INIT))
+      png_read_start_row(png_ptr);
+   if (png_ptr->interlaced || png_ptr->row_number != 0 ||
+      !(png_ptr->mode & PNG_HAVE_IDAT) || png_ptr->zstream.total_in != 0)
+      return 0;
+
+   /* Each row with its filter type byte, all of them fitting zlib's counts */
+   row_size = png_ptr->irowbytes;
+   if (png_ptr->height > (png_uint_32)((uInt)-1 / row_size) ||
+      size > (png_size_t)(uInt)-1)
+      return 0;
+   rows_size = row_size * png_ptr->height;
+
+   rows = (png_bytep)png_malloc_warn(png_ptr, (png_uint_32)rows_size);
+   if (rows == NULL)
+      return 0;
+
+   zs.zalloc = png_zalloc;
+   zs.zfree = png_zfree;
+   zs.opaque = (voidpf)png_ptr;
+   zs.next_in = data;
+   zs.avail_in = (uInt)size;
+   if (inflateInit(&zs) != Z_OK)
+   {
+      png_free(png_ptr, rows);
+      return 0;
+   }
+   zs.next_out = rows;
+   zs.avail_out = (uInt)rows_size;
+   ret = inflate(&zs, Z_FINISH);
+   inflateEnd(&zs);
+
+   /* Like png_read_row(), which would report these as errors */
+   if (ret != Z_STREAM_END || zs.avail_out || zs.avail_in)
+   {
+      png_free(png_ptr, rows);
+      return 0;
+   }
+
+   for (i = 0; i < png_ptr->height; i++)
+      if (rows[i * row_size] > PNG_FILTER_VALUE_PAETH)
+      {
+         png_free(png_ptr, rows);
+         return 0;
+      }
+
+   png_ptr->mode |= PNG_AFTER_IDAT;
+   png_ptr->flags |= PNG_FLAG_ZLIB_FINISHED;
+
+   transform = png_ptr->transformations ||
+      (png_ptr->flags&PNG_FLAG_STRIP_ALPHA);
+#if defined(PNG_MNG_FEATURES_SUPPORTED)
+   if((png_ptr->mng_features_permitted & PNG_FLAG_MNG_FILTER_64) &&
+      (png_ptr->filter_type == PNG_INTRAPIXEL_DIFFERENCING))
+      transform = 1;
+#endif
+
+   prev_row = png_ptr->prev_row;
+   for (i = 0; i < png_ptr->height; i++, image += stride)
+   {
+      row = rows + i * row_size;
+
+      png_ptr->row_info.color_type = png_ptr->color_type;
+      png_ptr->row_info.width = png_ptr->iwidth;
+      png_ptr->row_info.channels = png_ptr->channels;
+      png_ptr->row_info.bit_depth = png_ptr->bit_depth;
+      png_ptr->row_info.pixel_depth = png_ptr->pixel_depth;
+      png_ptr->row_info.rowbytes = row_size - 1;
+
+      if (row[0])
+         png_read_filter_row(png_ptr, &(png_ptr->row_info), row + 1,
+            prev_row + 1, (int)(row[0]));
+      prev_row = row;
+
+      if (transform)
+      {
+         /* The transformations work in row_buf, which has room for them */
+         png_memcpy(png_ptr->row_buf, row, row_size);
+#if defined(PNG_MNG_FEATURES_SUPPORTED)
+         if((png_ptr->mng_features_permitted & PNG_FLAG_MNG_FILTER_64) &&
+            (png_ptr->filter_type == PNG_INTRAPIXEL_DIFFERENCING))
+            png_do_read_intrapixel(&(png_ptr->row_info), png_ptr->row_buf + 1);
+#endif
+         if (png_ptr->transformations ||
+            (png_ptr->flags&PNG_FLAG_STRIP_ALPHA))
+            png_do_read_transformations(png_ptr);
+         png_combine_row(png_ptr, image, 0xff);
+      }
+      else
+         png_memcpy(image, row + 1, row_size - 1);
+
+      png_read_finish_row(png_ptr);
+      if (png_ptr->read_row_fn != NULL)
+         (*(png_ptr->read_row_fn))(png_ptr, png_ptr->row_number, 0);
+   }
+
+   png_free(png_ptr, rows);
+   return 1;
+}
+#endif /* PNG_NO_SEQUENTIAL_READ_SUPPORTED */
+
 #ifndef PNG_NO_SEQUENTIAL_READ_SUPPORTED
 /* Read the end of the PNG file.  Will not read past the end of the
  * file, will verify the end is accurate, and will read any comments
@@ -1193,6 +1310,9 @@ png_read_destroy(png_structp png_ptr, png_infop info_ptr, png_infop end_info_ptr
 #if defined(PNG_READ_GAMMA_SUPPORTED)
    png_free(png_ptr, png_ptr->gamma_table);
 #endif
+#if defined(PNG_READ_EXPAND_SUPPORTED)
+   png_free(png_ptr, png_ptr->palette_rgba);
+#endif
 #if defined(PNG_READ_BACKGROUND_SUPPORTED)
    png_free(png_ptr, png_ptr->gamma_from_1);
    png_free(png_ptr, png_ptr->gamma_to_1);
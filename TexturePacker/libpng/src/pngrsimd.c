@@ -0,0 +1,262 @@
+/* pngrsimd.c - row unfiltering for PNG readers with SSE2, SSSE3 and AVX2
+ *
+ * For conditions of distribution and use, see copyright notice in png.h
+ *
+ * png_read_filter_row_simd() undoes the filters of png_read_filter_row()
+ * with vector instructions, picked at run time by png_simd_level().  Up
+ * works on any row 16 (SSE2) or 32 (AVX2) bytes at a time.  Sub, Avg and
+ * Paeth depend on the pixel to the left, already unfiltered, so they go a
+ * pixel at a time with the bytes of a pixel side by side in one register,
+ * for the 3 and 4 byte pixels (RGB and RGBA) nearly all our sprites have;
+ * 4 byte Sub does 4 pixels at once with a running sum.  Every other case is
+ * left to the C code.  The per pixel loops only use operations NEON has as
+ * well, should an ARM build ever need them.
+ */
+
+#define PNG_INTERNAL
+#include "png.h"
+#ifdef PNG_READ_SUPPORTED
+
+#if defined(PNG_SIMD_X86_SUPPORTED)
+#  include <emmintrin.h>
+#  include <tmmintrin.h>
+#  if defined(PNG_SIMD_AVX2_SUPPORTED)
+#    include <immintrin.h>
+#  endif
+
+/* Pixels are moved through a 32-bit integer, never past their last byte */
+PNG_SIMD_TARGET("sse2") static __m128i
+png_load_pixel(png_bytep p, png_uint_32 bpp)
+{
+   png_uint_32 v = 0;
+
+   if (bpp == 4)
+      png_memcpy(&v, p, 4);
+   else
+      png_memcpy(&v, p, 3);
+   return _mm_cvtsi32_si128((int)v);
+}
+
+PNG_SIMD_TARGET("sse2") static void
+png_store_pixel(png_bytep p, __m128i pixel, png_uint_32 bpp)
+{
+   png_uint_32 v = (png_uint_32)_mm_cvtsi128_si32(pixel);
+
+   if (bpp == 4)
+      png_memcpy(p, &v, 4);
+   else
+      png_memcpy(p, &v, 3);
+}
+
+PNG_SIMD_TARGET("sse2") static void
+png_read_filter_row_up_sse2(png_uint_32 row_bytes, png_bytep row,
+   png_bytep prev_row)
+{
+   png_uint_32 i;
+
+   for (i = 0; i + 16 <= row_bytes; i += 16)
+   {
+      __m128i x = _mm_loadu_si128((const __m128i *)(row + i));
+      __m128i b = _mm_loadu_si128((const __m128i *)(prev_row + i));
+      _mm_storeu_si128((__m128i *)(row + i), _mm_add_epi8(x, b));
+   }
+   for (; i < row_bytes; i++)
+      row[i] = (png_byte)(row[i] + prev_row[i]);
+}
+
+#if defined(PNG_SIMD_AVX2_SUPPORTED)
+PNG_SIMD_TARGET("avx2") static void
+png_read_filter_row_up_avx2(png_uint_32 row_bytes, png_bytep row,
+   png_bytep prev_row)
+{
+   png_uint_32 i;
+
+   for (i = 0; i + 32 <= row_bytes; i += 32)
+   {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(row + i));
+      __m256i b = _mm256_loadu_si256((const __m256i *)(prev_row + i));
+      _mm256_storeu_si256((__m256i *)(row + i), _mm256_add_epi8(x, b));
+   }
+   for (; i < row_bytes; i++)
+      row[i] = (png_byte)(row[i] + prev_row[i]);
+}
+#endif
+
+PNG_SIMD_TARGET("sse2") static void
+png_read_filter_row_sub_sse2(png_uint_32 row_bytes, png_bytep row,
+   png_uint_32 bpp)
+{
+   __m128i a = _mm_setzero_si128();
+   png_uint_32 i = 0;
+
+   /* Four 4 byte pixels at a time: add each pixel to the next, then each
+    * pair to the next pair, then the last pixel of the 4 before.
+    */
+   if (bpp == 4)
+   {
+      for (; i + 16 <= row_bytes; i += 16)
+      {
+         __m128i x = _mm_loadu_si128((const __m128i *)(row + i));
+         x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+         x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+         x = _mm_add_epi8(x, a);
+         _mm_storeu_si128((__m128i *)(row + i), x);
+         a = _mm_shuffle_epi32(x, 0xff);
+      }
+   }
+
+   for (; i + bpp <= row_bytes; i += bpp)
+   {
+      a = _mm_add_epi8(png_load_pixel(row + i, bpp), a);
+      png_store_pixel(row + i, a, bpp);
+   }
+}
+
+PNG_SIMD_TARGET("sse2") static void
+png_read_filter_row_avg_sse2(png_uint_32 row_bytes, png_bytep row,
+   png_bytep prev_row, png_uint_32 bpp)
+{
+   __m128i one = _mm_set1_epi8(1);
+   __m128i a = _mm_setzero_si128();
+   png_uint_32 i;
+
+   for (i = 0; i + bpp <= row_bytes; i += bpp)
+   {
+      __m128i b = png_load_pixel(prev_row + i, bpp);
+      /* pavgb rounds up, take the carry back off for (a + b) >> 1 */
+      __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b),
+         _mm_and_si128(_mm_xor_si128(a, b), one));
+      a = _mm_add_epi8(png_load_pixel(row + i, bpp), avg);
+      png_store_pixel(row + i, a, bpp);
+   }
+}
+
+/* The Paeth predictor from the pixels a (left), b (above) and c (above
+ * left) and their distances pa, pb and pc, all widened to 16 bits.
+ */
+PNG_SIMD_TARGET("sse2") static __m128i
+png_paeth_predict(__m128i a, __m128i b, __m128i c, __m128i pa, __m128i pb,
+   __m128i pc)
+{
+   __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+   __m128i use_a = _mm_cmpeq_epi16(smallest, pa);
+   __m128i use_b = _mm_cmpeq_epi16(smallest, pb);
+   __m128i bc = _mm_or_si128(_mm_and_si128(use_b, b),
+      _mm_andnot_si128(use_b, c));
+   return _mm_or_si128(_mm_and_si128(use_a, a), _mm_andnot_si128(use_a, bc));
+}
+
+PNG_SIMD_TARGET("sse2") static __m128i
+png_abs16_sse2(__m128i x)
+{
+   return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+PNG_SIMD_TARGET("sse2") static void
+png_read_filter_row_paeth_sse2(png_uint_32 row_bytes, png_bytep row,
+   png_bytep prev_row, png_uint_32 bpp)
+{
+   __m128i zero = _mm_setzero_si128();
+   __m128i a = zero, c = zero;
+   png_uint_32 i;
+
+   for (i = 0; i + bpp <= row_bytes; i += bpp)
+   {
+      __m128i b = _mm_unpacklo_epi8(png_load_pixel(prev_row + i, bpp), zero);
+      __m128i p = _mm_sub_epi16(b, c);
+      __m128i q = _mm_sub_epi16(a, c);
+      __m128i pa = png_abs16_sse2(p);
+      __m128i pb = png_abs16_sse2(q);
+      __m128i pc = png_abs16_sse2(_mm_add_epi16(p, q));
+      __m128i pred = png_paeth_predict(a, b, c, pa, pb, pc);
+      __m128i x = _mm_add_epi8(png_load_pixel(row + i, bpp),
+         _mm_packus_epi16(pred, pred));
+
+      png_store_pixel(row + i, x, bpp);
+      a = _mm_unpacklo_epi8(x, zero);
+      c = b;
+   }
+}
+
+/* The same with pabsw for the distances */
+PNG_SIMD_TARGET("ssse3") static void
+png_read_filter_row_paeth_ssse3(png_uint_32 row_bytes, png_bytep row,
+   png_bytep prev_row, png_uint_32 bpp)
+{
+   __m128i zero = _mm_setzero_si128();
+   __m128i a = zero, c = zero;
+   png_uint_32 i;
+
+   for (i = 0; i + bpp <= row_bytes; i += bpp)
+   {
+      __m128i b = _mm_unpacklo_epi8(png_load_pixel(prev_row + i, bpp), zero);
+      __m128i p = _mm_sub_epi16(b, c);
+      __m128i q = _mm_sub_epi16(a, c);
+      __m128i pa = _mm_abs_epi16(p);
+      __m128i pb = _mm_abs_epi16(q);
+      __m128i pc = _mm_abs_epi16(_mm_add_epi16(p, q));
+      __m128i pred = png_paeth_predict(a, b, c, pa, pb, pc);
+      __m128i x = _mm_add_epi8(png_load_pixel(row + i, bpp),
+         _mm_packus_epi16(pred, pred));
+
+      png_store_pixel(row + i, x, bpp);
+      a = _mm_unpacklo_epi8(x, zero);
+      c = b;
+   }
+}
+
+#endif /* PNG_SIMD_X86_SUPPORTED */
+
+int /* PRIVATE */
+png_read_filter_row_simd(png_row_infop row_info, png_bytep row,
+   png_bytep prev_row, int filter)
+{
+#if defined(PNG_SIMD_X86_SUPPORTED)
+   png_uint_32 row_bytes = row_info->rowbytes;
+   png_uint_32 bpp = (row_info->pixel_depth + 7) >> 3;
+   int level = png_simd_level();
+
+   if (level == PNG_SIMD_NONE)
+      return 0;
+
+   if (filter == PNG_FILTER_VALUE_UP)
+   {
+#  if defined(PNG_SIMD_AVX2_SUPPORTED)
+      if (level >= PNG_SIMD_AVX2)
+      {
+         png_read_filter_row_up_avx2(row_bytes, row, prev_row);
+         return 1;
+      }
+#  endif
+      png_read_filter_row_up_sse2(row_bytes, row, prev_row);
+      return 1;
+   }
+
+   if (bpp != 3 && bpp != 4)
+      return 0;
+
+   switch (filter)
+   {
+      case PNG_FILTER_VALUE_SUB:
+         png_read_filter_row_sub_sse2(row_bytes, row, bpp);
+         return 1;
+      case PNG_FILTER_VALUE_AVG:
+         png_read_filter_row_avg_sse2(row_bytes, row, prev_row, bpp);
+         return 1;
+      case PNG_FILTER_VALUE_PAETH:
+         if (level >= PNG_SIMD_SSSE3)
+            png_read_filter_row_paeth_ssse3(row_bytes, row, prev_row, bpp);
+         else
+            png_read_filter_row_paeth_sse2(row_bytes, row, prev_row, bpp);
+         return 1;
+      default:
+         break;
+   }
+#else
+   if (row_info == NULL || row == NULL || prev_row == NULL || filter < 0)
+      return 0;  /* silence compiler warnings */
+#endif
+   return 0;
+}
+
+#endif /* PNG_READ_SUPPORTED */
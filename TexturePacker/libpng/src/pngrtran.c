@@ -1264,8 +1264,11 @@ png_do_read_transformations(png_structp png_ptr)
    {
       if (png_ptr->row_info.color_type == PNG_COLOR_TYPE_PALETTE)
       {
-         png_do_expand_palette(&(png_ptr->row_info), png_ptr->row_buf + 1,
-            png_ptr->palette, png_ptr->trans, png_ptr->num_trans);
+         /* The vector code keeps its RGBA table in png_ptr */
+         if (!png_do_expand_palette_simd(png_ptr, &(png_ptr->row_info),
+             png_ptr->row_buf + 1))
+            png_do_expand_palette(&(png_ptr->row_info), png_ptr->row_buf + 1,
+               png_ptr->palette, png_ptr->trans, png_ptr->num_trans);
       }
       else
       {
@@ -1673,6 +1676,11 @@ void /* PRIVATE */
 png_do_chop(png_row_infop row_info, png_bytep row)
 {
    png_debug(1, "in png_do_chop\n");
+
+   /* SSE2 where the CPU has it */
+   if (png_do_chop_simd(row_info, row))
+      return;
+
 #if defined(PNG_USELESS_TESTS_SUPPORTED)
    if (row != NULL && row_info != NULL && row_info->bit_depth == 16)
 #else
@@ -1925,6 +1933,11 @@ png_do_read_filler(png_row_infop row_info, png_bytep row,
    png_byte lo_filler = (png_byte)(filler & 0xff);
 
    png_debug(1, "in png_do_read_filler\n");
+
+   /* SSSE3 where the CPU has it, for 8 bit RGB */
+   if (png_do_read_filler_simd(row_info, row, filler, flags))
+      return;
+
    if (
 #if defined(PNG_USELESS_TESTS_SUPPORTED)
        row != NULL  && row_info != NULL &&
@@ -2097,6 +2110,11 @@ png_do_gray_to_rgb(png_row_infop row_info, png_bytep row)
    png_uint_32 row_width = row_info->width;
 
    png_debug(1, "in png_do_gray_to_rgb\n");
+
+   /* SSE2 and SSSE3 where the CPU has them, for 8 bit samples */
+   if (png_do_gray_to_rgb_simd(row_info, row))
+      return;
+
    if (row_info->bit_depth >= 8 &&
 #if defined(PNG_USELESS_TESTS_SUPPORTED)
        row != NULL && row_info != NULL &&
@@ -3685,6 +3703,11 @@ png_do_expand(png_row_infop row_info, png_bytep row,
    png_uint_32 row_width=row_info->width;
 
    png_debug(1, "in png_do_expand\n");
+
+   /* SSE2 where the CPU has it, for gray of 8 bits or less */
+   if (png_do_expand_simd(row_info, row, trans_value))
+      return;
+
 #if defined(PNG_USELESS_TESTS_SUPPORTED)
    if (row != NULL && row_info != NULL)
 #endif
@@ -0,0 +1,511 @@
+/* pngrtsimd.c - read transformations to 8 bit RGBA with SSE2, SSSE3 and AVX2
+ *
+ * For conditions of distribution and use, see copyright notice in png.h
+ *
+ * The functions here take over the transformations png_set_expand(),
+ * png_set_gray_to_rgb(), png_set_strip_16() and png_set_filler() ask for,
+ * the ones that bring every kind of image to 8 bit RGBA, for the layouts
+ * they handle, picked at run time by png_simd_level().  Each returns 0 and
+ * leaves the row alone when the C code in pngrtran.c must do it instead.
+ *
+ * The rows grow in place, so the expanding ones go from the end of the row
+ * to the start a block of pixels at a time: every block is read before it
+ * is written, and only ever overwrites the blocks after it.  Pixels of less
+ * than 8 bits are unpacked to bytes first with plain C.
+ */
+
+#define PNG_INTERNAL
+#include "png.h"
+#ifdef PNG_READ_SUPPORTED
+
+#if defined(PNG_SIMD_X86_SUPPORTED)
+#  include <emmintrin.h>
+#  include <tmmintrin.h>
+#  if defined(PNG_SIMD_AVX2_SUPPORTED)
+#    include <immintrin.h>
+#  endif
+
+#if defined(PNG_READ_EXPAND_SUPPORTED)
+/* Spread the 1, 2 or 4 bit samples of a row to a byte each, times scale */
+static void
+png_unpack_row(png_bytep row, png_uint_32 row_width, int bit_depth,
+   int scale)
+{
+   int mask = (1 << bit_depth) - 1;
+   png_uint_32 i = row_width;
+
+   while (i-- > 0)
+   {
+      png_uint_32 bit = i * (png_uint_32)bit_depth;
+      int value = (row[bit >> 3] >> (8 - bit_depth - (int)(bit & 7))) & mask;
+
+      row[i] = (png_byte)(value * scale);
+   }
+}
+
+/* The palette and tRNS as 4 bytes of RGBA for each of the 256 indices,
+ * made on the first row.  Indices past the palette give black, like the C
+ * code, which reads the zeros png_set_PLTE() fills the palette up with.
+ */
+static png_bytep
+png_palette_rgba(png_structp png_ptr)
+{
+   if (png_ptr->palette_rgba == NULL)
+   {
+      png_bytep table = (png_bytep)png_malloc(png_ptr, (png_uint_32)1024);
+      int i;
+
+      for (i = 0; i < 256; i++)
+      {
+         table[4 * i] = png_ptr->palette[i].red;
+         table[4 * i + 1] = png_ptr->palette[i].green;
+         table[4 * i + 2] = png_ptr->palette[i].blue;
+         table[4 * i + 3] = (png_byte)(i < png_ptr->num_trans ?
+            png_ptr->trans[i] : 0xff);
+      }
+      png_ptr->palette_rgba = table;
+   }
+   return png_ptr->palette_rgba;
+}
+
+/* An entry as a 32-bit lane; png_uint_32 may be wider */
+static int
+png_palette_entry(png_bytep table, int index)
+{
+   int rgba;
+
+   png_memcpy(&rgba, table + 4 * index, 4);
+   return rgba;
+}
+
+PNG_SIMD_TARGET("sse2") static void
+png_expand_palette_rgba_sse2(png_bytep row, png_uint_32 row_width,
+   png_bytep table)
+{
+   png_uint_32 i = row_width;
+
+   while (i >= 16)
+   {
+      png_byte index[16];
+      int k;
+
+      i -= 16;
+      png_memcpy(index, row + i, 16);
+      for (k = 0; k < 16; k += 4)
+         _mm_storeu_si128((__m128i *)(row + 4 * (i + k)), _mm_setr_epi32(
+            png_palette_entry(table, index[k]),
+            png_palette_entry(table, index[k + 1]),
+            png_palette_entry(table, index[k + 2]),
+            png_palette_entry(table, index[k + 3])));
+   }
+   while (i-- > 0)
+      png_memcpy(row + 4 * i, table + 4 * row[i], 4);
+}
+
+#if defined(PNG_SIMD_AVX2_SUPPORTED)
+PNG_SIMD_TARGET("avx2") static void
+png_expand_palette_rgba_avx2(png_bytep row, png_uint_32 row_width,
+   png_bytep table)
+{
+   png_uint_32 i = row_width;
+
+   while (i >= 16)
+   {
+      __m128i index;
+
+      i -= 16;
+      index = _mm_loadu_si128((const __m128i *)(row + i));
+      _mm256_storeu_si256((__m256i *)(row + 4 * i), _mm256_i32gather_epi32(
+         (const int *)table, _mm256_cvtepu8_epi32(index), 4));
+      _mm256_storeu_si256((__m256i *)(row + 4 * i + 32),
+         _mm256_i32gather_epi32((const int *)table,
+         _mm256_cvtepu8_epi32(_mm_srli_si128(index, 8)), 4));
+   }
+   while (i-- > 0)
+      png_memcpy(row + 4 * i, table + 4 * row[i], 4);
+}
+#endif
+
+/* Without tRNS the pixels are 3 bytes: each one is written as the 4 bytes
+ * of its table entry, and the next pixel of the block overwrites the extra
+ * byte.  The last pixel of a block must not, the block after is done.
+ */
+static void
+png_expand_palette_rgb(png_bytep row, png_uint_32 row_width,
+   png_bytep table)
+{
+   png_uint_32 i = row_width;
+
+   while (i >= 16)
+   {
+      png_byte index[16];
+      int k;
+
+      i -= 16;
+      png_memcpy(index, row + i, 16);
+      for (k = 0; k < 15; k++)
+         png_memcpy(row + 3 * (i + k), table + 4 * index[k], 4);
+      png_memcpy(row + 3 * (i + 15), table + 4 * index[15], 3);
+   }
+   while (i-- > 0)
+      png_memcpy(row + 3 * i, table + 4 * row[i], 3);
+}
+
+int /* PRIVATE */
+png_do_expand_palette_simd(png_structp png_ptr, png_row_infop row_info,
+   png_bytep row)
+{
+   png_uint_32 row_width = row_info->width;
+   png_bytep table;
+   int level = png_simd_level();
+
+   if (level == PNG_SIMD_NONE || row_info->color_type != PNG_COLOR_TYPE_PALETTE
+       || row_info->bit_depth > 8)
+      return 0;
+
+   if (row_info->bit_depth < 8)
+      png_unpack_row(row, row_width, row_info->bit_depth, 1);
+
+   table = png_palette_rgba(png_ptr);
+   if (png_ptr->trans != NULL)
+   {
+#  if defined(PNG_SIMD_AVX2_SUPPORTED)
+      if (level >= PNG_SIMD_AVX2)
+         png_expand_palette_rgba_avx2(row, row_width, table);
+      else
+#  endif
+         png_expand_palette_rgba_sse2(row, row_width, table);
+      row_info->color_type = PNG_COLOR_TYPE_RGB_ALPHA;
+      row_info->channels = 4;
+   }
+   else
+   {
+      png_expand_palette_rgb(row, row_width, table);
+      row_info->color_type = PNG_COLOR_TYPE_RGB;
+      row_info->channels = 3;
+   }
+   row_info->bit_depth = 8;
+   row_info->pixel_depth = (png_byte)(8 * row_info->channels);
+   row_info->rowbytes = row_width * row_info->channels;
+   return 1;
+}
+
+/* Gray to gray-alpha, transparent where the sample is key */
+PNG_SIMD_TARGET("sse2") static void
+png_expand_gray_alpha_sse2(png_bytep row, png_uint_32 row_width,
+   png_byte key)
+{
+   __m128i keys = _mm_set1_epi8((char)key);
+   __m128i ones = _mm_set1_epi8(-1);
+   png_uint_32 i = row_width;
+
+   while (i >= 16)
+   {
+      __m128i g, a;
+
+      i -= 16;
+      g = _mm_loadu_si128((const __m128i *)(row + i));
+      a = _mm_xor_si128(_mm_cmpeq_epi8(g, keys), ones);
+      _mm_storeu_si128((__m128i *)(row + 2 * i), _mm_unpacklo_epi8(g, a));
+      _mm_storeu_si128((__m128i *)(row + 2 * i + 16),
+         _mm_unpackhi_epi8(g, a));
+   }
+   while (i-- > 0)
+   {
+      png_byte g = row[i];
+
+      row[2 * i] = g;
+      row[2 * i + 1] = (png_byte)(g == key ? 0 : 0xff);
+   }
+}
+
+int /* PRIVATE */
+png_do_expand_simd(png_row_infop row_info, png_bytep row,
+   png_color_16p trans_value)
+{
+   png_uint_32 row_width = row_info->width;
+   int scale = 1;
+   png_uint_32 key = 0;
+
+   if (png_simd_level() == PNG_SIMD_NONE ||
+       row_info->color_type != PNG_COLOR_TYPE_GRAY || row_info->bit_depth > 8)
+      return 0;
+
+   /* 1, 2 and 4 bit gray is scaled to the whole byte, the key too */
+   if (row_info->bit_depth < 8)
+      scale = 0xff / ((1 << row_info->bit_depth) - 1);
+   if (trans_value != NULL)
+   {
+      key = (png_uint_32)trans_value->gray * scale;
+      if (key > 0xff)
+         return 0;
+   }
+
+   if (row_info->bit_depth < 8)
+   {
+      png_unpack_row(row, row_width, row_info->bit_depth, scale);
+      row_info->bit_depth = 8;
+      row_info->pixel_depth = 8;
+      row_info->rowbytes = row_width;
+   }
+
+   if (trans_value != NULL)
+   {
+      png_expand_gray_alpha_sse2(row, row_width, (png_byte)key);
+      row_info->color_type = PNG_COLOR_TYPE_GRAY_ALPHA;
+      row_info->channels = 2;
+      row_info->pixel_depth = 16;
+      row_info->rowbytes = row_width * 2;
+   }
+   return 1;
+}
+#endif /* PNG_READ_EXPAND_SUPPORTED */
+
+#if defined(PNG_READ_GRAY_TO_RGB_SUPPORTED)
+/* G to GGG, 16 pixels to 48 bytes */
+PNG_SIMD_TARGET("ssse3") static void
+png_gray_to_rgb_ssse3(png_bytep row, png_uint_32 row_width)
+{
+   __m128i m0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+   __m128i m1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10,
+      10);
+   __m128i m2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14,
+      14, 15, 15, 15);
+   png_uint_32 i = row_width;
+
+   while (i >= 16)
+   {
+      __m128i g;
+
+      i -= 16;
+      g = _mm_loadu_si128((const __m128i *)(row + i));
+      _mm_storeu_si128((__m128i *)(row + 3 * i), _mm_shuffle_epi8(g, m0));
+      _mm_storeu_si128((__m128i *)(row + 3 * i + 16),
+         _mm_shuffle_epi8(g, m1));
+      _mm_storeu_si128((__m128i *)(row + 3 * i + 32),
+         _mm_shuffle_epi8(g, m2));
+   }
+   while (i-- > 0)
+   {
+      png_byte g = row[i];
+
+      row[3 * i] = row[3 * i + 1] = row[3 * i + 2] = g;
+   }
+}
+
+/* GA to GGGA, 8 pixels at a time: the gray byte doubled into a 16-bit word
+ * and interleaved with the gray-alpha word.
+ */
+PNG_SIMD_TARGET("sse2") static void
+png_gray_alpha_to_rgba_sse2(png_bytep row, png_uint_32 row_width)
+{
+   __m128i low = _mm_set1_epi16(0xff);
+   png_uint_32 i = row_width;
+
+   while (i >= 8)
+   {
+      __m128i ga, g;
+
+      i -= 8;
+      ga = _mm_loadu_si128((const __m128i *)(row + 2 * i));
+      g = _mm_and_si128(ga, low);
+      g = _mm_or_si128(g, _mm_slli_epi16(g, 8));
+      _mm_storeu_si128((__m128i *)(row + 4 * i), _mm_unpacklo_epi16(g, ga));
+      _mm_storeu_si128((__m128i *)(row + 4 * i + 16),
+         _mm_unpackhi_epi16(g, ga));
+   }
+   while (i-- > 0)
+   {
+      png_byte g = row[2 * i], a = row[2 * i + 1];
+
+      row[4 * i] = row[4 * i + 1] = row[4 * i + 2] = g;
+      row[4 * i + 3] = a;
+   }
+}
+
+int /* PRIVATE */
+png_do_gray_to_rgb_simd(png_row_infop row_info, png_bytep row)
+{
+   int level = png_simd_level();
+
+   if (level == PNG_SIMD_NONE || row_info->bit_depth != 8)
+      return 0;
+
+   if (row_info->color_type == PNG_COLOR_TYPE_GRAY && level >= PNG_SIMD_SSSE3)
+      png_gray_to_rgb_ssse3(row, row_info->width);
+   else if (row_info->color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+      png_gray_alpha_to_rgba_sse2(row, row_info->width);
+   else
+      return 0;
+
+   row_info->channels += (png_byte)2;
+   row_info->color_type |= PNG_COLOR_MASK_COLOR;
+   row_info->pixel_depth = (png_byte)(8 * row_info->channels);
+   row_info->rowbytes = row_info->width * row_info->channels;
+   return 1;
+}
+#endif /* PNG_READ_GRAY_TO_RGB_SUPPORTED */
+
+#if defined(PNG_READ_16_TO_8_SUPPORTED)
+/* 16 samples at a time: the high byte, rounded like png_do_chop() when
+ * PNG_READ_16_TO_8_ACCURATE_SCALE_SUPPORTED is defined.
+ */
+PNG_SIMD_TARGET("sse2") static void
+png_chop_sse2(png_bytep row, png_uint_32 samples)
+{
+   __m128i low = _mm_set1_epi16(0xff);
+#if defined(PNG_READ_16_TO_8_ACCURATE_SCALE_SUPPORTED)
+   __m128i half = _mm_set1_epi16(128);
+#endif
+   __m128i x[2];
+   png_uint_32 i;
+   int k;
+
+   for (i = 0; i + 16 <= samples; i += 16)
+   {
+      x[0] = _mm_loadu_si128((const __m128i *)(row + 2 * i));
+      x[1] = _mm_loadu_si128((const __m128i *)(row + 2 * i + 16));
+      for (k = 0; k < 2; k++)
+      {
+         __m128i hi = _mm_and_si128(x[k], low);
+#if defined(PNG_READ_16_TO_8_ACCURATE_SCALE_SUPPORTED)
+         __m128i lo = _mm_srli_epi16(x[k], 8);
+
+         hi = _mm_sub_epi16(hi, _mm_cmpgt_epi16(_mm_sub_epi16(lo, hi), half));
+#endif
+         x[k] = hi;
+      }
+      _mm_storeu_si128((__m128i *)(row + i), _mm_packus_epi16(x[0], x[1]));
+   }
+   for (; i < samples; i++)
+   {
+      png_bytep sp = row + 2 * i;
+
+#if defined(PNG_READ_16_TO_8_ACCURATE_SCALE_SUPPORTED)
+      row[i] = (png_byte)(*sp + ((((int)(*(sp + 1)) - *sp) > 128) ? 1 : 0));
+#else
+      row[i] = *sp;
+#endif
+   }
+}
+
+int /* PRIVATE */
+png_do_chop_simd(png_row_infop row_info, png_bytep row)
+{
+   if (png_simd_level() == PNG_SIMD_NONE || row_info->bit_depth != 16)
+      return 0;
+
+   png_chop_sse2(row, row_info->width * row_info->channels);
+   row_info->bit_depth = 8;
+   row_info->pixel_depth = (png_byte)(8 * row_info->channels);
+   row_info->rowbytes = row_info->width * row_info->channels;
+   return 1;
+}
+#endif /* PNG_READ_16_TO_8_SUPPORTED */
+
+#if defined(PNG_READ_FILLER_SUPPORTED)
+/* RGB to RGBX, 16 pixels from four overlapping loads of 12 bytes */
+PNG_SIMD_TARGET("ssse3") static void
+png_rgb_to_rgbx_ssse3(png_bytep row, png_uint_32 row_width, png_byte filler)
+{
+   __m128i spread = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10,
+      11, -1);
+   __m128i fill = _mm_set1_epi32((int)((png_uint_32)filler << 24));
+   png_uint_32 i = row_width;
+
+   while (i >= 16)
+   {
+      __m128i x[4];
+      int k;
+
+      i -= 16;
+      for (k = 0; k < 4; k++)
+         x[k] = _mm_loadu_si128((const __m128i *)(row + 3 * i + 12 * k));
+      for (k = 0; k < 4; k++)
+         _mm_storeu_si128((__m128i *)(row + 4 * i + 16 * k),
+            _mm_or_si128(_mm_shuffle_epi8(x[k], spread), fill));
+   }
+   while (i-- > 0)
+   {
+      png_bytep sp = row + 3 * i, dp = row + 4 * i;
+
+      dp[3] = filler;
+      dp[2] = sp[2];
+      dp[1] = sp[1];
+      dp[0] = sp[0];
+   }
+}
+
+int /* PRIVATE */
+png_do_read_filler_simd(png_row_infop row_info, png_bytep row,
+   png_uint_32 filler, png_uint_32 flags)
+{
+   if (png_simd_level() < PNG_SIMD_SSSE3 ||
+       row_info->color_type != PNG_COLOR_TYPE_RGB ||
+       row_info->bit_depth != 8 || !(flags & PNG_FLAG_FILLER_AFTER))
+      return 0;
+
+   png_rgb_to_rgbx_ssse3(row, row_info->width, (png_byte)(filler & 0xff));
+   row_info->channels = 4;
+   row_info->pixel_depth = 32;
+   row_info->rowbytes = row_info->width * 4;
+   return 1;
+}
+#endif /* PNG_READ_FILLER_SUPPORTED */
+
+#else /* !PNG_SIMD_X86_SUPPORTED */
+
+/* Without vector code the C code does everything */
+#if defined(PNG_READ_EXPAND_SUPPORTED)
+int /* PRIVATE */
+png_do_expand_palette_simd(png_structp png_ptr, png_row_infop row_info,
+   png_bytep row)
+{
+   if (png_ptr == NULL || row_info == NULL || row == NULL)
+      return 0;  /* silence compiler warnings */
+   return 0;
+}
+
+int /* PRIVATE */
+png_do_expand_simd(png_row_infop row_info, png_bytep row,
+   png_color_16p trans_value)
+{
+   if (row_info == NULL || row == NULL || trans_value == NULL)
+      return 0;  /* silence compiler warnings */
+   return 0;
+}
+#endif
+
+#if defined(PNG_READ_GRAY_TO_RGB_SUPPORTED)
+int /* PRIVATE */
+png_do_gray_to_rgb_simd(png_row_infop row_info, png_bytep row)
+{
+   if (row_info == NULL || row == NULL)
+      return 0;  /* silence compiler warnings */
+   return 0;
+}
+#endif
+
+#if defined(PNG_READ_16_TO_8_SUPPORTED)
+int /* PRIVATE */
+png_do_chop_simd(png_row_infop row_info, png_bytep row)
+{
+   if (row_info == NULL || row == NULL)
+      return 0;  /* silence compiler warnings */
+   return 0;
+}
+#endif
+
+#if defined(PNG_READ_FILLER_SUPPORTED)
+int /* PRIVATE */
+png_do_read_filler_simd(png_row_infop row_info, png_bytep row,
+   png_uint_32 filler, png_uint_32 flags)
+{
+   if (row_info == NULL || row == NULL || filler == 0 || flags == 0)
+      return 0;  /* silence compiler warnings */
+   return 0;
+}
+#endif
+
+#endif /* PNG_SIMD_X86_SUPPORTED */
+#endif /* PNG_READ_SUPPORTED */
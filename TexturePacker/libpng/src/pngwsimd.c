@@ -0,0 +1,325 @@
+/* pngwsimd.c - row filters for PNG writers, with SSE2 and AVX2 versions
+ *
+ * For conditions of distribution and use, see copyright notice in png.h
+ *
+ * png_filter_row() applies one filter to a row and sums the result for the
+ * "minimum sum of absolute differences" heuristic in a single pass.  The
+ * vector versions do 16 (SSE2) or 32 (AVX2) bytes at a time and are picked
+ * at run time by png_simd_level(); the C loops do the first pixel, the bytes
+ * left at the end and everything on other processors.
+ */
+
+#define PNG_INTERNAL
+#include "png.h"
+#ifdef PNG_WRITE_SUPPORTED
+
+/* The starting minimum, as in pngwutil.c */
+#define PNG_MAXSUM (((png_uint_32)(-1)) >> 1)
+
+#if defined(PNG_SIMD_X86_SUPPORTED)
+#  include <emmintrin.h>
+#  if defined(PNG_SIMD_AVX2_SUPPORTED)
+#    include <immintrin.h>
+#  endif
+#endif
+
+/* Filters bytes start to end - 1 of a row with the C code.  Below bpp there
+ * is no pixel to the left and its bytes count as zero.
+ */
+static png_uint_32
+png_filter_row_c(int filter_type, png_bytep out, png_bytep row,
+   png_bytep prev_row, png_uint_32 start, png_uint_32 end, png_uint_32 bpp)
+{
+   png_uint_32 sum = 0;
+   png_uint_32 i;
+   int a, b, c, p, pa, pb, pc, v;
+
+   for (i = start; i < end; i++)
+   {
+      a = i >= bpp ? row[i - bpp] : 0;
+      switch (filter_type)
+      {
+         case PNG_FILTER_VALUE_SUB:
+            v = row[i] - a;
+            break;
+         case PNG_FILTER_VALUE_UP:
+            v = row[i] - prev_row[i];
+            break;
+         case PNG_FILTER_VALUE_AVG:
+            v = row[i] - ((a + prev_row[i]) >> 1);
+            break;
+         case PNG_FILTER_VALUE_PAETH:
+            b = prev_row[i];
+            c = i >= bpp ? prev_row[i - bpp] : 0;
+            p = b - c;
+            pc = a - c;
+            pa = p < 0 ? -p : p;
+            pb = pc < 0 ? -pc : pc;
+            pc = (p + pc) < 0 ? -(p + pc) : p + pc;
+            p = (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c;
+            v = row[i] - p;
+            break;
+         default:
+            v = row[i];
+            break;
+      }
+      v &= 0xff;
+      out[i] = (png_byte)v;
+      sum += (v < 128) ? v : 256 - v;
+   }
+
+   return sum;
+}
+
+#if defined(PNG_SIMD_X86_SUPPORTED)
+
+/* Bytes filtered one at a time as signed values, summed as absolute values */
+PNG_SIMD_TARGET("sse2") static __m128i
+png_sad_sse2(__m128i sums, __m128i d)
+{
+   __m128i zero = _mm_setzero_si128();
+   __m128i abs_d = _mm_min_epu8(d, _mm_sub_epi8(zero, d));
+   return _mm_add_epi64(sums, _mm_sad_epu8(abs_d, zero));
+}
+
+/* The Paeth predictor of eight pixels' bytes widened to 16 bits */
+PNG_SIMD_TARGET("sse2") static __m128i
+png_paeth_sse2(__m128i a, __m128i b, __m128i c)
+{
+   __m128i zero = _mm_setzero_si128();
+   __m128i p = _mm_sub_epi16(b, c);
+   __m128i q = _mm_sub_epi16(a, c);
+   __m128i r = _mm_add_epi16(p, q);
+   __m128i pa = _mm_max_epi16(p, _mm_sub_epi16(zero, p));
+   __m128i pb = _mm_max_epi16(q, _mm_sub_epi16(zero, q));
+   __m128i pc = _mm_max_epi16(r, _mm_sub_epi16(zero, r));
+   __m128i not_a = _mm_or_si128(_mm_cmpgt_epi16(pa, pb),
+      _mm_cmpgt_epi16(pa, pc));
+   __m128i use_c = _mm_cmpgt_epi16(pb, pc);
+   __m128i bc = _mm_or_si128(_mm_andnot_si128(use_c, b),
+      _mm_and_si128(use_c, c));
+   return _mm_or_si128(_mm_andnot_si128(not_a, a), _mm_and_si128(not_a, bc));
+}
+
+/* Filters 16 bytes at a time from *start while they fit before end, leaves
+ * *start at the first byte not done and returns their sum.  start is at
+ * least bpp.
+ */
+PNG_SIMD_TARGET("sse2") static png_uint_32
+png_filter_row_sse2(int filter_type, png_bytep out, png_bytep row,
+   png_bytep prev_row, png_uint_32 *start, png_uint_32 end, png_uint_32 bpp)
+{
+   __m128i zero = _mm_setzero_si128();
+   __m128i one = _mm_set1_epi8(1);
+   __m128i sums = zero;
+   __m128i x, a, b, c, d;
+   png_uint_32 i;
+
+   for (i = *start; i + 16 <= end; i += 16)
+   {
+      x = _mm_loadu_si128((const __m128i *)(row + i));
+      switch (filter_type)
+      {
+         case PNG_FILTER_VALUE_SUB:
+            a = _mm_loadu_si128((const __m128i *)(row + i - bpp));
+            d = _mm_sub_epi8(x, a);
+            break;
+         case PNG_FILTER_VALUE_UP:
+            b = _mm_loadu_si128((const __m128i *)(prev_row + i));
+            d = _mm_sub_epi8(x, b);
+            break;
+         case PNG_FILTER_VALUE_AVG:
+            a = _mm_loadu_si128((const __m128i *)(row + i - bpp));
+            b = _mm_loadu_si128((const __m128i *)(prev_row + i));
+            /* pavgb rounds up, take the carry back off for (a + b) >> 1 */
+            d = _mm_sub_epi8(_mm_avg_epu8(a, b),
+               _mm_and_si128(_mm_xor_si128(a, b), one));
+            d = _mm_sub_epi8(x, d);
+            break;
+         case PNG_FILTER_VALUE_PAETH:
+            a = _mm_loadu_si128((const __m128i *)(row + i - bpp));
+            b = _mm_loadu_si128((const __m128i *)(prev_row + i));
+            c = _mm_loadu_si128((const __m128i *)(prev_row + i - bpp));
+            d = _mm_packus_epi16(
+               png_paeth_sse2(_mm_unpacklo_epi8(a, zero),
+                  _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero)),
+               png_paeth_sse2(_mm_unpackhi_epi8(a, zero),
+                  _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(c, zero)));
+            d = _mm_sub_epi8(x, d);
+            break;
+         default:
+            d = x;
+            break;
+      }
+      _mm_storeu_si128((__m128i *)(out + i), d);
+      sums = png_sad_sse2(sums, d);
+   }
+
+   *start = i;
+   return (png_uint_32)_mm_cvtsi128_si32(_mm_add_epi32(sums,
+      _mm_unpackhi_epi64(sums, sums)));
+}
+
+#if defined(PNG_SIMD_AVX2_SUPPORTED)
+
+PNG_SIMD_TARGET("avx2") static __m256i
+png_paeth_avx2(__m256i a, __m256i b, __m256i c)
+{
+   __m256i p = _mm256_sub_epi16(b, c);
+   __m256i q = _mm256_sub_epi16(a, c);
+   __m256i pa = _mm256_abs_epi16(p);
+   __m256i pb = _mm256_abs_epi16(q);
+   __m256i pc = _mm256_abs_epi16(_mm256_add_epi16(p, q));
+   __m256i not_a = _mm256_or_si256(_mm256_cmpgt_epi16(pa, pb),
+      _mm256_cmpgt_epi16(pa, pc));
+   __m256i bc = _mm256_blendv_epi8(b, c, _mm256_cmpgt_epi16(pb, pc));
+   return _mm256_blendv_epi8(a, bc, not_a);
+}
+
+/* The same 32 bytes at a time.  The unpacks and the pack both work within
+ * each 128-bit half, so the bytes come back in order.
+ */
+PNG_SIMD_TARGET("avx2") static png_uint_32
+png_filter_row_avx2(int filter_type, png_bytep out, png_bytep row,
+   png_bytep prev_row, png_uint_32 *start, png_uint_32 end, png_uint_32 bpp)
+{
+   __m256i zero = _mm256_setzero_si256();
+   __m256i one = _mm256_set1_epi8(1);
+   __m256i sums = zero;
+   __m256i x, a, b, c, d;
+   __m128i sum;
+   png_uint_32 i;
+
+   for (i = *start; i + 32 <= end; i += 32)
+   {
+      x = _mm256_loadu_si256((const __m256i *)(row + i));
+      switch (filter_type)
+      {
+         case PNG_FILTER_VALUE_SUB:
+            a = _mm256_loadu_si256((const __m256i *)(row + i - bpp));
+            d = _mm256_sub_epi8(x, a);
+            break;
+         case PNG_FILTER_VALUE_UP:
+            b = _mm256_loadu_si256((const __m256i *)(prev_row + i));
+            d = _mm256_sub_epi8(x, b);
+            break;
+         case PNG_FILTER_VALUE_AVG:
+            a = _mm256_loadu_si256((const __m256i *)(row + i - bpp));
+            b = _mm256_loadu_si256((const __m256i *)(prev_row + i));
+            d = _mm256_sub_epi8(_mm256_avg_epu8(a, b),
+               _mm256_and_si256(_mm256_xor_si256(a, b), one));
+            d = _mm256_sub_epi8(x, d);
+            break;
+         case PNG_FILTER_VALUE_PAETH:
+            a = _mm256_loadu_si256((const __m256i *)(row + i - bpp));
+            b = _mm256_loadu_si256((const __m256i *)(prev_row + i));
+            c = _mm256_loadu_si256((const __m256i *)(prev_row + i - bpp));
+            d = _mm256_packus_epi16(
+               png_paeth_avx2(_mm256_unpacklo_epi8(a, zero),
+                  _mm256_unpacklo_epi8(b, zero),
+                  _mm256_unpacklo_epi8(c, zero)),
+               png_paeth_avx2(_mm256_unpackhi_epi8(a, zero),
+                  _mm256_unpackhi_epi8(b, zero),
+                  _mm256_unpackhi_epi8(c, zero)));
+            d = _mm256_sub_epi8(x, d);
+            break;
+         default:
+            d = x;
+            break;
+      }
+      _mm256_storeu_si256((__m256i *)(out + i), d);
+      sums = _mm256_add_epi64(sums, _mm256_sad_epu8(
+         _mm256_min_epu8(d, _mm256_sub_epi8(zero, d)), zero));
+   }
+
+   *start = i;
+   sum = _mm_add_epi64(_mm256_castsi256_si128(sums),
+      _mm256_extracti128_si256(sums, 1));
+   return (png_uint_32)_mm_cvtsi128_si32(_mm_add_epi32(sum,
+      _mm_unpackhi_epi64(sum, sum)));
+}
+
+#endif /* PNG_SIMD_AVX2_SUPPORTED */
+#endif /* PNG_SIMD_X86_SUPPORTED */
+
+png_uint_32 PNGAPI
+png_filter_row(int filter_type, png_bytep out, png_bytep row,
+   png_bytep prev_row, png_uint_32 row_bytes, png_uint_32 bpp)
+{
+   png_uint_32 i = bpp < row_bytes ? bpp : row_bytes;
+   png_uint_32 sum;
+
+   /* The first pixel has nothing to its left */
+   sum = png_filter_row_c(filter_type, out, row, prev_row, 0, i, bpp);
+
+#if defined(PNG_SIMD_X86_SUPPORTED)
+   switch (png_simd_level())
+   {
+#  if defined(PNG_SIMD_AVX2_SUPPORTED)
+      case PNG_SIMD_AVX2:
+         /* SSE2 does the last 16 to 31 bytes */
+         sum += png_filter_row_avx2(filter_type, out, row, prev_row, &i,
+            row_bytes, bpp);
+#  endif
+         /* FALLTHROUGH */
+      case PNG_SIMD_SSSE3:
+      case PNG_SIMD_SSE2:
+         sum += png_filter_row_sse2(filter_type, out, row, prev_row, &i,
+            row_bytes, bpp);
+         break;
+      default:
+         break;
+   }
+#endif
+
+   return sum + png_filter_row_c(filter_type, out, row, prev_row, i,
+      row_bytes, bpp);
+}
+
+/* Tries each filter the user allowed on png_ptr->row_buf, leaving the
+ * results in the filter rows, and returns the one with the smallest sum.
+ * Ties go to the lower filter value, as in png_write_find_filter().
+ */
+png_bytep /* PRIVATE */
+png_write_find_filter_simd(png_structp png_ptr, png_uint_32 row_bytes,
+   png_uint_32 bpp)
+{
+   png_byte filter_to_do = png_ptr->do_filter;
+   png_bytep row = png_ptr->row_buf + 1;
+   png_bytep prev_row = png_ptr->prev_row != NULL ? png_ptr->prev_row + 1 :
+      NULL;
+   png_bytep best_row = png_ptr->row_buf;
+   png_bytep filter_rows[5];
+   png_uint_32 mins = PNG_MAXSUM;
+   png_uint_32 sum;
+   int v;
+
+   /* 'None' doesn't change anything and needs no sum if it is the only one */
+   if (filter_to_do == PNG_FILTER_NONE)
+      return best_row;
+
+   filter_rows[PNG_FILTER_VALUE_NONE] = png_ptr->row_buf;
+   filter_rows[PNG_FILTER_VALUE_SUB] = png_ptr->sub_row;
+   filter_rows[PNG_FILTER_VALUE_UP] = png_ptr->up_row;
+   filter_rows[PNG_FILTER_VALUE_AVG] = png_ptr->avg_row;
+   filter_rows[PNG_FILTER_VALUE_PAETH] = png_ptr->paeth_row;
+
+   for (v = PNG_FILTER_VALUE_NONE; v < PNG_FILTER_VALUE_LAST; v++)
+   {
+      /* PNG_FILTER_NONE is 0x08 and the others follow it */
+      if (!(filter_to_do & (PNG_FILTER_NONE << v)) || filter_rows[v] == NULL)
+         continue;
+
+      sum = png_filter_row(v, filter_rows[v] + 1, row, prev_row, row_bytes,
+         bpp);
+      if (sum < mins)
+      {
+         mins = sum;
+         best_row = filter_rows[v];
+      }
+   }
+
+   return best_row;
+}
+
+#endif /* PNG_WRITE_SUPPORTED */
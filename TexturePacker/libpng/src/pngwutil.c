@@ -2122,6 +2122,18 @@ png_write_find_filter(png_structp png_ptr, png_row_infop row_info)
    best_row = row_buf = png_ptr->row_buf;
    mins = PNG_MAXSUM;
 
+   /* The plain heuristic filters and sums each row in one pass, with SSE2
+    * or AVX2 where the CPU has them (pngwsimd.c).
+    */
+#if defined(PNG_WRITE_WEIGHTED_FILTER_SUPPORTED)
+   if (png_ptr->heuristic_method != PNG_FILTER_HEURISTIC_WEIGHTED)
+#endif
+   {
+      png_write_filtered_row(png_ptr,
+         png_write_find_filter_simd(png_ptr, row_bytes, bpp));
+      return;
+   }
+
    /* The prediction method we use is to find which method provides the
     * smallest value when summing the absolute values of the distances
     * from zero, using anything >= 128 as negative numbers.  This is known
@@ -122,7 +122,8 @@ typedef struct internal_state {
 
     ulg window_size;
     /* Actual size of window: 2*wSize, except when the user input buffer
-     * is directly used as sliding window.
+     * is directly used as sliding window. A few more bytes are allocated
+     * past the end, see WINDOW_PADDING in deflate.c.
      */
 
     Posf *prev;
@@ -139,10 +140,8 @@ typedef struct internal_state {
     uInt  hash_mask;      /* hash_size-1 */
 
     uInt  hash_shift;
-    /* Number of bits by which ins_h must be shifted at each input
-     * step. It must be such that after MIN_MATCH steps, the oldest
-     * byte no longer takes part in the hash key, that is:
-     *   hash_shift * MIN_MATCH >= hash_bits
+    /* Number of bits by which ins_h was shifted at each input step by the
+     * rolling hash, before HASH() in deflate.c replaced it. Not used.
      */
 
     long block_start;
@@ -8,4 +8,21 @@
    subject to change. Applications should only use zlib.h.
  */
 
+/* On 64-bit little-endian machines inflate_fast() refills its bit buffer eight
+   bytes at a time and copies matches in eight or sixteen byte chunks, which
+   may read that far ahead in the input and write up to fifteen bytes past the
+   end of a match.  NO_INFLATE_WIDE builds the byte at a time code instead.
+   inflate() and inflateBack() only call it with at least INFLATE_FAST_MIN_HAVE
+   bytes of input and INFLATE_FAST_MIN_LEFT bytes of output available. */
+#if !defined(NO_INFLATE_WIDE) && (defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__aarch64__) && defined(__BYTE_ORDER__) && \
+     __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+#  define INFLATE_WIDE
+#  define INFLATE_FAST_MIN_HAVE 8
+#  define INFLATE_FAST_MIN_LEFT 274
+#else
+#  define INFLATE_FAST_MIN_HAVE 6
+#  define INFLATE_FAST_MIN_LEFT 258
+#endif
+
 void inflate_fast OF((z_streamp strm, unsigned start));
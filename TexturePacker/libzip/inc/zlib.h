@@ -190,6 +190,7 @@ typedef gz_header FAR *gz_headerp;
 #define Z_HUFFMAN_ONLY        2
 #define Z_RLE                 3
 #define Z_FIXED               4
+#define Z_QUICK               5
 #define Z_DEFAULT_STRATEGY    0
 /* compression strategy; see deflateInit2() below for details */
 
@@ -527,7 +528,9 @@ ZEXTERN int ZEXPORT deflateInit2 OF((z_streamp strm,
    parameter only affects the compression ratio but not the correctness of the
    compressed output even if it is not set appropriately.  Z_FIXED prevents the
    use of dynamic Huffman codes, allowing for a simpler decoder for special
-   applications.
+   applications.  Z_QUICK trades compression for speed at any level but 0: each
+   string is only compared with the last one with the same hash, and the blocks
+   are sent with the static Huffman codes, as with Z_FIXED.
 
       deflateInit2 returns Z_OK if success, Z_MEM_ERROR if there was not enough
    memory, Z_STREAM_ERROR if a parameter is invalid (such as an invalid
@@ -1263,7 +1266,7 @@ ZEXTERN uLong ZEXPORT adler32 OF((uLong adler, const Bytef *buf, uInt len));
    return the updated checksum. If buf is NULL, this function returns
    the required initial value for the checksum.
    An Adler-32 checksum is almost as reliable as a CRC32 but can be computed
-   much faster. Usage example:
+   much faster. Uses SSSE3 or AVX2 when the CPU has them. Usage example:
 
      uLong adler = adler32(0L, Z_NULL, 0);
 
@@ -1288,6 +1291,7 @@ ZEXTERN uLong ZEXPORT crc32   OF((uLong crc, const Bytef *buf, uInt len));
    updated CRC-32. If buf is NULL, this function returns the required initial
    value for the for the crc. Pre- and post-conditioning (one's complement) is
    performed within this function so it shouldn't be done by the application.
+   Uses carry-less multiplication (PCLMULQDQ) when the CPU has it.
    Usage example:
 
      uLong crc = crc32(0L, Z_NULL, 0);
@@ -1309,6 +1313,21 @@ ZEXTERN uLong ZEXPORT crc32_combine OF((uLong crc1, uLong crc2, z_off_t len2));
 */
 
 
+#define Z_SIMD_SSE2     1
+#define Z_SIMD_SSSE3    2
+#define Z_SIMD_PCLMUL   4
+#define Z_SIMD_AVX2     8
+
+ZEXTERN int ZEXPORT zlibSimdSupport OF((int mask));
+/*
+     Return the vector instructions zlib uses, an or of the Z_SIMD_ flags
+   above: those built in that the CPU and operating system
+   support, limited to the ones in mask when mask is 0 or more, to compare or
+   test the code paths.  The limit applies to the whole library.  Pass -1 to
+   only ask.
+*/
+
+
                         /* various hacks, don't look :) */
 
 /* deflateInit and inflateInit are macros to allow checking the zlib version
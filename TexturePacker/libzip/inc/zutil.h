@@ -243,6 +243,32 @@ extern const char * const z_errmsg[10]; /* indexed by 2-zlib_error */
    extern void zmemzero OF((Bytef* dest, uInt len));
 #endif
 
+/* Vector code for x86 (SSE2, SSSE3, PCLMULQDQ and AVX2), picked at run time
+   from what the CPU has by z_simd() in zutil.c.  NO_SIMD builds without it;
+   other processors always use the C code. */
+#if !defined(NO_SIMD) && !defined(Z_X86_SIMD) && \
+    (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || \
+     defined(_M_X64))
+#  define Z_X86_SIMD
+   /* AVX2 intrinsics need gcc 4.9, clang or Visual C++ 2012 */
+#  if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || \
+      (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || \
+      (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define Z_X86_AVX2
+#  endif
+#endif
+#ifdef Z_X86_SIMD
+   /* gcc and clang only let a function use the instructions it is built for */
+#  ifdef __GNUC__
+#    define Z_TARGET(isa) __attribute__((target(isa)))
+#  else
+#    define Z_TARGET(isa)
+#  endif
+#endif
+
+   /* the Z_SIMD_ flags of the CPU that zlibSimdSupport() allows */
+   extern int z_simd OF((void));
+
 /* Diagnostic functions */
 #ifdef DEBUG
 #  include <stdio.h>
@@ -5,8 +5,7 @@
 
 /* @(#) $Id$ */
 
-#define ZLIB_INTERNAL
-#include "zlib.h"
+#include "zutil.h"
 
 #define BASE 65521UL    /* largest prime smaller than 65536 */
 #define NMAX 5552
@@ -53,6 +52,19 @@
 #  define MOD4(a) a %= BASE
 #endif
 
+#ifdef Z_X86_SIMD
+#  include <emmintrin.h>
+#  include <tmmintrin.h>
+#  ifdef Z_X86_AVX2
+#    include <immintrin.h>
+#  endif
+#  define BLOCK 32      /* bytes the vector code takes in at a time */
+   local uLong adler32_ssse3 OF((uLong adler, const Bytef *buf, uInt len));
+#  ifdef Z_X86_AVX2
+   local uLong adler32_avx2 OF((uLong adler, const Bytef *buf, uInt len));
+#  endif
+#endif /* Z_X86_SIMD */
+
 /* ========================================================================= */
 uLong ZEXPORT adler32(adler, buf, len)
     uLong adler;
@@ -93,6 +105,25 @@ uLong ZEXPORT adler32(adler, buf, len)
         return adler | (sum2 << 16);
     }
 
+#ifdef Z_X86_SIMD
+    /* whole 32-byte blocks with vector instructions, the rest below */
+    if (len >= 64 && (z_simd() & (Z_SIMD_SSSE3 | Z_SIMD_AVX2))) {
+        unsigned blocks = len & ~(BLOCK - 1U);
+
+        adler |= sum2 << 16;
+#  ifdef Z_X86_AVX2
+        if (z_simd() & Z_SIMD_AVX2)
+            adler = adler32_avx2(adler, buf, blocks);
+        else
+#  endif
+            adler = adler32_ssse3(adler, buf, blocks);
+        sum2 = adler >> 16;
+        adler &= 0xffff;
+        buf += blocks;
+        len -= blocks;
+    }
+#endif /* Z_X86_SIMD */
+
     /* do length NMAX blocks -- requires just one modulo operation */
     while (len >= NMAX) {
         len -= NMAX;
@@ -124,6 +155,138 @@ uLong ZEXPORT adler32(adler, buf, len)
     return adler | (sum2 << 16);
 }
 
+#ifdef Z_X86_SIMD
+
+/* ========================================================================= */
+/*
+  Adler-32 of len bytes, a multiple of BLOCK, with vector instructions.  For
+  each block, the byte sum of the block is added to the first sum, and to the
+  second one the bytes times their weights BLOCK down to 1, from pmaddubsw, plus
+  BLOCK times the first sum as it was before the block.  That last part is
+  gathered in ps, the running total of the first sums, and multiplied by BLOCK
+  once at the end of each stretch of up to NMAX bytes, where both sums are
+  reduced modulo BASE as in adler32().  The sums are kept in 32-bit lanes that
+  are added up at the same time.
+*/
+local Z_TARGET("ssse3") uLong adler32_ssse3(adler, buf, len)
+    uLong adler;
+    const Bytef *buf;
+    uInt len;
+{
+    unsigned long sum1, sum2;
+    unsigned n;
+    __m128i zero, ones, tap1, tap2, bytes1, bytes2, v_s1, v_s2, v_ps;
+
+    sum1 = adler & 0xffff;
+    sum2 = adler >> 16;
+    zero = _mm_setzero_si128();
+    ones = _mm_set1_epi16(1);
+    tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                         24, 23, 22, 21, 20, 19, 18, 17);
+    tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9,
+                         8, 7, 6, 5, 4, 3, 2, 1);
+
+    len /= BLOCK;
+    while (len) {
+        n = NMAX / BLOCK;
+        if (n > len)
+            n = len;
+        len -= n;
+
+        v_s1 = zero;
+        v_s2 = _mm_cvtsi32_si128((int)sum2);
+        v_ps = _mm_cvtsi32_si128((int)(sum1 * n));
+        do {
+            bytes1 = _mm_loadu_si128((const __m128i *)buf);
+            bytes2 = _mm_loadu_si128((const __m128i *)(buf + 16));
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+            v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+            buf += BLOCK;
+        } while (--n);
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        /* add up the lanes */
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0x4e));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0xb1));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0x4e));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0xb1));
+        sum1 += (unsigned)_mm_cvtsi128_si32(v_s1);
+        sum2 = (unsigned)_mm_cvtsi128_si32(v_s2);
+        MOD(sum1);
+        MOD(sum2);
+    }
+    return sum1 | (sum2 << 16);
+}
+
+#ifdef Z_X86_AVX2
+
+/* ========================================================================= */
+/* As adler32_ssse3(), a whole block in each 32-byte register. */
+local Z_TARGET("avx2") uLong adler32_avx2(adler, buf, len)
+    uLong adler;
+    const Bytef *buf;
+    uInt len;
+{
+    unsigned long sum1, sum2;
+    unsigned n;
+    __m256i zero, ones, tap, bytes, v_s1, v_s2, v_ps;
+    __m128i s1, s2;
+
+    sum1 = adler & 0xffff;
+    sum2 = adler >> 16;
+    zero = _mm256_setzero_si256();
+    ones = _mm256_set1_epi16(1);
+    tap = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                           24, 23, 22, 21, 20, 19, 18, 17,
+                           16, 15, 14, 13, 12, 11, 10, 9,
+                           8, 7, 6, 5, 4, 3, 2, 1);
+
+    len /= BLOCK;
+    while (len) {
+        n = NMAX / BLOCK;
+        if (n > len)
+            n = len;
+        len -= n;
+
+        v_s1 = zero;
+        v_s2 = _mm256_setr_epi32((int)sum2, 0, 0, 0, 0, 0, 0, 0);
+        v_ps = _mm256_setr_epi32((int)(sum1 * n), 0, 0, 0, 0, 0, 0, 0);
+        do {
+            bytes = _mm256_loadu_si256((const __m256i *)buf);
+            v_ps = _mm256_add_epi32(v_ps, v_s1);
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+            v_s2 = _mm256_add_epi32(v_s2,
+                       _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+            buf += BLOCK;
+        } while (--n);
+        v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+
+        /* add up the lanes */
+        s1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1),
+                           _mm256_extracti128_si256(v_s1, 1));
+        s2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2),
+                           _mm256_extracti128_si256(v_s2, 1));
+        s1 = _mm_add_epi32(s1, _mm_shuffle_epi32(s1, 0x4e));
+        s1 = _mm_add_epi32(s1, _mm_shuffle_epi32(s1, 0xb1));
+        s2 = _mm_add_epi32(s2, _mm_shuffle_epi32(s2, 0x4e));
+        s2 = _mm_add_epi32(s2, _mm_shuffle_epi32(s2, 0xb1));
+        sum1 += (unsigned)_mm_cvtsi128_si32(s1);
+        sum2 = (unsigned)_mm_cvtsi128_si32(s2);
+        MOD(sum1);
+        MOD(sum2);
+    }
+    return sum1 | (sum2 << 16);
+}
+
+#endif /* Z_X86_AVX2 */
+
+#endif /* Z_X86_SIMD */
+
 /* ========================================================================= */
 uLong ZEXPORT adler32_combine(adler1, adler2, len2)
     uLong adler1;
@@ -74,8 +74,10 @@ typedef block_state (*compress_func) OF((deflate_state *s, int flush));
 /* Compression function. Returns the block state after the call. */
 
 local void fill_window    OF((deflate_state *s));
+local void slide_hash     OF((deflate_state *s));
 local block_state deflate_stored OF((deflate_state *s, int flush));
 local block_state deflate_fast   OF((deflate_state *s, int flush));
+local block_state deflate_quick  OF((deflate_state *s, int flush));
 #ifndef FASTEST
 local block_state deflate_slow   OF((deflate_state *s, int flush));
 #endif
@@ -115,6 +117,42 @@ local  void check_match OF((deflate_state *s, IPos start, IPos match,
  * See deflate.c for comments about the MIN_MATCH+1.
  */
 
+#define WINDOW_PADDING 8
+/* Bytes allocated past each half of the window, so that the hash and the
+ * match compares can read a whole word past the end of the lookahead.  They
+ * are cleared with the window, and the output never depends on them.
+ */
+
+/* Compare strings eight bytes at a time where the bytes of a word are known to
+ * be in little-endian order, and find the first differing byte from the
+ * number of trailing zero bits of their exclusive-or.
+ */
+#if defined(__GNUC__) && defined(__BYTE_ORDER__)
+#  if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#    define WORD_MATCH
+     typedef unsigned long long match_word;
+#    define first_diff(d) ((unsigned)__builtin_ctzll(d) >> 3)
+#  endif
+#elif defined(_MSC_VER) && defined(_M_X64)
+#  include <intrin.h>
+#  define WORD_MATCH
+   typedef unsigned __int64 match_word;
+   local unsigned first_diff(match_word d)
+   {
+       unsigned long bit;
+       _BitScanForward64(&bit, d);
+       return (unsigned)bit >> 3;
+   }
+#endif
+local ulg read32 OF((const Bytef *p));
+#ifdef WORD_MATCH
+   local unsigned compare258 OF((const Bytef *scan, const Bytef *match));
+#endif
+#ifdef Z_X86_SIMD
+#  include <emmintrin.h>
+   local void slide_hash_sse2 OF((Posf *table, unsigned n, uInt wsize));
+#endif
+
 /* Values for max_lazy_match, good_match and max_chain_length, depending on
  * the desired pack level (0..9). The values given below have been tuned to
  * exclude worst case performance for pathological files. Better values may be
@@ -162,12 +200,36 @@ struct static_tree_desc_s {int dummy;}; /* for buggy compilers */
 #endif
 
 /* ===========================================================================
- * Update a hash value with the given input byte
- * IN  assertion: all calls to to UPDATE_HASH are made with consecutive
- *    input characters, so that a running hash key can be computed from the
- *    previous key instead of complete recalculation each time.
+ * Hash of the MIN_MATCH+1 bytes at window[str]: the top hash_bits bits of the
+ * bytes taken as a little-endian 32-bit number times 2654435761, a prime close
+ * to 2^32 divided by the golden ratio (Knuth's multiplicative hashing). Unlike
+ * the rolling hash of the first MIN_MATCH bytes it replaces, it mixes every
+ * input bit into the key and keeps the strings that differ in their fourth
+ * byte off the chain, so the chains are shorter and longest_match() looks at
+ * far fewer strings that cannot be the best match. It is computed afresh for
+ * each string, ins_h only holds the last one. Matches of just MIN_MATCH bytes
+ * are only found when the next byte also matches, a small loss at worst for
+ * deflate_slow() which drops them when they are far anyway.
  */
-#define UPDATE_HASH(s,h,c) (h = (((h)<<s->hash_shift) ^ (c)) & s->hash_mask)
+#define HASH(s, str) \
+   ((uInt)(((read32(s->window + (str)) * 2654435761UL) & 0xffffffffUL) >> \
+           (32 - s->hash_bits)))
+
+/* The 4 bytes at p as a little-endian number, in one load where it is the
+ * order of the bytes in a word.
+ */
+local ulg read32(p)
+    const Bytef *p;
+{
+#ifdef WORD_MATCH
+    unsigned int w;
+
+    zmemcpy((Bytef *)&w, p, 4);
+    return (ulg)w;
+#else
+    return (ulg)p[0] | (ulg)p[1] << 8 | (ulg)p[2] << 16 | (ulg)p[3] << 24;
+#endif
+}
 
 
 /* ===========================================================================
@@ -182,12 +244,12 @@ struct static_tree_desc_s {int dummy;}; /* for buggy compilers */
  */
 #ifdef FASTEST
 #define INSERT_STRING(s, str, match_head) \
-   (UPDATE_HASH(s, s->ins_h, s->window[(str) + (MIN_MATCH-1)]), \
+   (s->ins_h = HASH(s, str), \
     match_head = s->head[s->ins_h], \
     s->head[s->ins_h] = (Pos)(str))
 #else
 #define INSERT_STRING(s, str, match_head) \
-   (UPDATE_HASH(s, s->ins_h, s->window[(str) + (MIN_MATCH-1)]), \
+   (s->ins_h = HASH(s, str), \
     match_head = s->prev[(str) & s->w_mask] = s->head[s->ins_h], \
     s->head[s->ins_h] = (Pos)(str))
 #endif
@@ -264,7 +326,7 @@ int ZEXPORT deflateInit2_(strm, level, method, windowBits, memLevel, strategy,
 #endif
     if (memLevel < 1 || memLevel > MAX_MEM_LEVEL || method != Z_DEFLATED ||
         windowBits < 8 || windowBits > 15 || level < 0 || level > 9 ||
-        strategy < 0 || strategy > Z_FIXED) {
+        strategy < 0 || strategy > Z_QUICK) {
         return Z_STREAM_ERROR;
     }
     if (windowBits == 8) windowBits = 9;  /* until 256-byte window bug fixed */
@@ -284,7 +346,8 @@ int ZEXPORT deflateInit2_(strm, level, method, windowBits, memLevel, strategy,
     s->hash_mask = s->hash_size - 1;
     s->hash_shift =  ((s->hash_bits+MIN_MATCH-1)/MIN_MATCH);
 
-    s->window = (Bytef *) ZALLOC(strm, s->w_size, 2*sizeof(Byte));
+    s->window = (Bytef *) ZALLOC(strm, s->w_size + WINDOW_PADDING,
+                                 2*sizeof(Byte));
     s->prev   = (Posf *)  ZALLOC(strm, s->w_size, sizeof(Pos));
     s->head   = (Posf *)  ZALLOC(strm, s->hash_size, sizeof(Pos));
 
@@ -301,6 +364,8 @@ int ZEXPORT deflateInit2_(strm, level, method, windowBits, memLevel, strategy,
         deflateEnd (strm);
         return Z_MEM_ERROR;
     }
+    /* the bytes past the input are read, so that they are always the same */
+    zmemzero(s->window, (s->w_size + WINDOW_PADDING) * 2*sizeof(Byte));
     s->d_buf = overlay + s->lit_bufsize/sizeof(ush);
     s->l_buf = s->pending_buf + (1+sizeof(ush))*s->lit_bufsize;
 
@@ -341,11 +406,7 @@ int ZEXPORT deflateSetDictionary (strm, dictionary, dictLength)
     s->block_start = (long)length;
 
     /* Insert all strings in the hash table (except for the last two bytes).
-     * s->lookahead stays null, so s->ins_h will be recomputed at the next
-     * call of fill_window.
      */
-    s->ins_h = s->window[0];
-    UPDATE_HASH(s, s->ins_h, s->window[1]);
     for (n = 0; n <= length - MIN_MATCH; n++) {
         INSERT_STRING(s, n, hash_head);
     }
@@ -430,12 +491,15 @@ int ZEXPORT deflateParams(strm, level, strategy)
 #else
     if (level == Z_DEFAULT_COMPRESSION) level = 6;
 #endif
-    if (level < 0 || level > 9 || strategy < 0 || strategy > Z_FIXED) {
+    if (level < 0 || level > 9 || strategy < 0 || strategy > Z_QUICK) {
         return Z_STREAM_ERROR;
     }
     func = configuration_table[s->level].func;
 
-    if (func != configuration_table[level].func && strm->total_in != 0) {
+    /* Z_QUICK has a compression function of its own, see deflate() */
+    if ((func != configuration_table[level].func ||
+         (s->strategy == Z_QUICK) != (strategy == Z_QUICK)) &&
+        strm->total_in != 0) {
         /* Flush the last buffer: */
         err = deflate(strm, Z_PARTIAL_FLUSH);
     }
@@ -501,9 +565,10 @@ uLong ZEXPORT deflateBound(strm, sourceLen)
     if (strm == Z_NULL || strm->state == Z_NULL)
         return destLen;
 
-    /* if not default parameters, return conservative bound */
+    /* if not default parameters, return conservative bound; Z_QUICK blocks
+       hold half as many symbols, so the stored ones among them cost more */
     s = strm->state;
-    if (s->w_bits != 15 || s->hash_bits != 8 + 7)
+    if (s->w_bits != 15 || s->hash_bits != 8 + 7 || s->strategy == Z_QUICK)
         return destLen;
 
     /* default settings: return tight bound for that case */
@@ -787,7 +852,9 @@ int ZEXPORT deflate (strm, flush)
         (flush != Z_NO_FLUSH && s->status != FINISH_STATE)) {
         block_state bstate;
 
-        bstate = (*(configuration_table[s->level].func))(s, flush);
+        bstate = s->strategy == Z_QUICK && s->level != 0 ?
+                 deflate_quick(s, flush) :
+                 (*(configuration_table[s->level].func))(s, flush);
 
         if (bstate == finish_started || bstate == finish_done) {
             s->status = FINISH_STATE;
@@ -917,7 +984,8 @@ int ZEXPORT deflateCopy (dest, source)
     zmemcpy(ds, ss, sizeof(deflate_state));
     ds->strm = dest;
 
-    ds->window = (Bytef *) ZALLOC(dest, ds->w_size, 2*sizeof(Byte));
+    ds->window = (Bytef *) ZALLOC(dest, ds->w_size + WINDOW_PADDING,
+                                  2*sizeof(Byte));
     ds->prev   = (Posf *)  ZALLOC(dest, ds->w_size, sizeof(Pos));
     ds->head   = (Posf *)  ZALLOC(dest, ds->hash_size, sizeof(Pos));
     overlay = (ushf *) ZALLOC(dest, ds->lit_bufsize, sizeof(ush)+2);
@@ -929,7 +997,8 @@ int ZEXPORT deflateCopy (dest, source)
         return Z_MEM_ERROR;
     }
     /* following zmemcpy do not work for 16-bit MSDOS */
-    zmemcpy(ds->window, ss->window, ds->w_size * 2 * sizeof(Byte));
+    zmemcpy(ds->window, ss->window,
+            (ds->w_size + WINDOW_PADDING) * 2 * sizeof(Byte));
     zmemcpy(ds->prev, ss->prev, ds->w_size * sizeof(Pos));
     zmemcpy(ds->head, ss->head, ds->hash_size * sizeof(Pos));
     zmemcpy(ds->pending_buf, ss->pending_buf, (uInt)ds->pending_buf_size);
@@ -1042,7 +1111,10 @@ local uInt longest_match(s, cur_match)
     Posf *prev = s->prev;
     uInt wmask = s->w_mask;
 
-#ifdef UNALIGNED_OK
+#if defined(WORD_MATCH)
+    register Byte scan_end1  = scan[best_len-1];
+    register Byte scan_end   = scan[best_len];
+#elif defined(UNALIGNED_OK)
     /* Compare two bytes at a time. Note: this is not always beneficial.
      * Try with and without -DUNALIGNED_OK to check.
      */
@@ -1083,23 +1155,32 @@ local uInt longest_match(s, cur_match)
          * However the length of the match is limited to the lookahead, so
          * the output of deflate is not affected by the uninitialized values.
          */
-#if (defined(UNALIGNED_OK) && MAX_MATCH == 258)
+#if defined(WORD_MATCH)
+        if (match[best_len]   != scan_end  ||
+            match[best_len-1] != scan_end1 ||
+            *match            != *scan     ||
+            match[1]          != scan[1])      continue;
+
+        /* Compare the whole strings eight bytes at a time, from the start
+         * since equal hash keys do not make any of the bytes equal.
+         */
+        len = (int)compare258(scan, match);
+
+#elif (defined(UNALIGNED_OK) && MAX_MATCH == 258)
         /* This code assumes sizeof(unsigned short) == 2. Do not use
          * UNALIGNED_OK if your compiler uses a different size.
          */
         if (*(ushf*)(match+best_len-1) != scan_end ||
-            *(ushf*)match != scan_start) continue;
+            *(ushf*)match != scan_start ||
+            match[2] != scan[2]) continue;
 
-        /* It is not necessary to compare scan[2] and match[2] since they are
-         * always equal when the other bytes match, given that the hash keys
-         * are equal and that HASH_BITS >= 8. Compare 2 bytes at a time at
-         * strstart+3, +5, ... up to strstart+257. We check for insufficient
+        /* Compare 2 bytes at a time at strstart+3, +5, ... up to
+         * strstart+257. We check for insufficient
          * lookahead only every 4th comparison; the 128th check will be made
          * at strstart+257. If MAX_MATCH-2 is not a multiple of 8, it is
          * necessary to put more guard bytes at the end of the window, or
          * to check more often for insufficient lookahead.
          */
-        Assert(scan[2] == match[2], "scan[2]?");
         scan++, match++;
         do {
         } while (*(ushf*)(scan+=2) == *(ushf*)(match+=2) &&
@@ -1120,17 +1201,14 @@ local uInt longest_match(s, cur_match)
 
         if (match[best_len]   != scan_end  ||
             match[best_len-1] != scan_end1 ||
+            match[2]          != scan[2]   ||
             *match            != *scan     ||
             *++match          != scan[1])      continue;
 
         /* The check at best_len-1 can be removed because it will be made
          * again later. (This heuristic is not always a win.)
-         * It is not necessary to compare scan[2] and match[2] since they
-         * are always equal when the other bytes match, given that
-         * the hash keys are equal and that HASH_BITS >= 8.
          */
         scan += 2, match++;
-        Assert(*scan == *match, "match[2]?");
 
         /* We check for insufficient lookahead only every 8th comparison;
          * the 256th check will be made at strstart+258.
@@ -1147,13 +1225,13 @@ local uInt longest_match(s, cur_match)
         len = MAX_MATCH - (int)(strend - scan);
         scan = strend - MAX_MATCH;
 
-#endif /* UNALIGNED_OK */
+#endif /* WORD_MATCH */
 
         if (len > best_len) {
             s->match_start = cur_match;
             best_len = len;
             if (len >= nice_match) break;
-#ifdef UNALIGNED_OK
+#if defined(UNALIGNED_OK) && !defined(WORD_MATCH)
             scan_end = *(ushf*)(scan+best_len-1);
 #else
             scan_end1  = scan[best_len-1];
@@ -1170,7 +1248,7 @@ local uInt longest_match(s, cur_match)
 #endif /* FASTEST */
 
 /* ---------------------------------------------------------------------------
- * Optimized version for level == 1 or strategy == Z_RLE only
+ * Optimized version for level == 1, strategy == Z_RLE or Z_QUICK only
  */
 local uInt longest_match_fast(s, cur_match)
     deflate_state *s;
@@ -1179,7 +1257,9 @@ local uInt longest_match_fast(s, cur_match)
     register Bytef *scan = s->window + s->strstart; /* current string */
     register Bytef *match;                       /* matched string */
     register int len;                           /* length of current match */
+#ifndef WORD_MATCH
     register Bytef *strend = s->window + s->strstart + MAX_MATCH;
+#endif
 
     /* The code is optimized for HASH_BITS >= 8 and MAX_MATCH-2 multiple of 16.
      * It is easy to get rid of this optimization if necessary.
@@ -1192,18 +1272,15 @@ local uInt longest_match_fast(s, cur_match)
 
     match = s->window + cur_match;
 
-    /* Return failure if the match length is less than 2:
+#ifdef WORD_MATCH
+    len = (int)compare258(scan, match);
+#else
+    /* Return failure if the match length is less than 3:
      */
-    if (match[0] != scan[0] || match[1] != scan[1]) return MIN_MATCH-1;
+    if (match[0] != scan[0] || match[1] != scan[1] || match[2] != scan[2])
+        return MIN_MATCH-1;
 
-    /* The check at best_len-1 can be removed because it will be made
-     * again later. (This heuristic is not always a win.)
-     * It is not necessary to compare scan[2] and match[2] since they
-     * are always equal when the other bytes match, given that
-     * the hash keys are equal and that HASH_BITS >= 8.
-     */
     scan += 2, match += 2;
-    Assert(*scan == *match, "match[2]?");
 
     /* We check for insufficient lookahead only every 8th comparison;
      * the 256th check will be made at strstart+258.
@@ -1218,6 +1295,7 @@ local uInt longest_match_fast(s, cur_match)
     Assert(scan <= s->window+(unsigned)(s->window_size-1), "wild scan");
 
     len = MAX_MATCH - (int)(strend - scan);
+#endif /* WORD_MATCH */
 
     if (len < MIN_MATCH) return MIN_MATCH - 1;
 
@@ -1225,6 +1303,32 @@ local uInt longest_match_fast(s, cur_match)
     return (uInt)len <= s->lookahead ? (uInt)len : s->lookahead;
 }
 
+#ifdef WORD_MATCH
+/* ===========================================================================
+ * Length of the common start of the strings at scan and match, at most
+ * MAX_MATCH. Reads up to MAX_MATCH+5 bytes of each, which the lookahead or
+ * the padding of the window always has.
+ */
+local unsigned compare258(scan, match)
+    const Bytef *scan;
+    const Bytef *match;
+{
+    match_word a, b;
+    unsigned len = 0;
+
+    do {
+        zmemcpy((Bytef *)&a, scan + len, sizeof(a));
+        zmemcpy((Bytef *)&b, match + len, sizeof(b));
+        if (a != b) {
+            len += first_diff(a ^ b);
+            return len < MAX_MATCH ? len : MAX_MATCH;
+        }
+        len += sizeof(match_word);
+    } while (len < MAX_MATCH);
+    return MAX_MATCH;
+}
+#endif /* WORD_MATCH */
+
 #ifdef DEBUG
 /* ===========================================================================
  * Check that the match at match_start is indeed a match.
@@ -1253,6 +1357,65 @@ local void check_match(s, start, match, length)
 #  define check_match(s, start, match, length)
 #endif /* DEBUG */
 
+/* ===========================================================================
+ * Slide the hash table (could be avoided with 32 bit values at the expense of
+ * memory usage) after the window moved down by wsize bytes: positions below
+ * wsize drop off to NIL, the others go down by wsize.
+ */
+local void slide_hash(s)
+    deflate_state *s;
+{
+    register unsigned n, m;
+    register Posf *p;
+    uInt wsize = s->w_size;
+
+#ifdef Z_X86_SIMD
+    if (z_simd() & Z_SIMD_SSE2) {
+        slide_hash_sse2(s->head, s->hash_size, wsize);
+#ifndef FASTEST
+        slide_hash_sse2(s->prev, wsize, wsize);
+#endif
+        return;
+    }
+#endif
+    n = s->hash_size;
+    p = &s->head[n];
+    do {
+        m = *--p;
+        *p = (Pos)(m >= wsize ? m-wsize : NIL);
+    } while (--n);
+
+    n = wsize;
+#ifndef FASTEST
+    p = &s->prev[n];
+    do {
+        m = *--p;
+        *p = (Pos)(m >= wsize ? m-wsize : NIL);
+        /* If n is not on any hash chain, prev[n] is garbage but
+         * its value will never be used.
+         */
+    } while (--n);
+#endif
+}
+
+#ifdef Z_X86_SIMD
+/* ===========================================================================
+ * The same for n entries, a multiple of eight, eight at a time. Subtracting
+ * with unsigned saturation stops at zero, which is NIL.
+ */
+local Z_TARGET("sse2") void slide_hash_sse2(table, n, wsize)
+    Posf *table;
+    unsigned n;
+    uInt wsize;
+{
+    __m128i w = _mm_set1_epi16((short)wsize);
+    __m128i *p = (__m128i *)table;
+
+    for (; n != 0; n -= 8, p++)
+        _mm_storeu_si128(p, _mm_subs_epu16(_mm_loadu_si128(p), w));
+}
+#endif
+
 /* ===========================================================================
  * Fill the window when the lookahead becomes insufficient.
  * Updates strstart and lookahead.
@@ -1266,8 +1429,7 @@ local void check_match(s, start, match, length)
 local void fill_window(s)
     deflate_state *s;
 {
-    register unsigned n, m;
-    register Posf *p;
+    register unsigned n;
     unsigned more;    /* Amount of free space at the end of the window. */
     uInt wsize = s->w_size;
 
@@ -1297,31 +1459,13 @@ local void fill_window(s)
             s->strstart    -= wsize; /* we now have strstart >= MAX_DIST */
             s->block_start -= (long) wsize;
 
-            /* Slide the hash table (could be avoided with 32 bit values
-               at the expense of memory usage). We slide even when level == 0
-               to keep the hash table consistent if we switch back to level > 0
-               later. (Using level 0 permanently is not an optimal usage of
-               zlib, so we don't care about this pathological case.)
+            /* We slide the hash table even when level == 0 to keep it
+               consistent if we switch back to level > 0 later. (Using level 0
+               permanently is not an optimal usage of zlib, so we don't care
+               about this pathological case.)
              */
             /* %%% avoid this when Z_RLE */
-            n = s->hash_size;
-            p = &s->head[n];
-            do {
-                m = *--p;
-                *p = (Pos)(m >= wsize ? m-wsize : NIL);
-            } while (--n);
-
-            n = wsize;
-#ifndef FASTEST
-            p = &s->prev[n];
-            do {
-                m = *--p;
-                *p = (Pos)(m >= wsize ? m-wsize : NIL);
-                /* If n is not on any hash chain, prev[n] is garbage but
-                 * its value will never be used.
-                 */
-            } while (--n);
-#endif
+            slide_hash(s);
             more += wsize;
         }
         if (s->strm->avail_in == 0) return;
@@ -1342,18 +1486,6 @@ local void fill_window(s)
         n = read_buf(s->strm, s->window + s->strstart + s->lookahead, more);
         s->lookahead += n;
 
-        /* Initialize the hash value now that we have some input: */
-        if (s->lookahead >= MIN_MATCH) {
-            s->ins_h = s->window[s->strstart];
-            UPDATE_HASH(s, s->ins_h, s->window[s->strstart+1]);
-#if MIN_MATCH != 3
-            Call UPDATE_HASH() MIN_MATCH-3 more times
-#endif
-        }
-        /* If the whole input has less than MIN_MATCH bytes, ins_h is garbage,
-         * but this is not important since only literal bytes will be emitted.
-         */
-
     } while (s->lookahead < MIN_LOOKAHEAD && s->strm->avail_in != 0);
 }
 
@@ -1523,14 +1655,6 @@ local block_state deflate_fast(s, flush)
             {
                 s->strstart += s->match_length;
                 s->match_length = 0;
-                s->ins_h = s->window[s->strstart];
-                UPDATE_HASH(s, s->ins_h, s->window[s->strstart+1]);
-#if MIN_MATCH != 3
-                Call UPDATE_HASH() MIN_MATCH-3 more times
-#endif
-                /* If lookahead < MIN_MATCH, ins_h is garbage, but it does not
-                 * matter since it will be recomputed at next deflate call.
-                 */
             }
         } else {
             /* No match, output a literal byte */
@@ -1545,6 +1669,67 @@ local block_state deflate_fast(s, flush)
     return flush == Z_FINISH ? finish_done : block_done;
 }
 
+/* ===========================================================================
+ * Compress as fast as possible, for strategy Z_QUICK at any level but 0.
+ * Like deflate_fast(), but each string is only compared with the last one
+ * that had the same hash key, not with the older ones on its chain, and the
+ * strings inside a match are not inserted. The blocks are always sent with
+ * the static trees, saving the building of the dynamic ones, see
+ * _tr_flush_block().
+ */
+local block_state deflate_quick(s, flush)
+    deflate_state *s;
+    int flush;
+{
+    IPos hash_head;       /* head of the hash chain */
+    int bflush;           /* set if current block must be flushed */
+
+    for (;;) {
+        /* Make sure that we always have enough lookahead, except
+         * at the end of the input file, as in deflate_fast().
+         */
+        if (s->lookahead < MIN_LOOKAHEAD) {
+            fill_window(s);
+            if (s->lookahead < MIN_LOOKAHEAD && flush == Z_NO_FLUSH) {
+                return need_more;
+            }
+            if (s->lookahead == 0) break; /* flush the current block */
+        }
+
+        s->match_length = MIN_MATCH-1;
+        if (s->lookahead >= MIN_MATCH) {
+            INSERT_STRING(s, s->strstart, hash_head);
+            if (hash_head != NIL && s->strstart - hash_head <= MAX_DIST(s)) {
+                s->match_length = longest_match_fast (s, hash_head);
+            }
+        }
+        if (s->match_length >= MIN_MATCH) {
+            check_match(s, s->strstart, s->match_start, s->match_length);
+
+            _tr_tally_dist(s, s->strstart - s->match_start,
+                           s->match_length - MIN_MATCH, bflush);
+
+            s->lookahead -= s->match_length;
+            s->strstart += s->match_length;
+            s->match_length = 0; /* deflate_slow() may take over, see deflateParams */
+        } else {
+            /* No match, output a literal byte */
+            Tracevv((stderr,"%c", s->window[s->strstart]));
+            _tr_tally_lit (s, s->window[s->strstart], bflush);
+            s->lookahead--;
+            s->strstart++;
+        }
+        /* A match can take 31 bits with the static trees, more than the
+         * three bytes of d_buf and l_buf it had, and the codes sent would
+         * catch up with the symbols not read yet in the pending_buf overlay
+         * (see deflateInit2); with half as many symbols a block they cannot.
+         */
+        if (bflush || s->last_lit == s->lit_bufsize/2) FLUSH_BLOCK(s, 0);
+    }
+    FLUSH_BLOCK(s, flush == Z_FINISH);
+    return flush == Z_FINISH ? finish_done : block_done;
+}
+
 #ifndef FASTEST
 /* ===========================================================================
  * Same as above, but achieves better compression. We use a lazy
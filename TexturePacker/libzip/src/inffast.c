@@ -29,6 +29,33 @@
 #  define PUP(a) *++(a)
 #endif
 
+#ifdef INFLATE_WIDE
+   /* hold takes the next eight input bytes at the top of each loop with one
+      load, in += 7 - bits / 8 and bits |= 56.  That leaves at least 56 bits,
+      enough for a whole length/distance pair, so the other refills are gone.
+      The bits of hold above bits are the next input bits then, not zeros, and
+      loading them again on the next refill does not change them. */
+#  ifdef _MSC_VER
+     typedef unsigned __int64 bit_hold;
+#  else
+     typedef unsigned long long bit_hold;
+#  endif
+#  define REFILL() { \
+       bit_hold w; \
+       zmemcpy((Bytef *)&w, in + OFF, sizeof(w)); \
+       hold |= w << bits; \
+       in += 7 - (bits >> 3); \
+       bits |= 56; \
+   }
+#  define PULLBYTE() {}
+   local unsigned char FAR *chunk_copy OF((unsigned char FAR *out,
+                                           unsigned dist, unsigned len));
+#else
+   typedef unsigned long bit_hold;
+#  define REFILL() if (bits < 15) { PULLBYTE(); PULLBYTE(); }
+#  define PULLBYTE() { hold += (unsigned long)(PUP(in)) << bits; bits += 8; }
+#endif
+
 /*
    Decode literal, length, and distance codes and write out the resulting
    literal and match bytes until either not enough input or output is
@@ -40,8 +67,8 @@
    Entry assumptions:
 
         state->mode == LEN
-        strm->avail_in >= 6
-        strm->avail_out >= 258
+        strm->avail_in >= INFLATE_FAST_MIN_HAVE
+        strm->avail_out >= INFLATE_FAST_MIN_LEFT
         start >= strm->avail_out
         state->bits < 8
 
@@ -63,6 +90,9 @@
       bytes, which is the maximum length that can be coded.  inflate_fast()
       requires strm->avail_out >= 258 for each loop to avoid checking for
       output space.
+
+    - INFLATE_WIDE needs two more bytes of input for its eight byte loads, and
+      sixteen more bytes of output for the chunks copied past a match.
  */
 void inflate_fast(strm, start)
 z_streamp strm;
@@ -81,7 +111,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     unsigned whave;             /* valid bytes in the window */
     unsigned write;             /* window write index */
     unsigned char FAR *window;  /* allocated sliding window, if wsize != 0 */
-    unsigned long hold;         /* local strm->hold */
+    bit_hold hold;              /* local strm->hold */
     unsigned bits;              /* local strm->bits */
     code const FAR *lcode;      /* local strm->lencode */
     code const FAR *dcode;      /* local strm->distcode */
@@ -97,10 +127,10 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* copy state to local variables */
     state = (struct inflate_state FAR *)strm->state;
     in = strm->next_in - OFF;
-    last = in + (strm->avail_in - 5);
+    last = in + (strm->avail_in - (INFLATE_FAST_MIN_HAVE - 1));
     out = strm->next_out - OFF;
     beg = out - (start - strm->avail_out);
-    end = out + (strm->avail_out - 257);
+    end = out + (strm->avail_out - (INFLATE_FAST_MIN_LEFT - 1));
 #ifdef INFLATE_STRICT
     dmax = state->dmax;
 #endif
@@ -118,12 +148,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* decode literals and length/distances until end-of-block or not enough
        input data or output space */
     do {
-        if (bits < 15) {
-            hold += (unsigned long)(PUP(in)) << bits;
-            bits += 8;
-            hold += (unsigned long)(PUP(in)) << bits;
-            bits += 8;
-        }
+        REFILL();
         this = lcode[hold & lmask];
       dolen:
         op = (unsigned)(this.bits);
@@ -140,21 +165,15 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
             len = (unsigned)(this.val);
             op &= 15;                           /* number of extra bits */
             if (op) {
-                if (bits < op) {
-                    hold += (unsigned long)(PUP(in)) << bits;
-                    bits += 8;
-                }
+                if (bits < op) PULLBYTE();
                 len += (unsigned)hold & ((1U << op) - 1);
                 hold >>= op;
                 bits -= op;
             }
             Tracevv((stderr, "inflate:         length %u\n", len));
-            if (bits < 15) {
-                hold += (unsigned long)(PUP(in)) << bits;
-                bits += 8;
-                hold += (unsigned long)(PUP(in)) << bits;
-                bits += 8;
-            }
+#ifndef INFLATE_WIDE
+            REFILL();
+#endif
             this = dcode[hold & dmask];
           dodist:
             op = (unsigned)(this.bits);
@@ -165,12 +184,8 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 dist = (unsigned)(this.val);
                 op &= 15;                       /* number of extra bits */
                 if (bits < op) {
-                    hold += (unsigned long)(PUP(in)) << bits;
-                    bits += 8;
-                    if (bits < op) {
-                        hold += (unsigned long)(PUP(in)) << bits;
-                        bits += 8;
-                    }
+                    PULLBYTE();
+                    if (bits < op) PULLBYTE();
                 }
                 dist += (unsigned)hold & ((1U << op) - 1);
 #ifdef INFLATE_STRICT
@@ -192,6 +207,38 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                         break;
                     }
                     from = window - OFF;
+#ifdef INFLATE_WIDE
+                    /* op bytes of the window from from on, and then maybe
+                       write more from its start, come before the output */
+                    if (write == 0)             /* very common case */
+                        from += wsize - op;
+                    else if (write < op) {      /* wrap around window */
+                        from += wsize + write - op;
+                        op -= write;
+                        if (op < len) {         /* some from end of window */
+                            zmemcpy(out + OFF, from + OFF, op);
+                            out += op;
+                            len -= op;
+                            from = window - OFF;
+                            op = write;
+                        }
+                    }
+                    else                        /* contiguous in window */
+                        from += write - op;
+                    if (op >= len) {            /* all from window */
+                        zmemcpy(out + OFF, from + OFF, len);
+                        out += len;
+                    }
+                    else {                      /* rest from output */
+                        zmemcpy(out + OFF, from + OFF, op);
+                        out += op;
+                        out = chunk_copy(out + OFF, dist, len - op) - OFF;
+                    }
+                }
+                else {                          /* copy direct from output */
+                    out = chunk_copy(out + OFF, dist, len) - OFF;
+                }
+#else
                     if (write == 0) {           /* very common case */
                         from += wsize - op;
                         if (op < len) {         /* some from window */
@@ -257,6 +304,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                             PUP(out) = PUP(from);
                     }
                 }
+#endif /* INFLATE_WIDE */
             }
             else if ((op & 64) == 0) {          /* 2nd level distance code */
                 this = dcode[this.val + (hold & ((1U << op) - 1))];
@@ -293,14 +341,64 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* update state and return */
     strm->next_in = in + OFF;
     strm->next_out = out + OFF;
-    strm->avail_in = (unsigned)(in < last ? 5 + (last - in) : 5 - (in - last));
+    strm->avail_in = (unsigned)(in < last ?
+                                (INFLATE_FAST_MIN_HAVE - 1) + (last - in) :
+                                (INFLATE_FAST_MIN_HAVE - 1) - (in - last));
     strm->avail_out = (unsigned)(out < end ?
-                                 257 + (end - out) : 257 - (out - end));
-    state->hold = hold;
+                                 (INFLATE_FAST_MIN_LEFT - 1) + (end - out) :
+                                 (INFLATE_FAST_MIN_LEFT - 1) - (out - end));
+    state->hold = (unsigned long)hold;
     state->bits = bits;
     return;
 }
 
+#ifdef INFLATE_WIDE
+/*
+   Copy len bytes from dist bytes back in the output to out and return out +
+   len.  The copy goes sixteen or eight bytes at a time, from at least that
+   far back so each chunk only reads bytes already written, and may write up
+   to fifteen bytes past the end.  A shorter distance is repeated over sixteen
+   bytes first, stored as many times as needed moving on by a multiple of it.
+ */
+local unsigned char FAR *chunk_copy(out, dist, len)
+unsigned char FAR *out;
+unsigned dist;
+unsigned len;
+{
+    unsigned char FAR *from = out - dist;
+    unsigned char FAR *stop = out + len;
+    unsigned char pattern[16];
+    unsigned n;
+
+    if (dist >= 16) {
+        do {
+            zmemcpy(out, from, 16);
+            out += 16;
+            from += 16;
+        } while (out < stop);
+    }
+    else if (dist >= 8) {
+        do {
+            zmemcpy(out, from, 8);
+            out += 8;
+            from += 8;
+        } while (out < stop);
+    }
+    else {
+        for (n = 0; n < dist; n++)
+            pattern[n] = from[n];
+        for (; n < 16; n++)
+            pattern[n] = pattern[n - dist];
+        n = 16 - 16 % dist;
+        do {
+            zmemcpy(out, pattern, 16);
+            out += n;
+        } while (out < stop);
+    }
+    return stop;
+}
+#endif /* INFLATE_WIDE */
+
 /*
    inflate_fast() speedups that turned out slower (on a PowerPC G3 750CXe):
    - Using bit fields for code structure
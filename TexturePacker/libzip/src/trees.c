@@ -148,6 +148,7 @@ local void build_tree     OF((deflate_state *s, tree_desc *desc));
 local void scan_tree      OF((deflate_state *s, ct_data *tree, int max_code));
 local void send_tree      OF((deflate_state *s, ct_data *tree, int max_code));
 local int  build_bl_tree  OF((deflate_state *s));
+local ulg  static_bits    OF((deflate_state *s));
 local void send_all_trees OF((deflate_state *s, int lcodes, int dcodes,
                               int blcodes));
 local void compress_block OF((deflate_state *s, ct_data *ltree,
@@ -229,6 +230,23 @@ local void send_bits(s, value, length)
 }
 #endif /* DEBUG */
 
+/* ===========================================================================
+ * compress_block() gathers the codes of a whole symbol in a 64-bit bit buffer
+ * of its own rather than going through bi_buf for every code. A symbol takes
+ * at most 48 bits, which fit on top of the up to 16 bits left over from the
+ * previous one. Like send_bits(), it keeps those 16 bits back, so the output
+ * does not get any closer to the symbols in the pending_buf overlay.
+ */
+#if !defined(DEBUG) && (defined(__GNUC__) || defined(_MSC_VER))
+#  define WIDE_BITS
+#  ifdef _MSC_VER
+     typedef unsigned __int64 bit_word;
+#  else
+     typedef unsigned long long bit_word;
+#  endif
+#  define send_wide(value, length)      { buf |= (bit_word)(value) << valid; valid += (length); }
+#endif
+
 
 /* the arguments must not have side effects */
 
@@ -830,6 +848,28 @@ local int build_bl_tree(s)
     return max_blindex;
 }
 
+/* ===========================================================================
+ * Return the bit length of the current block sent with the static trees,
+ * extra bits included, without building any tree: the same sum gen_bitlen()
+ * leaves in static_len.
+ */
+local ulg static_bits(s)
+    deflate_state *s;
+{
+    ulg bits = 0;
+    int n;
+
+    for (n = 0; n < L_CODES; n++) {
+        bits += (ulg)s->dyn_ltree[n].Freq * (static_ltree[n].Len +
+                (n > LITERALS ? extra_lbits[n-LITERALS-1] : 0));
+    }
+    for (n = 0; n < D_CODES; n++) {
+        bits += (ulg)s->dyn_dtree[n].Freq * (static_dtree[n].Len +
+                extra_dbits[n]);
+    }
+    return bits;
+}
+
 /* ===========================================================================
  * Send the header for a block using dynamic Huffman trees: the counts, the
  * lengths of the bit length codes, the literal tree and the distance tree.
@@ -927,8 +967,10 @@ void _tr_flush_block(s, buf, stored_len, eof)
     ulg opt_lenb, static_lenb; /* opt_len and static_len in bytes */
     int max_blindex = 0;  /* index of last bit length code of non zero freq */
 
-    /* Build the Huffman trees unless a stored block is forced */
-    if (s->level > 0) {
+    /* Build the Huffman trees unless a stored block is forced, or the block
+     * is from deflate_quick(), which takes the static trees or a stored block.
+     */
+    if (s->level > 0 && s->strategy != Z_QUICK) {
 
         /* Check if the file is binary or text */
         if (stored_len > 0 && s->strm->data_type == Z_UNKNOWN)
@@ -961,6 +1003,12 @@ void _tr_flush_block(s, buf, stored_len, eof)
 
         if (static_lenb <= opt_lenb) opt_lenb = static_lenb;
 
+    } else if (s->level > 0) {
+        /* Z_QUICK: only the static length is needed, so that incompressible
+         * data goes in stored blocks rather than growing by an eighth.
+         */
+        s->static_len = static_bits(s);
+        opt_lenb = static_lenb = (s->static_len+3+7)>>3;
     } else {
         Assert(buf != (char*)0, "lost buf");
         opt_lenb = static_lenb = stored_len + 5; /* force a stored block */
@@ -983,7 +1031,8 @@ void _tr_flush_block(s, buf, stored_len, eof)
 #ifdef FORCE_STATIC
     } else if (static_lenb >= 0) { /* force static trees */
 #else
-    } else if (s->strategy == Z_FIXED || static_lenb == opt_lenb) {
+    } else if (s->strategy == Z_FIXED || s->strategy == Z_QUICK ||
+               static_lenb == opt_lenb) {
 #endif
         send_bits(s, (STATIC_TREES<<1)+eof, 3);
         compress_block(s, (ct_data *)static_ltree, (ct_data *)static_dtree);
@@ -1079,7 +1128,44 @@ local void compress_block(s, ltree, dtree)
     unsigned lx = 0;    /* running index in l_buf */
     unsigned code;      /* the code to send */
     int extra;          /* number of extra bits to send */
+#ifdef WIDE_BITS
+    bit_word buf = s->bi_buf;   /* bi_buf and the bits of the current symbol */
+    int valid = s->bi_valid;    /* number of valid bits in buf */
 
+    if (s->last_lit != 0) do {
+        dist = s->d_buf[lx];
+        lc = s->l_buf[lx++];
+        if (dist == 0) {
+            send_wide(ltree[lc].Code, ltree[lc].Len); /* send a literal byte */
+        } else {
+            /* Here, lc is the match length - MIN_MATCH */
+            code = _length_code[lc];
+            send_wide(ltree[code+LITERALS+1].Code, ltree[code+LITERALS+1].Len);
+            extra = extra_lbits[code];
+            if (extra != 0) {
+                lc -= base_length[code];
+                send_wide(lc, extra);
+            }
+            dist--; /* dist is now the match distance - 1 */
+            code = d_code(dist);
+
+            send_wide(dtree[code].Code, dtree[code].Len);
+            extra = extra_dbits[code];
+            if (extra != 0) {
+                dist -= base_dist[code];
+                send_wide(dist, extra);
+            }
+        }
+        while (valid > 16) {
+            put_short(s, (ush)buf);
+            buf >>= 16;
+            valid -= 16;
+        }
+    } while (lx < s->last_lit);
+
+    s->bi_buf = (ush)buf;
+    s->bi_valid = valid;
+#else
     if (s->last_lit != 0) do {
         dist = s->d_buf[lx];
         lc = s->l_buf[lx++];
@@ -1112,6 +1198,7 @@ local void compress_block(s, ltree, dtree)
                "pendingBuf overflow");
 
     } while (lx < s->last_lit);
+#endif /* WIDE_BITS */
 
     send_code(s, END_BLOCK, ltree);
     s->last_eob_len = ltree[END_BLOCK].Len;
@@ -29,6 +29,107 @@ const char * ZEXPORT zlibVersion()
     return ZLIB_VERSION;
 }
 
+#ifdef Z_X86_SIMD
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+
+local void z_cpuid OF((unsigned leaf, unsigned regs[4]));
+local int z_detect_simd OF((void));
+
+local void z_cpuid(leaf, regs)
+    unsigned leaf;
+    unsigned regs[4];
+{
+#  ifdef _MSC_VER
+    int r[4];
+
+    __cpuidex(r, (int)leaf, 0);
+    regs[0] = (unsigned)r[0]; regs[1] = (unsigned)r[1];
+    regs[2] = (unsigned)r[2]; regs[3] = (unsigned)r[3];
+#  else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    if (leaf <= __get_cpuid_max(0, 0))
+        __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#  endif
+}
+
+#  ifdef Z_X86_AVX2
+local int z_os_saves_ymm OF((void));
+
+/* whether the operating system saves the AVX registers (XCR0 bits 1 and 2) */
+local int z_os_saves_ymm()
+{
+#    ifdef _MSC_VER
+    return (_xgetbv(0) & 6) == 6;
+#    else
+    unsigned lo, hi;
+
+    /* xgetbv, spelled out for assemblers that don't know it */
+    __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0"
+                          : "=a" (lo), "=d" (hi) : "c" (0));
+    return (lo & 6) == 6;
+#    endif
+}
+#  endif
+
+local int z_detect_simd()
+{
+    unsigned regs[4];
+    int flags = 0;
+
+    z_cpuid(0, regs);
+    if (regs[0] < 1)
+        return flags;
+
+    z_cpuid(1, regs);
+    if (regs[3] & (1U << 26))
+        flags |= Z_SIMD_SSE2;
+    if ((flags & Z_SIMD_SSE2) && (regs[2] & (1U << 9)))
+        flags |= Z_SIMD_SSSE3;
+    if ((flags & Z_SIMD_SSE2) && (regs[2] & (1U << 1)))
+        flags |= Z_SIMD_PCLMUL;
+
+#  ifdef Z_X86_AVX2
+    /* AVX2 needs OSXSAVE and AVX on leaf 1 as well as leaf 7 ebx bit 5 */
+    if ((flags & Z_SIMD_SSSE3) && (regs[2] & (1U << 27)) &&
+        (regs[2] & (1U << 28)) && z_os_saves_ymm()) {
+        z_cpuid(7, regs);
+        if (regs[1] & (1U << 5))
+            flags |= Z_SIMD_AVX2;
+    }
+#  endif
+    return flags;
+}
+#endif /* Z_X86_SIMD */
+
+/* -1 until the CPU has been asked.  Every thread computes the same flags, so
+   the race is harmless. */
+local int simd_detected = -1;
+local int simd_mask = ~0;
+
+int z_simd()
+{
+    if (simd_detected < 0) {
+#ifdef Z_X86_SIMD
+        simd_detected = z_detect_simd();
+#else
+        simd_detected = 0;
+#endif
+    }
+    return simd_detected & simd_mask;
+}
+
+int ZEXPORT zlibSimdSupport(mask)
+    int mask;
+{
+    if (mask >= 0)
+        simd_mask = mask;
+    return z_simd();
+}
+
 uLong ZEXPORT zlibCompileFlags()
 {
     uLong flags;
@@ -1,145 +1,311 @@
 #include <iostream>
-#include <fstream>
-#include "TexturePacker.h"
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include <stdio.h>
+#include <signal.h>
+#include <algorithm>
+#include "AtlasBuilder.h"
+#include "BatchJobs.h"
+#include "AtlasWatcher.h"
+#include "PackCapture.h"
+#include "Profiler.h"
+#include "Progress.h"
+#include "Threading.h"
+#include "Platform.h"
 #include "MyPngWriter.h"
-#include "BoundingGenerator.h"
-#include "GeoUtil.h"
 
-bool IsPointInside(const SpriteInfo& sprite, int x, int y);
+// How long it has to be quiet after a sprite changed before --watch packs again.
+const int WATCH_DEBOUNCE_MS = 200;
+
+// Seconds between two progress lines of the same stage.
+const double PROGRESS_INTERVAL = 1.0;
+
+// Exit code of a build stopped by SIGINT or SIGTERM, as shells report a process killed by SIGINT.
+const int EXIT_CANCELLED = 130;
+
+// Prints how far the build has come, at most every PROGRESS_INTERVAL seconds, with the time the
+// current stage still needs at the pace it went so far. Stages shorter than that are not shown.
+class ConsoleProgress : public ProgressListener
+{
+public:
+
+	ConsoleProgress()
+	:mStage(STAGE_COUNT)
+	,mStageStart(0)
+	,mLastPrint(0)
+	,mPrinted(false)
+	{
+	}
+
+	virtual void OnProgress(BuildStage stage, int done, int total)
+	{
+		ScopedLock lock(mMutex);
+
+		double now = GetTimeInSeconds();
+		if (stage != mStage)
+		{
+			mStage = stage;
+			mStageStart = mLastPrint = now;
+			mPrinted = false;
+		}
+
+		bool finished = done >= total;
+		if (now - mLastPrint < PROGRESS_INTERVAL && !(finished && mPrinted))
+		{
+			return;
+		}
+
+		double elapsed = now - mStageStart;
+		int percent = total > 0 ? (int)(100.0 * done / total) : 100;
+		char count[32];
+		sprintf(count, "%d/%d", done, total);
+		if (finished)
+		{
+			printf("  %-8s %15s %4d%%  done in %.1f s\n", GetStageName(stage), count, percent, elapsed);
+			mPrinted = false;
+		}
+		else if (done > 0)
+		{
+			printf("  %-8s %15s %4d%%  ETA %.1f s\n", GetStageName(stage), count, percent,
+				elapsed * (total - done) / done);
+			mPrinted = true;
+		}
+		fflush(stdout);
+		mLastPrint = now;
+	}
+
+private:
+
+	Mutex mMutex;
+	BuildStage mStage;
+	double mStageStart;
+	double mLastPrint;
+	bool mPrinted;                      // Something was printed for the current stage, its end will be too.
+};
+
+CancellationToken gCancellation;
+
+void OnTerminationSignal(int signalNumber)
+{
+	gCancellation.Cancel();
+
+	// A second one kills the process the usual way.
+	signal(signalNumber, SIG_DFL);
+}
+
+void CatchTerminationSignals()
+{
+	signal(SIGINT, OnTerminationSignal);
+	signal(SIGTERM, OnTerminationSignal);
+}
 
 void PrintUsage()
 {
 	std::cout << "Usage:\n"
-			  << "    WeTexturePacker ListFile OutFileWidth OutFileHeight {DrawDebugLines}\n"
-			  << "    List file should contain lines of paths to PNG files.\n";
+			  << "    WeTexturePacker ListFile OutFileWidth OutFileHeight {DrawDebugLines} {Options}\n"
+			  << "    List file should contain lines of paths to PNG files.\n"
+			  << "Options:\n";
+	PrintPackJobOptions();
+	std::cout << "    --watch            Keep running and update the packed texture whenever its list\n"
+			  << "                       file or sprites change, redrawing only the changed sprites.\n"
+			  << "    --trace File       Time the stages and count the work done, print a summary and\n"
+			  << "                       write a Chrome trace (chrome://tracing) to File.\n"
+			  << "    --no-crc           Do not check the CRCs of the sprites' chunks, for sprites that\n"
+			  << "                       are known to be intact. Decoding them is a little faster.\n"
+			  << "    Progress is printed as the build goes. SIGINT or SIGTERM stops it, removes the\n"
+			  << "    partly written outputs and exits with code " << EXIT_CANCELLED << ".\n";
+	std::cout << "\n"
+			  << "    WeTexturePacker --jobs JobFile {--threads N} {--memory-cap MB} {--watch} {--trace File}\n"
+			  << "                    {--no-crc}\n"
+			  << "    Builds every packed texture listed in the job file in one process, one job per line\n"
+			  << "    with the arguments above. The jobs run on N threads (one per core by default), and\n"
+			  << "    only as many at once as the memory cap allows. With more than one thread, each job\n"
+			  << "    encodes its output on one thread unless it gives --encode-threads N above 0.\n"
+			  << "    With --watch, all of them are kept up to date afterwards.\n";
+	std::cout << "\n"
+			  << "    WeTexturePacker --replay CaptureFile {--repeat N} {--trace File}\n"
+			  << "    Packs again, N times, the sprites recorded with --capture, without any image,\n"
+			  << "    and prints the time it took and a digest of where the sprites went.\n";
 }
 
-void WriteOutPackedPng(int width, int height, const std::vector<SpriteInfo>& spriteInfos, bool drawDebugLines)
+void StartTrace(const std::string& tracePath)
 {
-	std::ofstream logFile("log.txt");
-	MyPngWriter outputFile(width, height, 0, "output.png");
-
-	for (int i = 0; i < spriteInfos.size(); ++i)
+	if (!tracePath.empty())
 	{
-		const SpriteInfo& info = spriteInfos[i];
+		Profiler::Enable();
+	}
+}
 
-		std::string filename = *(std::string*)(info.userData);
+void FinishTrace(const std::string& tracePath)
+{
+	if (!tracePath.empty())
+	{
+		Profiler::PrintSummary();
+		Profiler::WriteTrace(tracePath);
+	}
+}
 
-		MyPngWriter inPngFile(1, 1, 0, "");
-		inPngFile.readfromfile(filename.c_str());
-		int w = inPngFile.getwidth();
-		int h = inPngFile.getheight();
+int RunJobFile(int argc, char** argv)
+{
+	std::string jobFile;
+	int threadCount = 0;
+	double memoryCap = 0;
+	bool watch = false;
+	std::string tracePath;
 
-		if (info.fitted)
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--jobs" && i + 1 < argc)
+		{
+			jobFile = argv[++i];
+		}
+		else if (arg == "--threads" && i + 1 < argc)
+		{
+			threadCount = atoi(argv[++i]);
+		}
+		else if (arg == "--memory-cap" && i + 1 < argc)
+		{
+			memoryCap = atof(argv[++i]) * 1024 * 1024;
+		}
+		else if (arg == "--watch")
+		{
+			watch = true;
+		}
+		else if (arg == "--trace" && i + 1 < argc)
 		{
-			for (int y = 0; y < h; ++y)
-			{
-				for (int x = 0; x < w; x++)
-				{
-					if (IsPointInside(info, x + info.x, info.y + y))
-					{
-						int r = inPngFile.getRed(x, y);
-						int g = inPngFile.getGreen(x, y);
-						int b = inPngFile.getBlue(x, y);
-						int a = inPngFile.getAlpha(x, y);
-
-						outputFile.plot(info.x + x, info.y + y, r, g, b, a);
-					}
-				}
-			}
-
-			if (drawDebugLines)
-			{
-				// Draw the debugging lines.
-				if (info.vertex.size() > 4)
-				{
-					int n = info.vertex.size();
-					for (int j = 0; j < n; ++j)
-					{
-						CPoint pt0 = info.vertex[j];
-						CPoint pt1 = info.vertex[(j+1)%n];
-						outputFile.line(info.x + pt0.x, info.y + pt0.y, info.x + pt1.x, info.y + pt1.y, 255, 0, 0, 255);
-					}
-				}
-			}
+			tracePath = argv[++i];
+		}
+		else if (arg == "--no-crc")
+		{
+			MyPngWriter::setcrccheck(false);
 		}
 		else
 		{
-			logFile << "File " << filename << "with size(" << w << ", " << h << ") not packed!\n";
+			PrintUsage();
+			return -1;
 		}
 	}
 
-	outputFile.close();
-}
-
-int main(int argc, char** argv)
-{
-	if (argc != 4 && argc != 5)
+	if (watch)
 	{
-		PrintUsage();
-		return -1;
+		std::vector<PackJob> jobs;
+		if (!ReadJobFile(jobFile, jobs))
+			return -1;
+		return WatchAtlases(jobs, WATCH_DEBOUNCE_MS);
 	}
 
-	int width = atoi(argv[2]),
-		height = atoi(argv[3]);
+	ConsoleProgress progress;
+	CatchTerminationSignals();
 
-	bool drawDebugLines = argc == 5;
+	StartTrace(tracePath);
+	int failed = RunBatch(jobFile, threadCount, memoryCap, BuildControl(&progress, &gCancellation));
+	FinishTrace(tracePath);
 
-	if (width < 128) width = 128;
-	if (width > 4096) width = 4096;
-	if (height < 128) height = 128;
-	if (height > 4096) height = 4096;
-	
-	TexturePacker packer(width, height);
-    std::vector<SpriteInfo> spriteInfos;
-	std::string listFilePath = argv[1];
-    std::vector<std::string> fileList;
-    std::ifstream inFile(listFilePath.c_str());
+	if (gCancellation.IsCancelled())
+	{
+		printf("Cancelled.\n");
+		return EXIT_CANCELLED;
+	}
 
-    while (!inFile.eof())
-    {
-        std::string line;
-        inFile >> line;
+	return failed == 0 ? 0 : -1;
+}
 
-        if (line.length() == 0) continue;
-        if (inFile.eof()) break;
+int RunReplay(int argc, char** argv)
+{
+	std::string capturePath;
+	int repeatCount = 1;
+	std::string tracePath;
 
-		if (line.length() > 4)
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--replay" && i + 1 < argc)
+		{
+			capturePath = argv[++i];
+		}
+		else if (arg == "--repeat" && i + 1 < argc)
+		{
+			repeatCount = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--trace" && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else
 		{
-			std::string suffix = line.substr(line.length() - 4);
-			if (suffix[0] == '.'
-				&& tolower(suffix[1]) == 'p'
-				&& tolower(suffix[2]) == 'n' 
-				&& tolower(suffix[3]) == 'g')
-			{
-				fileList.push_back(line);
-			}
+			PrintUsage();
+			return -1;
 		}
-    }
+	}
 
-    for (int i = 0; i < fileList.size(); ++i)
-    {
-        std::string fileName = fileList[i];
-        MyPngWriter inPngFile(1, 1, 0, fileName.c_str());
-        inPngFile.readfromfile(fileName.c_str());
+	StartTrace(tracePath);
+	bool replayed = ReplayPackCapture(capturePath, repeatCount);
+	FinishTrace(tracePath);
 
-        SpriteInfo info;
-        BoundingGenerator boundGen;
-        info = boundGen.GenerateMoreCompactBounding(fileName);
+	return replayed ? 0 : -1;
+}
 
-        info.fitted = false;
-        info.userData = &fileList[i];
+int main(int argc, char** argv)
+{
+	if (argc > 1 && std::string(argv[1]) == "--jobs")
+	{
+		return RunJobFile(argc, argv);
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--replay")
+	{
+		return RunReplay(argc, argv);
+	}
 
-        info.x = info.y = -1;
+	std::vector<std::string> args;
+	bool watch = false;
+	std::string tracePath;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string(argv[i]) == "--watch")
+			watch = true;
+		else if (std::string(argv[i]) == "--trace" && i + 1 < argc)
+			tracePath = argv[++i];
+		else if (std::string(argv[i]) == "--no-crc")
+			MyPngWriter::setcrccheck(false);
+		else
+			args.push_back(argv[i]);
+	}
 
-        spriteInfos.push_back(info);
-    }
-	
-	printf("Generate compact bounding done, start packing...\n");
-    packer.Pack(spriteInfos);
-	printf("Pack done, writing out the packed file, it could take a while ...\n");
+	PackJob job;
+	std::string error;
+	if (!ParsePackJob(args, job, error))
+	{
+		PrintUsage();
+		return -1;
+	}
+	job.verbose = true;
 
-	WriteOutPackedPng(width, height, spriteInfos, drawDebugLines);
+	if (watch)
+	{
+		return WatchAtlases(std::vector<PackJob>(1, job), WATCH_DEBOUNCE_MS);
+	}
+
+	ConsoleProgress progress;
+	CatchTerminationSignals();
+
+	StartTrace(tracePath);
+	PackStats stats;
+	bool built = BuildAtlas(job, NULL, &stats, BuildControl(&progress, &gCancellation));
+	FinishTrace(tracePath);
+
+	if (stats.cancelled)
+	{
+		printf("Cancelled, %s was not written.\n", job.outputPath.c_str());
+		return EXIT_CANCELLED;
+	}
+
+	if (!built)
+	{
+		return -1;
+	}
 
     return 0;
 }
\ No newline at end of file
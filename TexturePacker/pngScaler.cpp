@@ -3,15 +3,11 @@
 #include "TexturePacker.h"
 #include "MyPngWriter.h"
 
-struct MyColor {
-	unsigned char r, g, b, a;
-};
-
 //   0.05 0.1 0.05
 //   0.1  0.6 0.1
 //   0.05 0.1 0.05
 //
-inline MyColor Filter(MyPngWriter* writer, float u, float v)
+inline rgba8 Filter(MyPngWriter* writer, float u, float v)
 {
 	int w = writer->getwidth(), h = writer->getheight();
 	int x = (int)(w * u), y = (int) (h * v);
@@ -24,24 +20,28 @@ inline MyColor Filter(MyPngWriter* writer, float u, float v)
 
 	float a = 0, r = 0, g = 0, b = 0;
 
-	for (int i = 0; i < 3; ++i)
+	for (int j = 0; j < 3; ++j)
 	{
-		for (int j = 0; j < 3; ++j)
+		int y1 = y + (j-1);
+		const rgba8* row = (const rgba8*)writer->row(y1);
+		if (row == NULL)
+			continue;
+
+		for (int i = 0; i < 3; ++i)
 		{
-			unsigned char alpha = 0;
-			int x1 = x + (i-1), y1 = y + (j-1);
-			if (x1 >= 0 && x1 < w && y1 >= 0 && y1 < h)
+			int x1 = x + (i-1);
+			if (x1 >= 0 && x1 < w)
 			{
-				a += c[i][j] * writer->getAlpha(x1, y1);
-				r += c[i][j] * writer->getRed(x1, y1);
-				g += c[i][j] * writer->getGreen(x1, y1);
-				b += c[i][j] * writer->getBlue(x1, y1);
+				a += c[i][j] * row[x1].a;
+				r += c[i][j] * row[x1].r;
+				g += c[i][j] * row[x1].g;
+				b += c[i][j] * row[x1].b;
 			}
 		}
 	}
 
 	if (r + g + b < 10.0f) a = r = g = b = 0.0f;
-	MyColor color = {(unsigned char)r, (unsigned char)g,(unsigned char)b,(unsigned char)a  };
+	rgba8 color = {(unsigned char)r, (unsigned char)g,(unsigned char)b,(unsigned char)a  };
 	return color;
 }
 
@@ -56,17 +56,19 @@ void ClearAlpha(const char* inFile, const char* outFile)
 
 	for (int j = 0; j < h; ++j)
 	{
+		const rgba8* in = (const rgba8*)inPngFile->row(j);
+		rgba8* out = outPngFile.span(0, j, w);
+		if (in == NULL || out == NULL)
+			continue;
+
 		for (int i = 0; i < w; ++i)
 		{
-			int a = inPngFile->getAlpha(i, j);
-			int r = inPngFile->getRed(i, j);
-			int g = inPngFile->getGreen(i, j);
-			int b = inPngFile->getBlue(i, j);
-
-			//if (r + g + b < 5) a = r = g = b = 0;
-			if (r + g + b >= 254 * 3) a = r = g = b = 0;
-			
-			outPngFile.plot(i, j, r, g, b, a);
+			rgba8 c = in[i];
+
+			//if (c.r + c.g + c.b < 5) c.a = c.r = c.g = c.b = 0;
+			if (c.r + c.g + c.b >= 254 * 3) c.a = c.r = c.g = c.b = 0;
+
+			out[i] = c;
 		}
 	}
 	outPngFile.close();
@@ -110,11 +112,14 @@ int main1(int argc, char** argv)
 	for (int j = 0; j < outHeight; ++j)
 	{
 		float v = j / (float) outHeight;
+		rgba8* out = outPngFile.span(0, j, outWidth);
+		if (out == NULL)
+			continue;
+
 		for (int i = 0; i < outWidth; ++i)
 		{
 			float u = i / (float)outWidth;
-			MyColor c = Filter(inPngFile,u,v);
-			outPngFile.plot(i, j, c.r, c.g, c.b, c.a);
+			out[i] = Filter(inPngFile,u,v);
 		}
 	}
 	outPngFile.close();